@@ -0,0 +1,725 @@
+// ====== Batched headless worlds ======
+// Many copies of one level, stepped and observed without GL or GLUT. The
+// level (walls, shapes, item spawns, target path) is shared read-only; each
+// world only keeps what changes: the ship, the target's place on its path,
+// lives, score, timers and which items are still there. World state is SoA,
+// indexed by world, so batches are handed out to the worker pool in chunks
+// and any 8 neighbouring worlds load straight into one float8: stepLanes()
+// advances them in lockstep, one world per SIMD lane.
+//
+// step() follows the windowed game's updateGame/updateTarget: 9 discrete
+// actions (stay or one of 8 directions), blocked moves cost a life, items and
+// the target are picked up by circle overlap. A finished world starts over in
+// the same call, so the caller always sees live worlds.
+//
+// Observations are tiny gray images (ObsRenderer): the static layer is drawn
+// once per level with the soft rasterizer at 4x and max-reduced, so walls
+// thinner than a pixel never vanish; per world only the item, target and ship
+// boxes are stamped over a copy of it.
+
+#pragma once
+#include "Math2D.h"
+#include "TileMap.h"
+#include "Convex2D.h"
+#include "SoftRaster.h"
+#include "Parallel.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+
+enum EnvItemKind { ENV_COLLECT = 0, ENV_PU_SPEED = 1, ENV_PU_SHIELD = 2 };
+
+// Game balance and reward shaping; the windowed game plays by one of these
+// too, so the defaults are its config
+struct EnvRules {
+    float speed = 240, boost = 420;                // px/sec
+    float boostTime = 4, shieldTime = 4;           // seconds
+    float roundTime = 60;                          // seconds
+    int   maxLives = 5;
+    float targetSpeed = 0.35f;                     // path t per second
+    float dt = 1.0f / 60;                          // one tick
+    int   repeat = 1;                              // ticks per step (frame skip)
+    float rewardCollect = 5, rewardWin = 50, rewardHit = -10, rewardLose = -50;
+};
+
+// Balance fields by name (as in --rule speed=300); false for an unknown name
+inline bool setRule(EnvRules& R, const char* name, float v) {
+    if (!strcmp(name, "speed")) R.speed = v;
+    else if (!strcmp(name, "boost")) R.boost = v;
+    else if (!strcmp(name, "boostTime")) R.boostTime = v;
+    else if (!strcmp(name, "shieldTime")) R.shieldTime = v;
+    else if (!strcmp(name, "roundTime")) R.roundTime = v;
+    else if (!strcmp(name, "maxLives")) R.maxLives = (int)v;
+    else if (!strcmp(name, "targetSpeed")) R.targetSpeed = v;
+    else return false;
+    return true;
+}
+
+// "name=value"
+inline bool setRule(EnvRules& R, const char* assign) {
+    const char* eq = strchr(assign, '=');
+    if (!eq || eq - assign >= 32) return false;
+    char name[32];
+    memcpy(name, assign, eq - assign);
+    name[eq - assign] = 0;
+    return setRule(R, name, (float)atof(eq + 1));
+}
+
+// Action a: 0 stays, 1..8 go E, NE, N, NW, W, SW, S, SE
+const float ENV_ACTION_DX[9] = { 0, 1, 1, 0, -1, -1, -1, 0, 1 };
+const float ENV_ACTION_DY[9] = { 0, 0, 1, 1, 1, 0, -1, -1, -1 };
+
+struct EnvLevel {
+    float x0 = 0, y0 = 0, x1 = 1, y1 = 1;         // play area
+    TileMap walls;
+    std::vector<float> sqx, sqy, sqh;              // axis-aligned squares (half size)
+    std::vector<OBox> boxes;
+    std::vector<ConvexPoly> polys;
+    std::vector<float> ix, iy, ir;                 // items at round start
+    std::vector<uint8_t> ikind;                    // EnvItemKind
+    float path[4][2] = { { 0 } };                  // target Bezier control points
+    float targetR = 16, startX = 0, startY = 0, playerR = 14;
+    std::vector<BoxBlock> boxBlocks;               // SoA copies for blocked(); finish() builds them
+    std::vector<PolyBlock> polyBlocks;
+
+    int items() const { return (int)ix.size(); }
+    void finish() {
+        buildBoxBlocks(boxes, boxBlocks);
+        buildPolyBlocks(polys, polyBlocks);
+    }
+
+    // Circle against walls, squares, boxes and polygons
+    bool blocked(float x, float y, float r) const {
+        for (size_t i = 0; i < sqx.size(); i++) {
+            float cx = clampf(x, sqx[i] - sqh[i], sqx[i] + sqh[i]), cy = clampf(y, sqy[i] - sqh[i], sqy[i] + sqh[i]);
+            if (dist2(x, y, cx, cy) < r * r) return true;
+        }
+        return tileCircleHits(walls, x, y, r) || circleHitsBoxes(boxBlocks, x, y, r) || circleHitsPolys(polyBlocks, x, y, r);
+    }
+#ifdef MATH2D_SSE
+    // blocked() for the lanes set in `lanes`, returned as a lane mask: the
+    // squares 8 lanes at a time, then the remaining lanes one by one against
+    // tiles, boxes and polygons (those tests are already SIMD over shapes)
+    int blocked8(const float8& x, const float8& y, float r, int lanes) const {
+        int hit = 0;
+        float8 rr = f8(r * r);
+        for (size_t i = 0; i < sqx.size() && (lanes & ~hit); i++) {
+            float8 cx = clamp8(x, f8(sqx[i] - sqh[i]), f8(sqx[i] + sqh[i])), cy = clamp8(y, f8(sqy[i] - sqh[i]), f8(sqy[i] + sqh[i]));
+            hit |= mask8(lt8(dist2_8(x, y, cx, cy), rr));
+        }
+        hit &= lanes;
+        float xs[8], ys[8];
+        store8(xs, x); store8(ys, y);
+        for (int m = lanes & ~hit; m; m &= m - 1) {
+            int l = ctz64(m);
+            if (tileCircleHits(walls, xs[l], ys[l], r) || circleHitsBoxes(boxBlocks, xs[l], ys[l], r) || circleHitsPolys(polyBlocks, xs[l], ys[l], r))
+                hit |= 1 << l;
+        }
+        return hit;
+    }
+#endif
+    void targetAt(float t, float& x, float& y) const {
+        x = bezier1(t, path[0][0], path[1][0], path[2][0], path[3][0]);
+        y = bezier1(t, path[0][1], path[1][1], path[2][1], path[3][1]);
+    }
+};
+
+struct EnvBatch {
+    int n = 0, itemWords = 0;
+    std::vector<float> px, py, angle;              // ship (angle in degrees)
+    std::vector<float> targetT, targetDir;         // on the level's path, ping-pong
+    std::vector<float> time;                       // seconds into the round
+    std::vector<float> shieldUntil, speedUntil, nextHit;
+    std::vector<int> lives, score;
+    std::vector<uint8_t> done;
+    std::vector<uint64_t> itemsLeft;               // itemWords bits per world
+
+    void resize(const EnvLevel& L, int count) {
+        n = count;
+        itemWords = (L.items() + 63) >> 6;
+        for (auto* v : { &px, &py, &angle, &targetT, &targetDir, &time, &shieldUntil, &speedUntil, &nextHit }) v->assign(n, 0.0f);
+        lives.assign(n, 0); score.assign(n, 0);
+        done.assign(n, 0);
+        itemsLeft.assign((size_t)n * itemWords, 0);
+    }
+
+    bool itemLeft(int w, int k) const { return (itemsLeft[(size_t)w * itemWords + (k >> 6)] >> (k & 63)) & 1; }
+    void takeItem(int w, int k) { itemsLeft[(size_t)w * itemWords + (k >> 6)] &= ~(1ull << (k & 63)); }
+
+    // World w back to the level's start
+    void reset(const EnvLevel& L, int w, int maxLives) {
+        px[w] = L.startX; py[w] = L.startY; angle[w] = 90;
+        targetT[w] = 0; targetDir[w] = 1;
+        time[w] = shieldUntil[w] = speedUntil[w] = nextHit[w] = 0;
+        lives[w] = maxLives; score[w] = 0; done[w] = 0;
+        uint64_t* bits = &itemsLeft[(size_t)w * itemWords];
+        int m = L.items();
+        for (int i = 0; i < itemWords; i++) bits[i] = (m - i * 64 >= 64) ? ~0ull : bitRange(0, m - i * 64 - 1);
+    }
+
+    // One tick of world w; returns its reward and sets done[w] on a win or loss
+    float tick(const EnvLevel& L, const EnvRules& R, int w, int action) {
+        float dt = R.dt, now = time[w] += dt, reward = 0;
+        if (now >= R.roundTime) { done[w] = 1; return R.rewardLose; }
+
+        float spd = now < speedUntil[w] ? R.boost : R.speed;
+        float vx = ENV_ACTION_DX[action] * spd, vy = ENV_ACTION_DY[action] * spd;
+        if (vx != 0 || vy != 0) angle[w] = fastAtan2(vy, vx) * RAD2DEG;
+        float r = L.playerR;
+        float nx = clampf(px[w] + vx * dt, L.x0 + r, L.x1 - r), ny = clampf(py[w] + vy * dt, L.y0 + r, L.y1 - r);
+        if (L.blocked(nx, ny, r)) {
+            if (now >= shieldUntil[w] && now >= nextHit[w]) {
+                lives[w]--; nextHit[w] = now + 0.5f; reward += R.rewardHit;
+                if (lives[w] <= 0) { done[w] = 1; return reward + R.rewardLose; }
+            }
+        }
+        else { px[w] = nx; py[w] = ny; }
+
+        uint64_t* bits = &itemsLeft[(size_t)w * itemWords];
+        for (int i = 0; i < itemWords; i++)
+            for (uint64_t m = bits[i]; m; m &= m - 1) {
+                int k = i * 64 + ctz64(m);
+                float rr = r + L.ir[k];
+                if (dist2(px[w], py[w], L.ix[k], L.iy[k]) >= rr * rr) continue;
+                bits[i] &= ~(1ull << (k & 63));
+                if (L.ikind[k] == ENV_COLLECT) { score[w] += 5; reward += R.rewardCollect; }
+                else if (L.ikind[k] == ENV_PU_SPEED) speedUntil[w] = now + R.boostTime;
+                else shieldUntil[w] = now + R.shieldTime;
+            }
+
+        float tx, ty; L.targetAt(targetT[w], tx, ty);
+        if (dist2(px[w], py[w], tx, ty) < (r + L.targetR) * (r + L.targetR)) { done[w] = 1; return reward + R.rewardWin; }
+
+        float t = targetT[w] + targetDir[w] * R.targetSpeed * dt;
+        if (t > 1) { t = 1; targetDir[w] = -1; }
+        if (t < 0) { t = 0; targetDir[w] = 1; }
+        targetT[w] = t;
+        return reward;
+    }
+
+    // R.repeat ticks of world w with one action; a finished world is reset
+    // (done[w] stays set for this step, its state is already the new round's)
+    float step(const EnvLevel& L, const EnvRules& R, int w, int action) {
+        if (action < 0 || action > 8) action = 0;
+        done[w] = 0;
+        float reward = 0;
+        for (int k = 0; k < R.repeat && !done[w]; k++) reward += tick(L, R, w, action);
+        if (done[w]) { reset(L, w, R.maxLives); done[w] = 1; }
+        return reward;
+    }
+
+#ifdef MATH2D_SSE
+    // step() for worlds w0..w0+7 in lockstep, one world per float8 lane, with
+    // the same results. Timers, movement, clamping, pickups and the target
+    // run lane-parallel; `live` masks off lanes whose round ended so the rest
+    // finish their ticks. Only part of the collision query (blocked8) and the
+    // rare events (hits, pickups, round ends) drop to per-lane code.
+    void stepLanes(const EnvLevel& L, const EnvRules& R, int w0, const uint8_t* act, float* rew) {
+        float adx[8], ady[8], rw[8], now[8];
+        int moving = 0;
+        for (int l = 0; l < 8; l++) {
+            int a = act[l] <= 8 ? act[l] : 0;
+            adx[l] = ENV_ACTION_DX[a]; ady[l] = ENV_ACTION_DY[a];
+            if (a) moving |= 1 << l;
+            rw[l] = 0;
+            done[w0 + l] = 0;
+        }
+        float r = L.playerR, rt = r + L.targetR;
+        float8 dt = f8(R.dt), vdx = load8(adx), vdy = load8(ady);
+        int active = 0xff;
+        float8 live = laneMask8(active), turn = laneMask8(moving);
+        auto finish = [&](int l, float reward) { done[w0 + l] = 1; rw[l] += reward; active &= ~(1 << l); };
+
+        for (int k = 0; k < R.repeat && active; k++) {
+            float8 t0 = load8(&time[w0]), t1 = t0 + dt;
+            store8(&time[w0], select8(live, t1, t0));
+            store8(now, t1);
+            if (int m = active & ~mask8(lt8(t1, f8(R.roundTime)))) {
+                for (; m; m &= m - 1) finish(ctz64(m), R.rewardLose);
+                turn = laneMask8(active & moving);
+            }
+
+            float8 spd = select8(lt8(t1, load8(&speedUntil[w0])), f8(R.boost), f8(R.speed));
+            float8 vx = vdx * spd, vy = vdy * spd;
+            store8(&angle[w0], select8(turn, fastAtan2_8(vy, vx) * f8(RAD2DEG), load8(&angle[w0])));
+            float8 x = load8(&px[w0]), y = load8(&py[w0]);
+            float8 cx = clamp8(x + vx * dt, f8(L.x0 + r), f8(L.x1 - r)), cy = clamp8(y + vy * dt, f8(L.y0 + r), f8(L.y1 - r));
+            int hit = L.blocked8(cx, cy, r, active);
+            float8 moved = laneMask8(active & ~hit);
+            x = select8(moved, cx, x); y = select8(moved, cy, y);
+            store8(&px[w0], x); store8(&py[w0], y);
+            for (int m = hit; m; m &= m - 1) {
+                int l = ctz64(m), w = w0 + l;
+                if (now[l] < shieldUntil[w] || now[l] < nextHit[w]) continue;
+                lives[w]--; nextHit[w] = now[l] + 0.5f; rw[l] += R.rewardHit;
+                if (lives[w] <= 0) finish(l, R.rewardLose);
+            }
+
+            uint64_t* bits = &itemsLeft[(size_t)w0 * itemWords];
+            for (int i = 0; i < itemWords; i++) {
+                uint64_t any = 0;
+                for (int m = active; m; m &= m - 1) any |= bits[ctz64(m) * itemWords + i];
+                for (; any; any &= any - 1) {
+                    int k = i * 64 + ctz64(any);
+                    float rr = r + L.ir[k];
+                    int near = active & mask8(lt8(dist2_8(x, y, f8(L.ix[k]), f8(L.iy[k])), f8(rr * rr)));
+                    for (; near; near &= near - 1) {
+                        int l = ctz64(near), w = w0 + l;
+                        if (!itemLeft(w, k)) continue;
+                        takeItem(w, k);
+                        if (L.ikind[k] == ENV_COLLECT) { score[w] += 5; rw[l] += R.rewardCollect; }
+                        else if (L.ikind[k] == ENV_PU_SPEED) speedUntil[w] = now[l] + R.boostTime;
+                        else shieldUntil[w] = now[l] + R.shieldTime;
+                    }
+                }
+            }
+
+            float8 T = load8(&targetT[w0]), dir = load8(&targetDir[w0]);
+            float8 tx = bezier8(T, f8(L.path[0][0]), f8(L.path[1][0]), f8(L.path[2][0]), f8(L.path[3][0]));
+            float8 ty = bezier8(T, f8(L.path[0][1]), f8(L.path[1][1]), f8(L.path[2][1]), f8(L.path[3][1]));
+            for (int m = active & mask8(lt8(dist2_8(x, y, tx, ty), f8(rt * rt))); m; m &= m - 1) finish(ctz64(m), R.rewardWin);
+
+            float8 t = T + dir * f8(R.targetSpeed) * dt;
+            float8 over = gt8(t, f8(1)), under = lt8(t, f8(0));
+            t = select8(over, f8(1), select8(under, f8(0), t));
+            float8 d = select8(over, f8(-1), select8(under, f8(1), dir));
+            live = laneMask8(active);
+            turn = laneMask8(active & moving);
+            store8(&targetT[w0], select8(live, t, T));
+            store8(&targetDir[w0], select8(live, d, dir));
+        }
+        for (int l = 0; l < 8; l++) {
+            int w = w0 + l;
+            if (done[w]) { reset(L, w, R.maxLives); done[w] = 1; }
+            rew[l] = rw[l];
+        }
+    }
+
+    // All-ones lanes for the set bits of m
+    static float8 laneMask8(int m) {
+        float b[8];
+        for (int l = 0; l < 8; l++) b[l] = (float)(m >> l & 1);
+        return lt8(f8(0), load8(b));
+    }
+#endif
+};
+
+// ---------------- bot ----------------
+// Player for headless rounds (sweeps, baselines). It steers by BFS distance
+// fields over a grid of cells where the ship's centre fits, one field per
+// item and one per sample along the target's path, built once per level and
+// shared read-only by every world. It collects the nearest reachable item
+// while there is time to spare, then chases the target.
+const int BOT_PATH_SAMPLES = 16;
+const uint16_t BOT_FAR = 0xFFFF;
+
+struct EnvBotMap {
+    int cols = 0, rows = 0, items = 0;
+    float cell = 10, x0 = 0, y0 = 0;
+    std::vector<uint8_t> open;              // ship centre fits at the cell centre
+    std::vector<uint16_t> dist;             // items + BOT_PATH_SAMPLES fields, cols * rows each
+
+    int cellOf(float x, float y) const {
+        int c = std::max(0, std::min(cols - 1, (int)((x - x0) / cell)));
+        int r = std::max(0, std::min(rows - 1, (int)((y - y0) / cell)));
+        return r * cols + c;
+    }
+    const uint16_t* field(int f) const { return &dist[(size_t)f * cols * rows]; }
+    const uint16_t* targetField(float t) const { return field(items + (int)(t * (BOT_PATH_SAMPLES - 1) + 0.5f)); }
+
+    void build(const EnvLevel& L, float cellSize) {
+        cell = cellSize; x0 = L.x0; y0 = L.y0;
+        cols = std::max(1, (int)ceilf((L.x1 - L.x0) / cell));
+        rows = std::max(1, (int)ceilf((L.y1 - L.y0) / cell));
+        items = L.items();
+        open.assign((size_t)cols * rows, 0);
+        reopen(L, L.x0, L.y0, L.x1, L.y1);
+        dist.assign((size_t)(items + BOT_PATH_SAMPLES) * cols * rows, BOT_FAR);
+        for (int f = 0; f < items + BOT_PATH_SAMPLES; f++) refill(L, f);
+    }
+
+    // Re-tests the cells whose centres lie in the box, after shapes in it
+    // moved; returns how many changed and appends them to `changed`
+    int reopen(const EnvLevel& L, float bx0, float by0, float bx1, float by1, std::vector<int>* changed = nullptr) {
+        int c0 = std::max(0, (int)floorf((bx0 - x0) / cell - 0.5f)), c1 = std::min(cols - 1, (int)ceilf((bx1 - x0) / cell - 0.5f));
+        int r0 = std::max(0, (int)floorf((by0 - y0) / cell - 0.5f)), r1 = std::min(rows - 1, (int)ceilf((by1 - y0) / cell - 0.5f));
+        float r = L.playerR;
+        int n = 0;
+        for (int i = r0; i <= r1; i++)
+            for (int j = c0; j <= c1; j++) {
+                float x = x0 + (j + 0.5f) * cell, y = y0 + (i + 0.5f) * cell;
+                uint8_t o = x >= L.x0 + r && x <= L.x1 - r && y >= L.y0 + r && y <= L.y1 - r && !L.blocked(x, y, r);
+                if (o == open[i * cols + j]) continue;
+                open[i * cols + j] = o;
+                n++;
+                if (changed) changed->push_back(i * cols + j);
+            }
+        return n;
+    }
+
+    // Goal of field f: item f, or path sample f - items
+    void goal(const EnvLevel& L, int f, float& gx, float& gy, float& reach) const {
+        if (f < items) { gx = L.ix[f]; gy = L.iy[f]; reach = L.playerR + L.ir[f]; return; }
+        L.targetAt((float)(f - items) / (BOT_PATH_SAMPLES - 1), gx, gy);
+        reach = L.playerR + L.targetR;
+    }
+
+    void refill(const EnvLevel& L, int f) {
+        uint16_t* d = &dist[(size_t)f * cols * rows];
+        std::fill(d, d + (size_t)cols * rows, BOT_FAR);
+        float gx, gy, reach;
+        goal(L, f, gx, gy, reach);
+        fill(d, gx, gy, reach);
+    }
+
+    // Whether flipping `cells` (already applied to open) can change field f:
+    // a cell that closed was reached, or one that opened is a goal cell or
+    // next to a reached cell. Open cells beside a reached one are reached
+    // themselves, so closing an unreached cell never breaks a diagonal.
+    bool touches(const EnvLevel& L, int f, const std::vector<int>& cells) const {
+        const uint16_t* d = field(f);
+        float gx, gy, reach;
+        goal(L, f, gx, gy, reach);
+        for (int i : cells) {
+            if (!open[i]) { if (d[i] != BOT_FAR) return true; continue; }
+            int c = i % cols, r = i / cols;
+            if (dist2(x0 + (c + 0.5f) * cell, y0 + (r + 0.5f) * cell, gx, gy) < reach * reach) return true;
+            for (int a = 1; a <= 8; a++) {
+                int nc = c + (int)ENV_ACTION_DX[a], nr = r + (int)ENV_ACTION_DY[a];
+                if (nc >= 0 && nr >= 0 && nc < cols && nr < rows && d[nr * cols + nc] != BOT_FAR) return true;
+            }
+        }
+        return false;
+    }
+
+    // BFS from every open cell whose centre is within reach of (gx, gy); 8
+    // neighbours, diagonals only past two open sides
+    void fill(uint16_t* d, float gx, float gy, float reach) {
+        std::vector<int> q;
+        for (int i = 0; i < cols * rows; i++) {
+            float x = x0 + (i % cols + 0.5f) * cell, y = y0 + (i / cols + 0.5f) * cell;
+            if (open[i] && dist2(x, y, gx, gy) < reach * reach) { d[i] = 0; q.push_back(i); }
+        }
+        for (size_t h = 0; h < q.size(); h++) {
+            int i = q[h], c = i % cols, r = i / cols;
+            for (int a = 1; a <= 8; a++) {
+                int dc = (int)ENV_ACTION_DX[a], dr = (int)ENV_ACTION_DY[a], nc = c + dc, nr = r + dr;
+                if (nc < 0 || nr < 0 || nc >= cols || nr >= rows) continue;
+                int n = nr * cols + nc;
+                if (!open[n] || d[n] != BOT_FAR) continue;
+                if (dc && dr && (!open[r * cols + nc] || !open[nr * cols + c])) continue;
+                d[n] = d[i] + 1;
+                q.push_back(n);
+            }
+        }
+    }
+};
+
+inline int envBotAction(const EnvLevel& L, const EnvBotMap& M, const EnvRules& R, const EnvBatch& B, int w) {
+    float x = B.px[w], y = B.py[w], r = L.playerR;
+    float spd = B.time[w] < B.speedUntil[w] ? R.boost : R.speed;
+    // A direction is taken only if the first tick and the last are free:
+    // walls are wider than the gap between them
+    auto free = [&](int a) {
+        float ux = ENV_ACTION_DX[a] * spd * R.dt, uy = ENV_ACTION_DY[a] * spd * R.dt;
+        float x1 = clampf(x + ux, L.x0 + r, L.x1 - r), y1 = clampf(y + uy, L.y0 + r, L.y1 - r);
+        float xn = clampf(x + ux * R.repeat, L.x0 + r, L.x1 - r), yn = clampf(y + uy * R.repeat, L.y0 + r, L.y1 - r);
+        return !L.blocked(x1, y1, r) && !L.blocked(xn, yn, r);
+    };
+    auto toward = [&](float gx, float gy) {
+        float dx = gx - x, dy = gy - y;
+        int a = (int)floorf(fastAtan2(dy, dx) * (4 / PI_F) + 0.5f);
+        return 1 + ((a % 8) + 8) % 8;
+    };
+
+    int here = M.cellOf(x, y);
+    const uint16_t* goal = M.targetField(B.targetT[w]);
+    float gx, gy;
+    L.targetAt(B.targetT[w], gx, gy);
+    float left = R.roundTime - B.time[w], cellTime = M.cell / spd;
+    uint16_t best = BOT_FAR;
+    const uint64_t* bits = &B.itemsLeft[(size_t)w * B.itemWords];
+    for (int i = 0; i < B.itemWords; i++)
+        for (uint64_t m = bits[i]; m; m &= m - 1) {
+            int k = i * 64 + ctz64(m);
+            uint16_t d = M.field(k)[here];
+            if (d < best) { best = d; goal = M.field(k); gx = L.ix[k]; gy = L.iy[k]; }
+        }
+    // Items only while the target stays comfortably reachable afterwards
+    uint16_t toTarget = M.targetField(B.targetT[w])[here];
+    if (best != BOT_FAR && toTarget != BOT_FAR && left < 2 * (best + toTarget) * cellTime + 2) {
+        goal = M.targetField(B.targetT[w]);
+        L.targetAt(B.targetT[w], gx, gy);
+    }
+
+    int c = here % M.cols, rr = here / M.cols;
+    if (goal[here] == 0) { int a = toward(gx, gy); if (free(a)) return a; }
+    if (goal[here] != BOT_FAR || !M.open[here]) {
+        // Downhill over the neighbours, nearest first; from a closed cell any open one will do
+        int order[8], n = 0;
+        for (int a = 1; a <= 8; a++) {
+            int nc = c + (int)ENV_ACTION_DX[a], nr = rr + (int)ENV_ACTION_DY[a];
+            if (nc < 0 || nr < 0 || nc >= M.cols || nr >= M.rows) continue;
+            int k = nr * M.cols + nc;
+            if (M.open[k] && goal[k] != BOT_FAR && (goal[k] < goal[here] || !M.open[here])) order[n++] = a;
+        }
+        auto at = [&](int a) { return goal[(rr + (int)ENV_ACTION_DY[a]) * M.cols + c + (int)ENV_ACTION_DX[a]]; };
+        for (int i = 1; i < n; i++)
+            for (int j = i; j > 0 && at(order[j]) < at(order[j - 1]); j--) std::swap(order[j], order[j - 1]);
+        for (int i = 0; i < n; i++) if (free(order[i])) return order[i];
+        // Off the cell centre a corner can be in the way: re-centre first
+        int a = toward(M.x0 + (c + 0.5f) * M.cell, M.y0 + (rr + 0.5f) * M.cell);
+        if (free(a)) return a;
+    }
+    int a = toward(gx, gy);
+    if (free(a)) return a;
+    int open[8], nOpen = 0;
+    for (a = 1; a <= 8; a++) if (free(a)) open[nOpen++] = a;
+    if (!nOpen) return 0;
+    uint32_t h = (uint32_t)w * 2654435761u ^ (uint32_t)(B.time[w] * 2) * 40503u;
+    return open[(h >> 16) % nOpen];
+}
+
+// Plays world w's round to its end with the bot. `noise` is the share of
+// time spent on random actions instead, in bursts of BOT_NOISE_HOLD ticks
+// (a player misjudging, not jitter); seed makes the round reproducible.
+// Returns whether the round was won (ended at the target).
+const int BOT_NOISE_HOLD = 15;
+
+inline bool playBotRound(const EnvLevel& L, const EnvBotMap& M, const EnvRules& R, EnvBatch& B, int w, float noise, uint32_t seed) {
+    uint32_t s = seed * 2654435761u + 0x9E3779B9u;
+    auto next = [&]() { s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; };
+    // A burst starts at a bot decision with chance p and takes HOLD ticks, so
+    // the random share is p*HOLD / (p*HOLD + 1 - p); solved for p at `noise`
+    noise = clampf(noise, 0.0f, 1.0f);
+    float burst = noise / (BOT_NOISE_HOLD * (1 - noise) + noise) * 16777216.0f;
+    int hold = 0, a = 0;
+    while (!B.done[w]) {
+        if (hold > 0) hold--;   // keep the burst's action
+        else if (noise > 0 && (next() >> 8) < burst) { a = 1 + next() % 8; hold = BOT_NOISE_HOLD - 1; }
+        else a = envBotAction(L, M, R, B, w);
+        for (int k = 0; k < R.repeat && !B.done[w]; k++) B.tick(L, R, w, a);
+    }
+    // Out of time or lives is a loss; any other end is the target
+    return B.lives[w] > 0 && B.time[w] < R.roundTime;
+}
+
+// Gray level per kind; the ship is brightest so it is never hidden
+const uint8_t OBS_WALL = 70, OBS_SHAPE = 110, OBS_COLLECT = 150, OBS_PU_SPEED = 180,
+              OBS_PU_SHIELD = 200, OBS_TARGET = 225, OBS_SHIP = 255;
+
+struct ObsRenderer {
+    int size = 0;                   // obs are size x size, row 0 at the top
+    float sx = 1, sy = 1;           // world px -> obs px
+    float x0 = 0, y1 = 0;
+    std::vector<uint8_t> background;
+
+    // Draws the level's static layer; call again when the level changes
+    void build(const EnvLevel& L, int s) {
+        const int SS = 4;
+        size = s; x0 = L.x0; y1 = L.y1;
+        sx = s / (L.x1 - L.x0); sy = s / (L.y1 - L.y0);
+        SoftFrame f;
+        f.resize(s * SS, s * SS);
+        std::fill(f.px.begin(), f.px.end(), 0u);
+        float fx = sx * SS, fy = sy * SS;   // world -> supersampled, y up like the game
+        auto X = [&](float x) { return (x - L.x0) * fx; };
+        auto Y = [&](float y) { return (y - L.y0) * fy; };
+        for (int r = 0; r < L.walls.rows; r++) {
+            float ty = L.walls.y0 + r * L.walls.size;
+            tileForEachRun(L.walls, r, [&](int a, int b) {
+                softFillRect(f, X(L.walls.x0 + a * L.walls.size), Y(ty), X(L.walls.x0 + b * L.walls.size), Y(ty + L.walls.size), OBS_WALL);
+            });
+        }
+        for (size_t i = 0; i < L.sqx.size(); i++)
+            softFillRect(f, X(L.sqx[i] - L.sqh[i]), Y(L.sqy[i] - L.sqh[i]), X(L.sqx[i] + L.sqh[i]), Y(L.sqy[i] + L.sqh[i]), OBS_SHAPE);
+        float xy[2 * POLY_MAX_VERTS], bx[4], by[4];
+        for (const auto& b : L.boxes) {
+            boxCorners(b, bx, by);
+            for (int k = 0; k < 4; k++) { xy[2 * k] = X(bx[k]); xy[2 * k + 1] = Y(by[k]); }
+            softFillConvex(f, xy, 4, OBS_SHAPE);
+        }
+        for (const auto& p : L.polys) {
+            for (int k = 0; k < p.n; k++) { xy[2 * k] = X(p.px[k]); xy[2 * k + 1] = Y(p.py[k]); }
+            softFillConvex(f, xy, p.n, OBS_SHAPE);
+        }
+        // max over each SS x SS block; the frame is bottom-up, obs rows top-down
+        background.assign((size_t)s * s, 0);
+        for (int y = 0; y < s * SS; y++) {
+            uint8_t* row = &background[(size_t)(s - 1 - y / SS) * s];
+            const uint32_t* src = f.row(y);
+            for (int x = 0; x < s * SS; x++) row[x / SS] = std::max(row[x / SS], (uint8_t)src[x]);
+        }
+    }
+
+    // Every pixel the world box [ax,bx] x [ay,by] overlaps, at least one
+    void stamp(uint8_t* img, float ax, float ay, float bx, float by, uint8_t v) const {
+        int c0 = std::max(0, (int)floorf((ax - x0) * sx)), c1 = std::min(size - 1, (int)floorf((bx - x0) * sx));
+        int r0 = std::max(0, (int)floorf((y1 - by) * sy)), r1 = std::min(size - 1, (int)floorf((y1 - ay) * sy));
+        for (int r = r0; r <= r1; r++) memset(img + (size_t)r * size + c0, v, std::max(0, c1 - c0 + 1));
+    }
+
+    void render(const EnvLevel& L, const EnvBatch& B, int w, uint8_t* img) const {
+        memcpy(img, background.data(), background.size());
+        static const uint8_t SHADE[3] = { OBS_COLLECT, OBS_PU_SPEED, OBS_PU_SHIELD };
+        const uint64_t* bits = &B.itemsLeft[(size_t)w * B.itemWords];
+        for (int i = 0; i < B.itemWords; i++)
+            for (uint64_t m = bits[i]; m; m &= m - 1) {
+                int k = i * 64 + ctz64(m);
+                float r = L.ir[k];
+                stamp(img, L.ix[k] - r, L.iy[k] - r, L.ix[k] + r, L.iy[k] + r, SHADE[L.ikind[k]]);
+            }
+        float tx, ty; L.targetAt(B.targetT[w], tx, ty);
+        stamp(img, tx - L.targetR, ty - L.targetR, tx + L.targetR, ty + L.targetR, OBS_TARGET);
+        float r = L.playerR;
+        stamp(img, B.px[w] - r, B.py[w] - r, B.px[w] + r, B.py[w] + r, OBS_SHIP);
+    }
+
+    // One size x size image per world into out (n * size * size bytes), in parallel
+    void renderAll(const EnvLevel& L, const EnvBatch& B, uint8_t* out) const {
+        size_t pix = (size_t)size * size;
+        parallelFor(B.n, 64, [&](int b, int e) {
+            for (int w = b; w < e; w++) render(L, B, w, out + w * pix);
+        });
+    }
+};
+
+// A level, its rules and n worlds with the buffers a trainer reads and writes:
+// actions in, observations, rewards and done flags out. Bindings hand these
+// buffers out once and then only call resetAll/stepAll.
+struct EnvSet {
+    EnvLevel level;
+    EnvRules rules;
+    EnvBatch batch;
+    ObsRenderer view;
+    std::vector<uint8_t> actions, obs;
+    std::vector<float> rewards;
+    bool lockstep = true;           // 8 worlds per EnvBatch::stepLanes where SSE is available
+
+    void init(int worlds, int obsSize) {
+        level.finish();
+        batch.resize(level, worlds);
+        view.build(level, obsSize);
+        actions.assign(worlds, 0);
+        obs.assign((size_t)worlds * obsSize * obsSize, 0);
+        rewards.assign(worlds, 0.0f);
+    }
+
+    // Worlds [b, e) through caller buffers indexed like the members above;
+    // worker processes point them into shared memory
+    void resetRange(int b, int e, float* rew, uint8_t* out) {
+        size_t pix = (size_t)view.size * view.size;
+        for (int w = b; w < e; w++) {
+            batch.reset(level, w, rules.maxLives);
+            rew[w] = 0;
+            view.render(level, batch, w, &out[w * pix]);
+        }
+    }
+
+    void stepRange(int b, int e, const uint8_t* act, float* rew, uint8_t* out) {
+        size_t pix = (size_t)view.size * view.size;
+        int w = b;
+#ifdef MATH2D_SSE
+        if (lockstep)
+            for (; w + 8 <= e; w += 8) {
+                batch.stepLanes(level, rules, w, act + w, rew + w);
+                for (int l = 0; l < 8; l++) view.render(level, batch, w + l, &out[(w + l) * pix]);
+            }
+#endif
+        for (; w < e; w++) {
+            rew[w] = batch.step(level, rules, w, act[w]);
+            view.render(level, batch, w, &out[w * pix]);
+        }
+    }
+
+    void resetAll() {
+        parallelFor(batch.n, 64, [&](int b, int e) { resetRange(b, e, rewards.data(), obs.data()); });
+    }
+
+    void stepAll() {
+        parallelFor(batch.n, 64, [&](int b, int e) { stepRange(b, e, actions.data(), rewards.data(), obs.data()); });
+    }
+};
+
+// ---------------- level files ----------------
+// Plain text, one record per line; the editor saves them ('o'):
+//   area x0 y0 x1 y1 / start x y r / target r / path x y x y x y x y
+//   tiles cols rows size x0 y0, then one line of '#' and '.' per row
+//   square x y h / box x y hx hy angle / poly n x y ... / item kind x y r
+inline bool saveLevel(const EnvLevel& L, const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "area %.9g %.9g %.9g %.9g\n", L.x0, L.y0, L.x1, L.y1);
+    fprintf(f, "start %.9g %.9g %.9g\ntarget %.9g\n", L.startX, L.startY, L.playerR, L.targetR);
+    fprintf(f, "path %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g\n", L.path[0][0], L.path[0][1], L.path[1][0], L.path[1][1],
+            L.path[2][0], L.path[2][1], L.path[3][0], L.path[3][1]);
+    const TileMap& t = L.walls;
+    fprintf(f, "tiles %d %d %.9g %.9g %.9g\n", t.cols, t.rows, t.size, t.x0, t.y0);
+    for (int r = 0; r < t.rows; r++) {
+        for (int c = 0; c < t.cols; c++) fputc(t.get(c, r) ? '#' : '.', f);
+        fputc('\n', f);
+    }
+    for (size_t i = 0; i < L.sqx.size(); i++) fprintf(f, "square %.9g %.9g %.9g\n", L.sqx[i], L.sqy[i], L.sqh[i]);
+    for (const auto& b : L.boxes) fprintf(f, "box %.9g %.9g %.9g %.9g %.9g\n", b.x, b.y, b.hx, b.hy, b.angle);
+    for (const auto& p : L.polys) {
+        fprintf(f, "poly %d", p.n);
+        for (int k = 0; k < p.n; k++) fprintf(f, " %.9g %.9g", p.px[k], p.py[k]);
+        fputc('\n', f);
+    }
+    for (int i = 0; i < L.items(); i++) fprintf(f, "item %d %.9g %.9g %.9g\n", L.ikind[i], L.ix[i], L.iy[i], L.ir[i]);
+    return fclose(f) == 0;
+}
+
+inline bool loadLevel(EnvLevel& L, const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    L = EnvLevel();
+    char key[16];
+    bool ok = true;
+    while (ok && fscanf(f, "%15s", key) == 1) {
+        if (!strcmp(key, "area")) ok = fscanf(f, "%f %f %f %f", &L.x0, &L.y0, &L.x1, &L.y1) == 4;
+        else if (!strcmp(key, "start")) ok = fscanf(f, "%f %f %f", &L.startX, &L.startY, &L.playerR) == 3;
+        else if (!strcmp(key, "target")) ok = fscanf(f, "%f", &L.targetR) == 1;
+        else if (!strcmp(key, "path"))
+            for (int k = 0; k < 4 && ok; k++) ok = fscanf(f, "%f %f", &L.path[k][0], &L.path[k][1]) == 2;
+        else if (!strcmp(key, "tiles")) {
+            int cols, rows; float size, x0, y0;
+            ok = fscanf(f, "%d %d %f %f %f", &cols, &rows, &size, &x0, &y0) == 5 && cols >= 0 && rows >= 0;
+            if (ok) L.walls.resize(cols, rows, size, x0, y0);
+            for (int r = 0; r < rows && ok; r++)
+                for (int c = 0; c < cols && ok; c++) {
+                    int ch = fgetc(f);
+                    while (ch == '\n' || ch == '\r' || ch == ' ') ch = fgetc(f);
+                    ok = ch == '#' || ch == '.';
+                    if (ch == '#') L.walls.set(c, r, true);
+                }
+        }
+        else if (!strcmp(key, "square")) {
+            float x, y, h;
+            ok = fscanf(f, "%f %f %f", &x, &y, &h) == 3;
+            L.sqx.push_back(x); L.sqy.push_back(y); L.sqh.push_back(h);
+        }
+        else if (!strcmp(key, "box")) {
+            OBox b;
+            ok = fscanf(f, "%f %f %f %f %f", &b.x, &b.y, &b.hx, &b.hy, &b.angle) == 5;
+            L.boxes.push_back(b);
+        }
+        else if (!strcmp(key, "poly")) {
+            ConvexPoly p;
+            ok = fscanf(f, "%d", &p.n) == 1 && p.n >= 3 && p.n <= POLY_MAX_VERTS;
+            for (int k = 0; k < p.n && ok; k++) ok = fscanf(f, "%f %f", &p.px[k], &p.py[k]) == 2;
+            L.polys.push_back(p);
+        }
+        else if (!strcmp(key, "item")) {
+            int kind; float x, y, r;
+            ok = fscanf(f, "%d %f %f %f", &kind, &x, &y, &r) == 4 && kind >= 0 && kind <= ENV_PU_SHIELD;
+            L.ix.push_back(x); L.iy.push_back(y); L.ir.push_back(r); L.ikind.push_back((uint8_t)kind);
+        }
+        else ok = false;
+    }
+    fclose(f);
+    return ok;
+}
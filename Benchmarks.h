@@ -0,0 +1,1005 @@
+// ====== Benchmarks (--bench-<name>) ======
+// Console-only measurements; each runs instead of the game and prints a
+// table. Included by OpenGL2DTemplate.cpp after the game's own definitions,
+// just ahead of the --bench-* dispatch: the header modules are measured
+// directly, and benches of game systems (destroy, fog, lidar, obs, lanes,
+// spawn, magnet) build their fixture in the game's globals inside a
+// BenchGameScope, which puts the globals back when the bench returns.
+
+#pragma once
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+double benchNowMs() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// xorshift32, deterministic inputs for every run
+struct BenchRng {
+    uint32_t s = 2463534242u;
+    uint32_t next() { s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; }
+    float uniform(float lo, float hi) { return lo + (hi - lo) * (next() >> 8) * (1.0f / 16777216.0f); }
+};
+
+volatile float benchSink; // keeps results alive
+
+// Copies of the game state a fixture overwrites; put back when the bench ends
+struct BenchGameScope {
+    std::vector<std::function<void()>> undo;
+
+    template <class T>
+    void keep(T& v) {
+        std::shared_ptr<T> saved = std::make_shared<T>(v);
+        undo.push_back([&v, saved] { v = std::move(*saved); });
+    }
+
+    BenchGameScope() {
+        keep(obstacles); keep(collectibles); keep(powerups); keep(walls);
+        keep(boxes); keep(polys); keep(boxBlocks); keep(polyBlocks);
+        keep(obstacleGrid); keep(squareCells); keep(boxCells); keep(polyCells);
+        keep(itemGrid); keep(movers); keep(swarm); keep(swarmOn);
+        keep(fog); keep(fogIds); keep(target); keep(player); keep(timeSec);
+        keep(spawnSpace); keep(pickupGrid); keep(collectCells); keep(collectPulled);
+        keep(magnetPulling); keep(pickupIds);
+        for (float& f : lidarArea) keep(f);
+    }
+    ~BenchGameScope() { for (auto& u : undo) u(); }
+};
+
+// Runs fn(i) over n inputs `reps` times; returns ns per input
+template <class F>
+double benchLoop(int n, int reps, F fn) {
+    double t0 = benchNowMs();
+    for (int r = 0; r < reps; r++) fn();
+    return (benchNowMs() - t0) * 1e6 / ((double)n * reps);
+}
+
+void benchMath() {
+    const int N = 1 << 20, REPS = 8;
+    BenchRng rng;
+    std::vector<float> a(N), b(N), c(N), out(N);
+    for (int i = 0; i < N; i++) { a[i] = rng.uniform(-100, 100); b[i] = rng.uniform(-1, 1); c[i] = rng.uniform(-1, 1); }
+
+    printf("%-28s %10s %12s\n", "function", "ns/elem", "max |err|");
+    // ns < 0: accuracy only; err < 0: timing only
+    auto report = [&](const char* name, double ns, double err) {
+        char t[32] = "-", e[32] = "-";
+        if (ns >= 0) sprintf(t, "%.3f", ns);
+        if (err >= 0) sprintf(e, "%.3g", err);
+        printf("%-28s %10s %12s\n", name, t, e);
+    };
+    auto sum = [&]() { float s = 0; for (int i = 0; i < N; i += 64) s += out[i]; benchSink = s; };
+
+    // sin / cos over [-100, 100]
+    double ns, err;
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i++) out[i] = sinf(a[i]); sum(); });
+    report("sinf (libm)", ns, -1);
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i++) out[i] = fastSin(a[i]); sum(); });
+    err = 0; for (int i = 0; i < N; i++) err = std::max(err, fabs(out[i] - sin((double)a[i])));
+    report("fastSin", ns, err);
+#ifdef MATH2D_SSE
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i += 4) store4(&out[i], fastSin4(load4(&a[i]))); sum(); });
+    err = 0; for (int i = 0; i < N; i++) err = std::max(err, fabs(out[i] - sin((double)a[i])));
+    report("fastSin4", ns, err);
+#endif
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i++) out[i] = cosf(a[i]); sum(); });
+    report("cosf (libm)", ns, -1);
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i++) out[i] = fastCos(a[i]); sum(); });
+    err = 0; for (int i = 0; i < N; i++) err = std::max(err, fabs(out[i] - cos((double)a[i])));
+    report("fastCos", ns, err);
+#ifdef MATH2D_SSE
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i += 4) store4(&out[i], fastCos4(load4(&a[i]))); sum(); });
+    err = 0; for (int i = 0; i < N; i++) err = std::max(err, fabs(out[i] - cos((double)a[i])));
+    report("fastCos4", ns, err);
+#endif
+
+    // large arguments: timeSec * 18 after a long session
+    for (int i = 0; i < N; i++) c[i] = rng.uniform(-1e5f, 1e5f);
+    for (int i = 0; i < N; i++) out[i] = fastSin(c[i]);
+    err = 0; for (int i = 0; i < N; i++) err = std::max(err, fabs(out[i] - sin((double)c[i])));
+    report("fastSin |x|<1e5", -1, err);
+    for (int i = 0; i < N; i++) c[i] = rng.uniform(-1, 1);
+
+    // atan2 over the unit square
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i++) out[i] = atan2f(b[i], c[i]); sum(); });
+    report("atan2f (libm)", ns, -1);
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i++) out[i] = fastAtan2(b[i], c[i]); sum(); });
+    err = 0; for (int i = 0; i < N; i++) err = std::max(err, fabs(out[i] - atan2((double)b[i], (double)c[i])));
+    report("fastAtan2", ns, err);
+#ifdef MATH2D_SSE
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i += 4) store4(&out[i], fastAtan2_4(load4(&b[i]), load4(&c[i]))); sum(); });
+    err = 0; for (int i = 0; i < N; i++) err = std::max(err, fabs(out[i] - atan2((double)b[i], (double)c[i])));
+    report("fastAtan2_4", ns, err);
+#endif
+
+    // clamp / distance
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i++) { float v = a[i]; out[i] = v < -50 ? -50 : (v > 50 ? 50 : v); } sum(); });
+    report("clamp (ternary)", ns, -1);
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i++) out[i] = clampf(a[i], -50, 50); sum(); });
+    report("clampf", ns, -1);
+#ifdef MATH2D_SSE
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i += 4) store4(&out[i], clamp4(load4(&a[i]), f4(-50), f4(50))); sum(); });
+    report("clamp4", ns, -1);
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i += 8) store8(&out[i], clamp8(load8(&a[i]), f8(-50), f8(50))); sum(); });
+    report("clamp8", ns, -1);
+#endif
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i++) out[i] = dist2(a[i], b[i], 1.0f, 2.0f); sum(); });
+    report("dist2", ns, -1);
+#ifdef MATH2D_SSE
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i += 4) store4(&out[i], dist2_4(load4(&a[i]), load4(&b[i]), f4(1), f4(2))); sum(); });
+    report("dist2_4", ns, -1);
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i += 8) store8(&out[i], dist2_8(load8(&a[i]), load8(&b[i]), f8(1), f8(2))); sum(); });
+    report("dist2_8", ns, -1);
+#endif
+    ns = benchLoop(N, REPS, [&] { for (int i = 0; i < N; i++) out[i] = intersectCircleCircle(a[i], b[i], 5, 0, 0, 5) ? 1.0f : 0.0f; sum(); });
+    report("intersectCircleCircle", ns, -1);
+
+    // tryMove's obstacle scan: circle vs 4096 squares, no hit (full scan)
+    std::vector<Obj> sq(4096);
+    for (auto& o : sq) { o.x = rng.uniform(100, 900); o.y = rng.uniform(200, 600); o.r = 18; o.type = OBJ_OBSTACLE; }
+    ns = benchLoop((int)sq.size(), 2000, [&] { benchSink = circleHitsSquares(sq, -500, -500, 14) ? 1.0f : 0.0f; });
+    report("circleHitsSquares (per obj)", ns, -1);
+}
+
+// Maze walls as bit tiles vs one Obj square per tile: memory and query cost
+void benchTiles() {
+    printf("%-12s %9s %12s %12s %12s %12s %8s\n", "maze tiles", "walls", "tile bytes", "Obj bytes",
+           "tile ns/q", "Obj ns/q", "agree");
+    const int sizes[] = { 64, 256, 1024 };
+    for (int n : sizes) {
+        TileMap tm;
+        tm.resize(n, n, TILE_SIZE, 0, 0);
+        tileMaze(tm, MAZE_PITCH, 12345);
+
+        std::vector<Obj> sq;
+        float h = TILE_SIZE * 0.5f;
+        for (int r = 0; r < n; r++)
+            tileForEachRun(tm, r, [&](int c0, int c1) {
+                for (int c = c0; c < c1; c++) {
+                    Obj o; o.x = (c + 0.5f) * TILE_SIZE; o.y = (r + 0.5f) * TILE_SIZE; o.r = h; o.type = OBJ_OBSTACLE;
+                    sq.push_back(o);
+                }
+            });
+
+        // player-sized probes anywhere in the maze
+        const int Q = 4096;
+        BenchRng rng;
+        std::vector<float> qx(Q), qy(Q);
+        for (int i = 0; i < Q; i++) { qx[i] = rng.uniform(0, n * TILE_SIZE); qy[i] = rng.uniform(0, n * TILE_SIZE); }
+
+        std::vector<uint8_t> a(Q), b(Q);
+        double tns = benchLoop(Q, 200, [&] { for (int i = 0; i < Q; i++) a[i] = tileCircleHits(tm, qx[i], qy[i], 14); });
+        int qo = std::max(64, (int)(Q * 4096LL / (long long)sq.size()) & ~3);  // keep the linear scan bounded
+        qo = std::min(qo, Q);
+        double ons = benchLoop(qo, 1, [&] { for (int i = 0; i < qo; i++) b[i] = circleHitsSquares(sq, qx[i], qy[i], 14); });
+        int agree = 0;
+        for (int i = 0; i < qo; i++) agree += a[i] == b[i];
+
+        char label[32]; sprintf(label, "%dx%d", n, n);
+        printf("%-12s %9d %12d %12d %12.1f %12.1f %7.1f%%\n", label, tm.count(), (int)tm.bytes(),
+               (int)(sq.size() * sizeof(Obj)), tns, ons, 100.0 * agree / qo);
+    }
+}
+
+// Circle vs squares / rotated boxes / convex polygons at equal obstacle counts
+void benchShapes() {
+    printf("%-8s %14s %14s %14s %14s %8s\n", "count", "square ns/q", "box ns/q", "poly ns/q", "poly scalar", "agree");
+    const int counts[] = { 64, 1024, 16384 };
+    for (int n : counts) {
+        BenchRng rng;
+        // same density at every size: ~1 obstacle per 60x60 px
+        float side = sqrtf((float)n) * 60.0f;
+        std::vector<Obj> sq(n);
+        std::vector<OBox> bx(n);
+        std::vector<ConvexPoly> pl(n);
+        for (int i = 0; i < n; i++) {
+            float x = rng.uniform(0, side), y = rng.uniform(0, side);
+            sq[i].x = x; sq[i].y = y; sq[i].r = 18; sq[i].type = OBJ_OBSTACLE;
+            bx[i] = makeEditorBox(x, y, i);
+            pl[i] = makeEditorPoly(x, y, i);
+        }
+        std::vector<BoxBlock> bb; buildBoxBlocks(bx, bb);
+        std::vector<PolyBlock> pb; buildPolyBlocks(pl, pb);
+
+        const int Q = std::max(64, 262144 / n);
+        std::vector<float> qx(Q), qy(Q);
+        for (int i = 0; i < Q; i++) { qx[i] = rng.uniform(0, side); qy[i] = rng.uniform(0, side); }
+        std::vector<uint8_t> a(Q), b(Q);
+
+        // early-out on the first hit, as in tryMove
+        double ts = benchLoop(Q, 4, [&] { for (int i = 0; i < Q; i++) a[i] = circleHitsSquares(sq, qx[i], qy[i], 14); });
+        double tb = benchLoop(Q, 4, [&] { for (int i = 0; i < Q; i++) a[i] = circleHitsBoxes(bb, qx[i], qy[i], 14); });
+        double tp = benchLoop(Q, 4, [&] { for (int i = 0; i < Q; i++) a[i] = circleHitsPolys(pb, qx[i], qy[i], 14); });
+        double tr = benchLoop(Q, 4, [&] {
+            for (int i = 0; i < Q; i++) {
+                bool hit = false;
+                for (int k = 0; k < n && !hit; k++) hit = circleHitsPoly(pl[k], qx[i], qy[i], 14);
+                b[i] = hit;
+            }
+        });
+        int agree = 0;
+        for (int i = 0; i < Q; i++) agree += a[i] == b[i];
+        printf("%-8d %14.1f %14.1f %14.1f %14.1f %7.1f%%\n", n, ts, tb, tp, tr, 100.0 * agree / Q);
+    }
+}
+
+// Mixed-kind narrow phase: switch per pair vs the shape-pair matrix
+void benchPairs() {
+    const int M = 1024, P = 1 << 18, REPS = 8;
+    BenchRng rng;
+    const float side = 2000;
+    ShapeTables<Obj> t;
+    std::vector<Obj> sq(M);
+    std::vector<OBox> bx(M);
+    std::vector<ConvexPoly> pl(M);
+    for (int i = 0; i < M; i++) {
+        t.addCircle(rng.uniform(0, side), rng.uniform(0, side), rng.uniform(8, 20));
+        sq[i].x = rng.uniform(0, side); sq[i].y = rng.uniform(0, side); sq[i].r = 18; sq[i].type = OBJ_OBSTACLE;
+        bx[i] = makeEditorBox(rng.uniform(0, side), rng.uniform(0, side), i);
+        pl[i] = makeEditorPoly(rng.uniform(0, side), rng.uniform(0, side), i);
+    }
+    std::vector<BoxBlock> bb; buildBoxBlocks(bx, bb);
+    std::vector<PolyBlock> pb; buildPolyBlocks(pl, pb);
+    t.squares = sq.data(); t.boxes = bb.data(); t.polys = pb.data();
+
+    // circle i sits within 30px of one shape of kind i&3 (another circle, square i,
+    // box i or polygon i), so hits and misses are mixed; top down so circle i+1 is placed first
+    for (int i = M - 1; i >= 0; i--) {
+        float jx = rng.uniform(-30, 30), jy = rng.uniform(-30, 30);
+        switch (i & 3) {
+        case 0: t.cx[i] = t.cx[(i + 1) % M] + jx; t.cy[i] = t.cy[(i + 1) % M] + jy; break;
+        case 1: t.cx[i] = sq[i].x + jx; t.cy[i] = sq[i].y + jy; break;
+        case 2: t.cx[i] = bx[i].x + jx; t.cy[i] = bx[i].y + jy; break;
+        default: { float cx, cy, br; polyBounds(pl[i], cx, cy, br); t.cx[i] = cx + jx; t.cy[i] = cy + jy; } break;
+        }
+    }
+    // candidate pairs in random kind order: a random circle with the shape it sits on
+    std::vector<int> ka(P), kb(P), ia(P), ib(P);
+    for (int k = 0; k < P; k++) {
+        int i = ia[k] = rng.next() % M;
+        ka[k] = SHAPE_CIRCLE;
+        kb[k] = (i & 3) == 0 ? SHAPE_CIRCLE : (i & 3);
+        ib[k] = (i & 3) == 0 ? (i + 1) % M : i;
+    }
+
+    std::vector<uint8_t> ref(P);
+    double tSwitch = benchLoop(P, REPS, [&] {
+        for (int k = 0; k < P; k++) {
+            float x = t.cx[ia[k]], y = t.cy[ia[k]], r = t.cr[ia[k]];
+            int j = ib[k];
+            bool h = false;
+            switch (kb[k]) {
+            case SHAPE_CIRCLE: h = intersectCircleCircle(x, y, r, t.cx[j], t.cy[j], t.cr[j]); break;
+            case SHAPE_SQUARE: {
+                float qx = clampf(x, sq[j].x - sq[j].r, sq[j].x + sq[j].r), qy = clampf(y, sq[j].y - sq[j].r, sq[j].y + sq[j].r);
+                h = dist2(x, y, qx, qy) < r * r;
+            } break;
+            case SHAPE_BOX:  h = circleHitsBox(bx[j], x, y, r); break;
+            case SHAPE_POLY: h = circleHitsPoly(pl[j], x, y, r); break;
+            }
+            ref[k] = h;
+        }
+    });
+
+    CollisionMatrix cm;
+    int hits = 0;
+    double tMatrix = benchLoop(P, REPS, [&] {
+        cm.clear();
+        for (int k = 0; k < P; k++) cm.add((ShapeKind)ka[k], ia[k], (ShapeKind)kb[k], ib[k]);
+        cm.run(t);
+    });
+
+    // matrix output is grouped by cell; replay the grouping to compare with ref
+    int pos[SHAPE_KINDS] = { 0, 0, 0, 0 }, agree = 0;
+    for (int k = 0; k < P; k++) {
+        uint8_t h = cm.batch(SHAPE_CIRCLE, (ShapeKind)kb[k]).hit[pos[kb[k]]++];
+        agree += h == ref[k];
+        hits += ref[k];
+    }
+    printf("%d mixed pairs (circle vs circle/square/box/polygon), %.0f%% hit\n", P, 100.0 * hits / P);
+    printf("%-28s %10.2f ns/pair\n", "switch per pair (scalar)", tSwitch);
+    printf("%-28s %10.2f ns/pair\n", "shape-pair matrix", tMatrix);
+    printf("%-28s %9.2f%%\n", "agree", 100.0 * agree / P);
+}
+
+// Movers at constant density: step + incremental grid vs rebuilding the grid each tick
+void benchMovers() {
+    printf("%-8s %12s %12s %12s %10s %12s %10s\n", "movers", "step ms", "rebuild ms", "query ns", "moved %", "edits/tick", "60Hz use");
+    const int counts[] = { 1000, 10000, 100000 };
+    const float dt = 1.0f / 60;
+    for (int n : counts) {
+        BenchRng rng;
+        float side = sqrtf((float)n) * 60.0f;   // ~1 mover per 60x60 px
+        MoverSet m;
+        m.init(0, 0, side, side, MOVER_CELL);
+        for (int i = 0; i < n; i++) {
+            float ax = rng.uniform(0, side), ay = rng.uniform(0, side);
+            float bx = clampf(ax + rng.uniform(-150, 150), 0, side), by = clampf(ay + rng.uniform(-150, 150), 0, side);
+            float p[4][2];
+            makeMoverPath(ax, ay, bx, by, p);
+            m.add(p, MOVER_HALF, rng.uniform(0.5f, 1.5f) * MOVER_SPEED, rng.uniform(0, 1));
+        }
+
+        const int TICKS = 120;
+        long long edits0 = m.grid.cellEdits, moved = 0;
+        double t0 = benchNowMs();
+        for (int k = 0; k < TICKS; k++) { m.step(dt); moved += m.lastCellChanges; }
+        double stepMs = (benchNowMs() - t0) / TICKS;
+        double edits = (double)(m.grid.cellEdits - edits0) / TICKS;
+
+        // the non-incremental alternative: same step, then clear and re-insert everyone
+        t0 = benchNowMs();
+        for (int k = 0; k < TICKS; k++) {
+            m.step(dt);
+            m.grid.clear();
+            for (int i = 0; i < n; i++) m.grid.insert(i, m.cellr[i]);
+        }
+        double rebuildMs = (benchNowMs() - t0) / TICKS;
+
+        // player-sized swept queries
+        const int Q = 65536;
+        std::vector<float> qx(Q), qy(Q);
+        for (int i = 0; i < Q; i++) { qx[i] = rng.uniform(0, side); qy[i] = rng.uniform(0, side); }
+        int hits = 0;
+        double qns = benchLoop(Q, 1, [&] { for (int i = 0; i < Q; i++) hits += m.circleHits(qx[i], qy[i], 14); });
+        benchSink = (float)hits;
+
+        printf("%-8d %12.3f %12.3f %12.1f %9.2f%% %12.0f %9.1f%%\n", n, stepMs, rebuildMs, qns,
+               100.0 * moved / ((double)n * TICKS), edits, 100.0 * stepMs / (1000.0 / 60));
+    }
+}
+
+// Mover levels of detail: the player crosses worlds of growing size (same
+// density as --bench-movers); full-rate step() against stepLod() on a copy.
+// Movers near the player must be where the full-rate set has them.
+void benchLod() {
+    printf("%-9s %12s %12s %14s %14s\n", "movers", "step ms", "lod ms", "stepped/tick", "near err px");
+    const int counts[] = { 10000, 100000, 1000000 };
+    const float dt = 1.0f / 60;
+    const int TICKS = 240;
+    for (int n : counts) {
+        BenchRng rng;
+        float side = sqrtf((float)n) * 60.0f;
+        MoverSet full, lod;
+        full.init(0, 0, side, side, MOVER_CELL);
+        lod.init(0, 0, side, side, MOVER_CELL);
+        for (int i = 0; i < n; i++) {
+            float ax = rng.uniform(0, side), ay = rng.uniform(0, side);
+            float bx = clampf(ax + rng.uniform(-150, 150), 0, side), by = clampf(ay + rng.uniform(-150, 150), 0, side);
+            float p[4][2];
+            makeMoverPath(ax, ay, bx, by, p);
+            float speed = rng.uniform(0.5f, 1.5f) * MOVER_SPEED, t0 = rng.uniform(0, 1);
+            full.add(p, MOVER_HALF, speed, t0);
+            lod.add(p, MOVER_HALF, speed, t0);
+        }
+        // the player runs a diagonal through the middle at boost speed
+        auto playerAt = [&](int k, float& x, float& y) { x = side * 0.5f + (k - TICKS / 2) * rules.boost * dt; y = x; };
+        double fullMs = 0, lodMs = 0, err = 0;
+        long long stepped = 0;
+        for (int k = 0; k < TICKS; k++) {
+            float x, y; playerAt(k, x, y);
+            double t0 = benchNowMs();
+            full.step(dt);
+            fullMs += benchNowMs() - t0;
+            t0 = benchNowMs();
+            lod.stepLod(dt, x, y);
+            lodMs += benchNowMs() - t0;
+            stepped += lod.lastStepped;
+            float reach = lod.lodNear - MOVER_CELL;
+            full.grid.query(x - reach, y - reach, x + reach, y + reach, [&](int i) {
+                err = std::max(err, (double)std::max(std::max(fabsf(full.x[i] - lod.x[i]), fabsf(full.y[i] - lod.y[i])),
+                                                     std::max(fabsf(full.px[i] - lod.px[i]), fabsf(full.py[i] - lod.py[i]))));
+                return false;
+            });
+        }
+        printf("%-9d %12.3f %12.3f %14.0f %14.5f\n", n, fullMs / TICKS, lodMs / TICKS, (double)stepped / TICKS, err);
+    }
+}
+
+// Projectile pool: SoA + SSE step vs an AoS scalar loop, plus the batched soft
+// draw; the last column is how many projectiles fit step + draw in a 60 Hz frame
+void benchBullets() {
+    printf("%-9s %12s %12s %12s %12s %14s\n", "shots", "AoS ns/shot", "SoA ns/shot", "step ms", "draw ms", "fit @60Hz");
+    struct Shot { float x, y, vx, vy, life; };
+    const int counts[] = { 10000, 100000, 1000000 };
+    const float side = 4000, dt = 1.0f / 60;
+    SoftFrame frame; frame.resize(W, H);
+    TileMap none;
+    for (int n : counts) {
+        BenchRng rng;
+        ProjectilePool pool;
+        pool.reserve(n);
+        std::vector<Shot> aos(n);
+        for (int i = 0; i < n; i++) {
+            Shot s = { rng.uniform(0, side), rng.uniform(0, side), rng.uniform(-150, 150), rng.uniform(-150, 150), 1e6f };
+            aos[i] = s;
+            pool.spawn(s.x, s.y, s.vx, s.vy, s.life);
+        }
+        // the receiver sits mid-field, so a few die each tick in both versions
+        const float rx = side * 0.5f, ry = side * 0.5f, rr = 14, reach2 = (rr + SHOT_R) * (rr + SHOT_R);
+        const int TICKS = std::max(4, 4000000 / n);
+        int hitsA = 0, hitsB = 0;
+        double tA = benchLoop(n, TICKS, [&] {
+            size_t w = 0;
+            for (size_t i = 0; i < aos.size(); i++) {
+                Shot s = aos[i];
+                s.x += s.vx * dt; s.y += s.vy * dt; s.life -= dt;
+                if (s.life <= 0 || s.x < 0 || s.y < 0 || s.x > side || s.y > side) continue;
+                if (dist2(s.x, s.y, rx, ry) < reach2) { hitsA++; continue; }
+                aos[w++] = s;
+            }
+            aos.resize(w);
+        });
+        double tB = benchLoop(n, TICKS, [&] { hitsB += pool.step(dt, 0, 0, side, side, none, rx, ry, rr); });
+
+        // n dots spread over a W x H window
+        std::vector<float> xy(2 * (size_t)n);
+        for (int i = 0; i < n; i++) { xy[2 * i] = rng.uniform(0, W); xy[2 * i + 1] = rng.uniform(0, H); }
+        const int DRAWS = std::max(2, 1000000 / n);
+        double t0 = benchNowMs();
+        for (int d = 0; d < DRAWS; d++) softPoints(frame, xy.data(), n, 1, 1, 0, 0, SHOT_R * 2, 0xFFFF00FFu);
+        double drawMs = (benchNowMs() - t0) / DRAWS;
+
+        double stepMs = tB * n * 1e-6;
+        double fit = n * (1000.0 / 60) / (stepMs + drawMs);
+        printf("%-9d %12.2f %12.2f %12.3f %12.3f %14.0f\n", n, tA, tB, stepMs, drawMs, fit);
+        benchSink = (float)(hitsA + hitsB);
+    }
+}
+
+// Boids at constant density: cell-list build and update per tick, on one
+// thread and on all, with an all-pairs neighbor scan for scale
+void benchBoids() {
+    const int threads = std::max(1u, std::thread::hardware_concurrency());
+    printf("%d hardware threads\n", threads);
+    printf("%-8s %10s %12s %12s %10s %10s %14s\n", "boids", "build ms", "1 thread ms", "all ms", "ns/boid", "nbrs/boid", "all-pairs ms");
+    const int counts[] = { 1000, 10000, 50000, 200000 };
+    const float dt = 1.0f / 60;
+    TileMap none;
+    for (int n : counts) {
+        BenchRng rng;
+        float side = sqrtf((float)n) * 30.0f;   // ~1 boid per 30x30 px
+        BoidSwarm s;
+        s.init(0, 0, side, side);
+        for (int i = 0; i < n; i++) s.add(rng.uniform(0, side), rng.uniform(0, side), rng.uniform(-100, 100), rng.uniform(-100, 100));
+        std::vector<float> ox(16), oy(16), orr(16, 20.0f);
+        for (int i = 0; i < 16; i++) { ox[i] = rng.uniform(0, side); oy[i] = rng.uniform(0, side); }
+        s.setAvoid(ox.data(), oy.data(), orr.data(), 16);
+        for (int k = 0; k < 10; k++) s.step(dt, side * 0.5f, side * 0.5f, none);   // let flocks form
+        BoidSwarm snap = s;
+
+        const int TICKS = std::max(3, 2000000 / n);
+        double build = benchLoop(1, TICKS, [&] { s.cells.build(s.x.data(), s.y.data(), n); });
+        workers().setThreads(1);
+        double one = benchLoop(1, TICKS, [&] { s.step(dt, side * 0.5f, side * 0.5f, none); });
+        s = snap;
+        workers().setThreads(0);
+        long long used = 0;
+        double all = benchLoop(1, TICKS, [&] { s.step(dt, side * 0.5f, side * 0.5f, none); used += s.lastNeighbors; });
+
+        char brute[32] = "-";
+        if (n <= 10000) {
+            double t = benchLoop(1, 1, [&] {
+                float r2 = s.radius * s.radius; int c = 0;
+                for (int i = 0; i < n; i++)
+                    for (int j = 0; j < n; j++) c += (j != i) & (dist2(s.x[i], s.y[i], s.x[j], s.y[j]) < r2);
+                benchSink = (float)c;
+            });
+            sprintf(brute, "%.3f", t * 1e-6);
+        }
+        printf("%-8d %10.3f %12.3f %12.3f %10.1f %10.1f %14s\n", n, build * 1e-6, one * 1e-6, all * 1e-6,
+               all / n, (double)used / ((double)n * TICKS), brute);
+    }
+}
+
+// Cost per destroyed shape as the shape count grows 100x at the same density:
+// destroyShape against rebuilding everything it patches (grid, SoA blocks,
+// swarm avoid list), on the game's own structures.
+void benchDestroy() {
+    BenchGameScope keep;
+    const int NS[3] = { 1000, 10000, 100000 };
+    const int KILLS = 300;
+    const float PITCH = 48.0f;
+    printf("%-8s %12s %12s %12s %10s\n", "shapes", "destroy us", "rebuild us", "grid edits", "speedup");
+    for (int n : NS) {
+        BenchRng rng;
+        int side = (int)ceilf(sqrtf((float)n));
+        float world = side * PITCH;
+        obstacles.clear(); boxes.clear(); polys.clear();
+        for (int i = 0; i < n; i++) {
+            float x = (i % side + 0.5f) * PITCH, y = (i / side + 0.5f) * PITCH;
+            if (i % 3 == 0) { Obj o = { x, y, 18.0f, OBJ_OBSTACLE }; obstacles.push_back(o); }
+            else if (i % 3 == 1) boxes.push_back(makeEditorBox(x, y, i));
+            else polys.push_back(makeEditorPoly(x, y, i));
+        }
+        obstacleGrid.init(0, 0, world, world, OBSTACLE_CELL);
+        swarm.init(0, 0, world, world);
+        swarmOn = true;
+        double rebuild = benchLoop(1, 3, [&] { rebuildShapeBlocks(); reindexShapes(); updateSwarmAvoid(); }) / 1000.0;
+
+        long long edits0 = obstacleGrid.cellEdits;
+        double t0 = benchNowMs();
+        for (int d = 0; d < KILLS; d++) {
+            ShapeKind k = (ShapeKind)(SHAPE_SQUARE + rng.next() % 3);
+            int left = (int)shapeCells(k).size();
+            if (left > 0) destroyShape(k, rng.next() % left);
+        }
+        double us = (benchNowMs() - t0) * 1000.0 / KILLS;
+        double edits = (double)(obstacleGrid.cellEdits - edits0) / KILLS;
+
+        // the patched structures must equal a fresh build
+        bool ok = true;
+        std::vector<BoxBlock> bb; std::vector<PolyBlock> pb;
+        buildBoxBlocks(boxes, bb); buildPolyBlocks(polys, pb);
+        ok = bb.size() == boxBlocks.size() && pb.size() == polyBlocks.size()
+            && memcmp(bb.data(), boxBlocks.data(), bb.size() * sizeof(BoxBlock)) == 0;
+        for (size_t b = 0; ok && b < pb.size(); b++)
+            ok = memcmp(pb[b].cx, polyBlocks[b].cx, sizeof(pb[b].cx)) == 0;
+        for (int q = 0; ok && q < 20000; q++) {
+            float x = rng.uniform(0, world), y = rng.uniform(0, world);
+            bool slow = circleHitsSquares(obstacles, x, y, 14) || circleHitsBoxes(bb, x, y, 14) || circleHitsPolys(pb, x, y, 14);
+            ok = slow == (shapeHitAt(x, y, 14) >= 0);
+        }
+        printf("%-8d %12.2f %12.0f %12.1f %9.0fx%s\n", n, us, rebuild, edits, rebuild / us, ok ? "" : "  MISMATCH");
+    }
+}
+
+// Fog polygon per frame with 10k shapes (same mix as --bench-destroy, jittered):
+// grid-gathered edges vs every edge, and the bins against an exact ray cast
+void benchFog() {
+    BenchGameScope keep;
+    const int N = 10000, FRAMES = 200;
+    const float PITCH = 64.0f;
+    BenchRng rng;
+    int side = (int)ceilf(sqrtf((float)N));
+    float world = side * PITCH;
+    obstacles.clear(); boxes.clear(); polys.clear();
+    for (int i = 0; i < N; i++) {
+        float x = (i % side + 0.5f) * PITCH + rng.uniform(-8, 8), y = (i / side + 0.5f) * PITCH + rng.uniform(-8, 8);
+        if (i % 3 == 0) { Obj o = { x, y, 18.0f, OBJ_OBSTACLE }; obstacles.push_back(o); }
+        else if (i % 3 == 1) boxes.push_back(makeEditorBox(x, y, i));
+        else polys.push_back(makeEditorPoly(x, y, i));
+    }
+    rebuildShapeBlocks();
+    obstacleGrid.init(0, 0, world, world, OBSTACLE_CELL);
+    reindexShapes();
+    fog.init(FOG_BINS);
+
+    // viewers in free space
+    std::vector<float> vx, vy;
+    while ((int)vx.size() < FRAMES) {
+        float x = rng.uniform(FOG_RADIUS, world - FOG_RADIUS), y = rng.uniform(FOG_RADIUS, world - FOG_RADIUS);
+        if (shapeHitAt(x, y, 14) < 0) { vx.push_back(x); vy.push_back(y); }
+    }
+
+    long long edges = 0, bins = 0;
+    double grid = benchLoop(FRAMES, 1, [&] {
+        for (int f = 0; f < FRAMES; f++) {
+            fog.begin(vx[f], vy[f], FOG_RADIUS);
+            fogGather(vx[f], vy[f], FOG_RADIUS);
+            edges += fog.edges; bins += fog.edgeBins;
+        }
+    }) / 1e6;
+    float px[POLY_MAX_VERTS], py[POLY_MAX_VERTS];
+    auto allEdges = [&](float x, float y) {
+        fog.begin(x, y, FOG_RADIUS);
+        for (const auto& o : obstacles) {
+            float qx[4] = { o.x - o.r, o.x + o.r, o.x + o.r, o.x - o.r }, qy[4] = { o.y - o.r, o.y - o.r, o.y + o.r, o.y + o.r };
+            fogAddLoop(qx, qy, 4);
+        }
+        for (const auto& b : boxes) { boxCorners(b, px, py); fogAddLoop(px, py, 4); }
+        for (const auto& p : polys) fogAddLoop(p.px, p.py, p.n);
+    };
+    double brute = benchLoop(FRAMES, 1, [&] { for (int f = 0; f < FRAMES; f++) allEdges(vx[f], vy[f]); }) / 1e6;
+
+    // exact: nearest hit of each bin's center ray over every edge (two-sided)
+    double maxErr = 0; int wrong = 0;
+    for (int f = 0; f < 20; f++) {
+        fog.begin(vx[f], vy[f], FOG_RADIUS);
+        fogGather(vx[f], vy[f], FOG_RADIUS);
+        std::vector<float> ref(fog.bins, FOG_RADIUS);
+        auto cast = [&](const float* qx, const float* qy, int n) {
+            for (int i = 0; i < n; i++) {
+                int j = (i + 1 == n) ? 0 : i + 1;
+                float ax = qx[i] - vx[f], ay = qy[i] - vy[f], ex = qx[j] - qx[i], ey = qy[j] - qy[i];
+                for (int k = 0; k < fog.bins; k++) {
+                    float dx = fog.dirx[k], dy = fog.diry[k], den = dx * ey - dy * ex;
+                    if (den == 0) continue;
+                    float t = (ax * ey - ay * ex) / den, u = (ax * dy - ay * dx) / den;
+                    if (t > 0 && u >= 0 && u <= 1) ref[k] = std::min(ref[k], t);
+                }
+            }
+        };
+        for (int id : fogIds) {
+            int i = id & 0xFFFFFF;
+            if ((id >> 24) == SHAPE_SQUARE) {
+                const Obj& o = obstacles[i];
+                float qx[4] = { o.x - o.r, o.x + o.r, o.x + o.r, o.x - o.r }, qy[4] = { o.y - o.r, o.y - o.r, o.y + o.r, o.y + o.r };
+                cast(qx, qy, 4);
+            }
+            else if ((id >> 24) == SHAPE_BOX) { boxCorners(boxes[i], px, py); cast(px, py, 4); }
+            else cast(polys[i].px, polys[i].py, polys[i].n);
+        }
+        for (int k = 0; k < fog.bins; k++) {
+            double e = fabs(fog.dist[k] - ref[k]);
+            maxErr = std::max(maxErr, e);
+            if (e > 0.5) wrong++;
+        }
+    }
+
+    printf("%d shapes, view radius %.0f px, %d bins\n", N, FOG_RADIUS, FOG_BINS);
+    printf("%-24s %10s %12s\n", "edges from", "ms/frame", "edges used");
+    printf("%-24s %10.4f %12.0f\n", "obstacle grid", grid, (double)edges / FRAMES);
+    printf("%-24s %10.4f %12s\n", "every shape", brute, "-");
+    printf("bin tests/frame %.0f; vs exact ray cast over 20 frames: max error %.3g px, %d bins off by > 0.5 px\n",
+        (double)bins / FRAMES, maxErr, wrong);
+}
+
+// Lidar rays/sec: 4096 origins x 64 rays over 10k shapes, 3k items and a
+// sparse tile layer. Packets against one ray per packet on one thread, then
+// packets on every thread; every ray of 256 origins is checked against all
+// shapes, items and tiles within reach.
+void benchLidar() {
+    BenchGameScope keep;
+    const int N = 10000, ITEMS = 3000, ORIGINS = 4096, K = 64;
+    const float PITCH = 64.0f;
+    BenchRng rng;
+    int side = (int)ceilf(sqrtf((float)N));
+    float world = side * PITCH;
+    obstacles.clear(); boxes.clear(); polys.clear(); collectibles.clear(); powerups.clear();
+    for (int i = 0; i < N; i++) {
+        float x = (i % side + 0.5f) * PITCH + rng.uniform(-8, 8), y = (i / side + 0.5f) * PITCH + rng.uniform(-8, 8);
+        if (i % 3 == 0) { Obj o = { x, y, 18.0f, OBJ_OBSTACLE }; obstacles.push_back(o); }
+        else if (i % 3 == 1) boxes.push_back(makeEditorBox(x, y, i));
+        else polys.push_back(makeEditorPoly(x, y, i));
+    }
+    rebuildShapeBlocks();
+    obstacleGrid.init(0, 0, world, world, OBSTACLE_CELL);
+    itemGrid.init(0, 0, world, world, OBSTACLE_CELL);
+    movers.init(0, 0, world, world, MOVER_CELL);
+    reindexShapes();
+    walls.resize((int)(world / TILE_SIZE), (int)(world / TILE_SIZE), TILE_SIZE, 0, 0);
+    for (int i = 0; i < walls.cols * walls.rows / 50; i++) walls.set(rng.next() % walls.cols, rng.next() % walls.rows, true);
+    lidarArea[0] = 0; lidarArea[1] = 0; lidarArea[2] = world; lidarArea[3] = world;
+    auto freeSpot = [&](float r, float& x, float& y) {
+        do { x = rng.uniform(r, world - r); y = rng.uniform(r, world - r); }
+        while (shapeHitAt(x, y, r) >= 0 || tileCircleHits(walls, x, y, r));
+    };
+    for (int i = 0; i < ITEMS; i++) {
+        Obj o; o.r = 10; o.type = (ObjType)(OBJ_COLLECT + i % 3);
+        freeSpot(o.r, o.x, o.y);
+        (o.type == OBJ_COLLECT ? collectibles : powerups).push_back(o);
+    }
+    int tp[2] = { (int)(world / 2), (int)(world / 2) };
+    for (int* q : { target.p0, target.p1, target.p2, target.p3 }) { q[0] = tp[0]; q[1] = tp[1]; }
+
+    std::vector<float> ox(ORIGINS), oy(ORIGINS), hd(ORIGINS), dist((size_t)ORIGINS * K);
+    std::vector<uint8_t> type((size_t)ORIGINS * K);
+    for (int i = 0; i < ORIGINS; i++) { freeSpot(14, ox[i], oy[i]); hd[i] = rng.uniform(0, TWO_PI_F); }
+    double rays = (double)ORIGINS * K;
+
+    workers().setThreads(1);
+    double packed1 = benchLoop(1, 3, [&] {
+        lidarScan(ox.data(), oy.data(), hd.data(), ORIGINS, K, TWO_PI_F, LIDAR_RANGE, dist.data(), type.data());
+    }) / 1e6;
+    LidarScratch scratch;
+    double single1 = benchLoop(1, 3, [&] {
+        lidarSync();
+        RayPacket p;
+        for (int i = 0; i < ORIGINS; i++)
+            for (int k = 0; k < K; k++) {
+                float ux[4], uy[4];
+                fastSinCos(lidarAngle(hd[i], k, K, TWO_PI_F), uy[0], ux[0]);
+                for (int l = 1; l < 4; l++) { ux[l] = ux[0]; uy[l] = uy[0]; }
+                p.begin(ox[i], oy[i], ux, uy, LIDAR_RANGE);
+                lidarCastPacket(p, scratch, 1);
+                benchSink = p.t[0];
+            }
+    }) / 1e6;
+    workers().setThreads(0);
+    double packedN = benchLoop(1, 3, [&] {
+        lidarScan(ox.data(), oy.data(), hd.data(), ORIGINS, K, TWO_PI_F, LIDAR_RANGE, dist.data(), type.data());
+    }) / 1e6;
+
+    // reference: every shape, item and tile near the origin, one ray at a time
+    int distOff = 0, typeOff = 0, checked = 0;
+    for (int i = 0; i < 256; i++) {
+        float reach = LIDAR_RANGE + 40;
+        std::vector<int> near;
+        for (int j = 0; j < (int)obstacles.size(); j++) if (dist2(ox[i], oy[i], obstacles[j].x, obstacles[j].y) < reach * reach) near.push_back(shapeId(SHAPE_SQUARE, j));
+        for (int j = 0; j < (int)boxes.size(); j++) if (dist2(ox[i], oy[i], boxes[j].x, boxes[j].y) < reach * reach) near.push_back(shapeId(SHAPE_BOX, j));
+        for (int j = 0; j < (int)polys.size(); j++) if (dist2(ox[i], oy[i], polys[j].px[0], polys[j].py[0]) < reach * reach) near.push_back(shapeId(SHAPE_POLY, j));
+        float px[POLY_MAX_VERTS], py[POLY_MAX_VERTS];
+        for (int k = 0; k < K; k++) {
+            float ux[4], uy[4];
+            fastSinCos(lidarAngle(hd[i], k, K, TWO_PI_F), uy[0], ux[0]);
+            for (int l = 1; l < 4; l++) { ux[l] = ux[0]; uy[l] = uy[0]; }
+            RayPacket p;
+            p.begin(ox[i], oy[i], ux, uy, LIDAR_RANGE);
+            float bx = ux[0] > 0 ? (world - ox[i]) / ux[0] : -ox[i] / ux[0], by = uy[0] > 0 ? (world - oy[i]) / uy[0] : -oy[i] / uy[0];
+            if (std::min(bx, by) < p.t[0]) { float t = std::min(bx, by); for (int l = 0; l < 4; l++) { p.t[l] = t; p.tag[l] = LIDAR_WALL; } }
+            float ex = ox[i] + ux[0] * LIDAR_RANGE, ey = oy[i] + uy[0] * LIDAR_RANGE;
+            int c0 = std::max(0, walls.colAt(std::min(ox[i], ex))), c1 = std::min(walls.cols - 1, walls.colAt(std::max(ox[i], ex)));
+            int r0 = std::max(0, walls.rowAt(std::min(oy[i], ey))), r1 = std::min(walls.rows - 1, walls.rowAt(std::max(oy[i], ey)));
+            for (int r = r0; r <= r1; r++)
+                for (int c = c0; c <= c1; c++)
+                    if (walls.get(c, r)) rayHitBox(p, c * TILE_SIZE, r * TILE_SIZE, (c + 1) * TILE_SIZE, (r + 1) * TILE_SIZE, LIDAR_WALL);
+            for (int id : near) {
+                int j = id & 0xFFFFFF;
+                if ((id >> 24) == SHAPE_SQUARE) { const Obj& o = obstacles[j]; rayHitBox(p, o.x - o.r, o.y - o.r, o.x + o.r, o.y + o.r, LIDAR_OBSTACLE); }
+                else if ((id >> 24) == SHAPE_BOX) { boxCorners(boxes[j], px, py); rayHitConvex(p, px, py, 4, LIDAR_OBSTACLE); }
+                else rayHitConvex(p, polys[j].px, polys[j].py, polys[j].n, LIDAR_OBSTACLE);
+            }
+            for (const auto& c : collectibles) rayHitCircle(p, c.x, c.y, c.r, LIDAR_COLLECT);
+            for (const auto& c : powerups) rayHitCircle(p, c.x, c.y, c.r, lidarPowerup(c));
+            rayHitCircle(p, (float)tp[0], (float)tp[1], target.r, LIDAR_TARGET);
+            size_t o = (size_t)i * K + k;
+            float d = dist[o];
+            if (fabsf(d - p.t[0]) > 1e-3f) distOff++;
+            else if (type[o] != (p.tag[0] < 0 ? LIDAR_NONE : p.tag[0])) typeOff++;
+            checked++;
+        }
+    }
+
+    printf("%d shapes, %d items, %d wall tiles; %d origins x %d rays, range %.0f px\n",
+        N, ITEMS, walls.count(), ORIGINS, K, LIDAR_RANGE);
+    printf("%-28s %10s %12s\n", "", "ms/scan", "Mrays/s");
+    printf("%-28s %10.2f %12.2f\n", "1 ray per packet, 1 thread", single1, rays / single1 * 1e-3);
+    printf("%-28s %10.2f %12.2f\n", "packets of 4, 1 thread", packed1, rays / packed1 * 1e-3);
+    printf("%-28s %10.2f %12.2f\n", "packets of 4, all threads", packedN, rays / packedN * 1e-3);
+    printf("vs every candidate in reach: %d of %d rays off in distance, %d in kind\n", distOff, checked, typeOff);
+}
+
+// The batch benchmarks' level (maze, 60 shapes, 60 items) and worlds spread
+// over it with random positions, target phases and items taken; built
+// through the editor's globals, so callers hold a BenchGameScope
+const int BENCH_ENV_SHAPES = 60, BENCH_ENV_ITEMS = 60;
+
+void benchEnvSetup(EnvLevel& L, EnvBatch& B, int worlds) {
+    BenchRng rng;
+    walls.resize((int)(W / TILE_SIZE), (int)((GAME_Y1 - GAME_Y0) / TILE_SIZE), TILE_SIZE, 0, (float)GAME_Y0);
+    tileMaze(walls, MAZE_PITCH, 7);
+    obstacles.clear(); boxes.clear(); polys.clear(); collectibles.clear(); powerups.clear();
+    for (int i = 0; i < BENCH_ENV_SHAPES + BENCH_ENV_ITEMS; i++) {
+        float x = rng.uniform(20, W - 20), y = rng.uniform(GAME_Y0 + 20.0f, GAME_Y1 - 20.0f);
+        if (i >= BENCH_ENV_SHAPES) { Obj o = { x, y, 10.0f, (ObjType)(OBJ_COLLECT + i % 3) }; (i % 3 ? powerups : collectibles).push_back(o); }
+        else if (i % 3 == 0) { Obj o = { x, y, 14.0f, OBJ_OBSTACLE }; obstacles.push_back(o); }
+        else if (i % 3 == 1) boxes.push_back(makeEditorBox(x, y, i));
+        else polys.push_back(makeEditorPoly(x, y, i));
+    }
+    resetTarget();
+    levelFromEditor(L);
+    B.resize(L, worlds);
+    for (int w = 0; w < worlds; w++) {
+        B.reset(L, w, rules.maxLives);
+        B.px[w] = rng.uniform(L.x0, L.x1); B.py[w] = rng.uniform(L.y0, L.y1);
+        B.targetT[w] = rng.uniform(0, 1);
+        for (int k = 0; k < L.items(); k++) if (rng.next() % 2) B.takeItem(w, k);
+    }
+}
+
+// Observations/sec for 4096 worlds of the batch level at OBS_SIZE: the cached
+// static layer on 1 thread and on all, against redrawing the static layer
+// for every world
+void benchObs() {
+    const int WORLDS = 4096;
+    BenchGameScope keep;
+    EnvLevel L;
+    EnvBatch B;
+    benchEnvSetup(L, B, WORLDS);
+
+    ObsRenderer R;
+    double buildMs = benchLoop(1, 5, [&] { R.build(L, OBS_SIZE); }) / 1e6;
+    std::vector<uint8_t> obs((size_t)WORLDS * OBS_SIZE * OBS_SIZE);
+    workers().setThreads(1);
+    double one = benchLoop(WORLDS, 5, [&] { R.renderAll(L, B, obs.data()); });
+    workers().setThreads(0);
+    double all = benchLoop(WORLDS, 5, [&] { R.renderAll(L, B, obs.data()); });
+    ObsRenderer fresh;
+    const int NAIVE = 64;
+    double naive = benchLoop(NAIVE, 1, [&] {
+        for (int w = 0; w < NAIVE; w++) { fresh.build(L, OBS_SIZE); fresh.render(L, B, w, obs.data() + (size_t)w * OBS_SIZE * OBS_SIZE); }
+    });
+    uint64_t sum = 0;
+    for (uint8_t v : obs) sum += v;
+    benchSink = (float)sum;
+
+    printf("%d worlds, %dx%d gray obs; %d wall tiles, %d shapes, %d items; static layer %.3f ms\n",
+        WORLDS, OBS_SIZE, OBS_SIZE, walls.count(), BENCH_ENV_SHAPES, BENCH_ENV_ITEMS, buildMs);
+    printf("%-30s %10s %12s %10s\n", "", "us/obs", "obs/s", "MB/s");
+    auto row = [&](const char* name, double ns) {
+        printf("%-30s %10.3f %12.0f %10.0f\n", name, ns * 1e-3, 1e9 / ns, 1e3 * OBS_SIZE * OBS_SIZE / ns);
+    };
+    row("static layer per world", naive);
+    row("cached static layer, 1 thread", one);
+    char name[48]; sprintf(name, "cached, %d threads", workers().size());
+    row(name, all);
+}
+
+// World-steps/sec on 1 thread, step() per world against stepLanes() on 8
+// at a time, simulation only (repeat 1 and 4) and with observations; both
+// paths are replayed from the same worlds and actions and must agree exactly
+void benchLanes() {
+    const int WORLDS = 4096, STEPS = 64;
+    BenchGameScope keep;
+    EnvSet E;
+    benchEnvSetup(E.level, E.batch, WORLDS);
+    E.view.build(E.level, OBS_SIZE);
+    E.actions.assign(WORLDS, 0);
+    E.obs.assign((size_t)WORLDS * OBS_SIZE * OBS_SIZE, 0);
+    E.rewards.assign(WORLDS, 0.0f);
+    const EnvBatch start = E.batch;
+    BenchRng rng;
+    std::vector<uint8_t> acts((size_t)WORLDS * STEPS);
+    for (auto& a : acts) a = (uint8_t)(rng.next() % 9);
+    std::vector<float> rew(WORLDS);
+    workers().setThreads(1);
+
+    // Runs STEPS steps from `start` on one path; returns ns per world-step
+    auto sim = [&](bool lanes, int repeat, EnvBatch& B) {
+        EnvRules R = E.rules;
+        R.repeat = repeat;
+        B = start;
+        double t0 = benchNowMs();
+        for (int s = 0; s < STEPS; s++) {
+            const uint8_t* a = &acts[(size_t)s * WORLDS];
+            if (lanes) for (int w = 0; w < WORLDS; w += 8) B.stepLanes(E.level, R, w, a + w, &rew[w]);
+            else for (int w = 0; w < WORLDS; w++) rew[w] = B.step(E.level, R, w, a[w]);
+        }
+        return (benchNowMs() - t0) * 1e6 / ((double)WORLDS * STEPS);
+    };
+    auto same = [&](const EnvBatch& a, const EnvBatch& b) {
+        return a.px == b.px && a.py == b.py && a.angle == b.angle && a.targetT == b.targetT && a.targetDir == b.targetDir &&
+               a.time == b.time && a.shieldUntil == b.shieldUntil && a.speedUntil == b.speedUntil && a.nextHit == b.nextHit &&
+               a.lives == b.lives && a.score == b.score && a.done == b.done && a.itemsLeft == b.itemsLeft;
+    };
+    auto full = [&](bool lanes) {
+        E.lockstep = lanes;
+        E.batch = start;
+        double t0 = benchNowMs();
+        for (int s = 0; s < STEPS; s++) {
+            memcpy(E.actions.data(), &acts[(size_t)s * WORLDS], WORLDS);
+            E.stepAll();
+        }
+        return (benchNowMs() - t0) * 1e6 / ((double)WORLDS * STEPS);
+    };
+
+    EnvBatch a, b;
+    printf("%d worlds x %d steps, random actions, 1 thread\n", WORLDS, STEPS);
+    printf("%-26s %12s %12s %12s %8s\n", "", "scalar/s", "8 lanes/s", "speedup", "same");
+    for (int repeat : { 1, 4 }) {
+        double ns1 = 1e30, ns8 = 1e30;
+        for (int k = 0; k < 3; k++) { ns1 = std::min(ns1, sim(false, repeat, a)); ns8 = std::min(ns8, sim(true, repeat, b)); }
+        char name[48]; sprintf(name, "simulation, repeat %d", repeat);
+        printf("%-26s %12.0f %12.0f %11.2fx %8s\n", name, 1e9 / ns1, 1e9 / ns8, ns1 / ns8, same(a, b) ? "yes" : "NO");
+    }
+    double ns1 = full(false);
+    std::vector<uint8_t> obs1 = E.obs;
+    EnvBatch scalarEnd = E.batch;
+    double ns8 = full(true);
+    bool ok = same(scalarEnd, E.batch) && obs1 == E.obs;
+    printf("%-26s %12.0f %12.0f %11.2fx %8s\n", "with obs, repeat 1", 1e9 / ns1, 1e9 / ns8, ns1 / ns8, ok ? "yes" : "NO");
+    workers().setThreads(0);
+}
+
+// Power-up spawn positions as the game area fills with placed objects: the
+// free-space index against rejection sampling with overlapsAny's tests
+void benchSpawn() {
+    const int SAMPLES = 20000;
+    const float SHARES[] = { 0.5f, 0.8f, 0.95f, 0.99f };
+    BenchGameScope keep;
+    walls.resize((int)(W / TILE_SIZE), (int)((GAME_Y1 - GAME_Y0) / TILE_SIZE), TILE_SIZE, 0, (float)GAME_Y0);
+    walls.clear();
+    obstacles.clear(); collectibles.clear(); powerups.clear(); boxes.clear(); polys.clear();
+    rebuildShapeBlocks();
+    float r2 = (SPAWN_R + PLACE_MIN_DIST) * (SPAWN_R + PLACE_MIN_DIST);
+    auto blocked = [&](float x, float y) { return spawnSolidAt(x, y, 0) || anyWithin(collectibles, x, y, r2); };
+    BenchRng rng;
+    rebuildSpawnSpace();
+    int cells = spawnSpace.cols * spawnSpace.rows;
+    printf("%-8s %8s %14s %10s %14s %12s %8s\n", "taken", "objects", "rejection ns", "tries", "index ns", "update ns", "valid");
+    for (float share : SHARES) {
+        // items at index samples until the share of taken cells is reached
+        while (spawnSpace.freeCount() > cells * (1 - share)) {
+            float x, y;
+            if (!spawnSpace.sample(rng.s, x, y)) break;
+            Obj o = { x, y, SPAWN_R, OBJ_COLLECT };
+            collectibles.push_back(o);
+            spawnCover(o, 1);
+        }
+        long long tries = 0;
+        double rej = benchLoop(SAMPLES, 1, [&] {
+            for (int i = 0; i < SAMPLES; i++) {
+                float x, y;
+                do { x = rng.uniform(0, (float)W); y = rng.uniform((float)GAME_Y0, (float)GAME_Y1); tries++; } while (blocked(x, y) && tries < 1000000000LL);
+                benchSink = x + y;
+            }
+        });
+        std::vector<float> xs(SAMPLES), ys(SAMPLES);
+        double idx = benchLoop(SAMPLES, 1, [&] { for (int i = 0; i < SAMPLES; i++) spawnSpace.sample(rng.s, xs[i], ys[i]); });
+        bool ok = true;
+        for (int i = 0; i < SAMPLES && ok; i++) ok = !blocked(xs[i], ys[i]);
+        double upd = benchLoop(2 * (int)collectibles.size(), 1, [&] {
+            for (const auto& c : collectibles) { spawnCover(c, -1); spawnCover(c, 1); }
+        });
+        printf("%7.0f%% %8d %14.0f %10.1f %14.1f %12.0f %8s\n", 100.0f * (1 - (float)spawnSpace.freeCount() / cells), (int)collectibles.size(),
+               rej, (double)tries / SAMPLES, idx, upd, ok ? "yes" : "NO");
+    }
+}
+
+// Magnet over 100k collectibles: the ship crosses the field pulling for
+// TICKS ticks. Indexed pull and pickup (updateMagnet, collectiblesNear, with
+// the spawn index kept too) against scanning every collectible per tick; both
+// must end with the same collectibles, and the grid must match their ranges.
+void benchMagnet() {
+    const int N = 100000, TICKS = 600;
+    const float PITCH = 20.0f, DT = 1.0f / 60;
+    BenchGameScope keep;
+    int side = (int)ceilf(sqrtf((float)N));
+    float world = side * PITCH;
+    BenchRng rng;
+    std::vector<Obj> start(N);
+    for (auto& c : start) { c.x = rng.uniform(0, world); c.y = rng.uniform(0, world); c.r = 14; c.type = OBJ_COLLECT; }
+    auto shipAt = [&](int t, float& x, float& y) { x = world * 0.1f + t * rules.speed * DT; y = world * 0.3f + t * rules.speed * 0.5f * DT; };
+
+    pickupGrid.init(0, 0, world, world, PICKUP_CELL);
+    spawnSpace.init(0, 0, world, world, SPAWN_CELL);
+    collectibles = start;
+    indexCollectibles();
+    for (const auto& c : collectibles) spawnCover(c, 1);
+    timeSec = 0;
+    player.magnetUntil = 1e30f;
+    long long pulled = 0;
+    int picked = 0;
+    double t0 = benchNowMs();
+    for (int t = 0; t < TICKS; t++) {
+        shipAt(t, player.x, player.y);
+        updateMagnet(DT);
+        pulled += (long long)pickupIds.size();
+        collectiblesNear(player.x, player.y, player.r, pickupIds);
+        std::sort(pickupIds.begin(), pickupIds.end(), [](int a, int b) { return a > b; });
+        for (int i : pickupIds) { removeCollectible(i); picked++; }
+    }
+    double idxMs = (benchNowMs() - t0) / TICKS;
+
+    std::vector<Obj> v = start;
+    t0 = benchNowMs();
+    for (int t = 0; t < TICKS; t++) {
+        float px, py; shipAt(t, px, py);
+        float step = MAGNET_PULL * DT;
+        for (auto& c : v) {
+            if (dist2(px, py, c.x, c.y) >= (MAGNET_RADIUS + c.r) * (MAGNET_RADIUS + c.r)) continue;
+            float dx = px - c.x, dy = py - c.y, d = sqrtf(dx * dx + dy * dy);
+            float k = d > step ? step / d : 1.0f;
+            c.x += dx * k; c.y += dy * k;
+        }
+        for (int i = (int)v.size() - 1; i >= 0; i--)
+            if (dist2(px, py, v[i].x, v[i].y) < (player.r + v[i].r) * (player.r + v[i].r)) { v[i] = v.back(); v.pop_back(); }
+    }
+    double scanMs = (benchNowMs() - t0) / TICKS;
+
+    auto byPos = [](const Obj& a, const Obj& b) { return a.x != b.x ? a.x < b.x : a.y < b.y; };
+    std::vector<Obj> a = collectibles;
+    std::sort(a.begin(), a.end(), byPos); std::sort(v.begin(), v.end(), byPos);
+    bool ok = a.size() == v.size();
+    for (size_t i = 0; ok && i < a.size(); i++) ok = a[i].x == v[i].x && a[i].y == v[i].y;
+    size_t entries = 0, expect = 0;
+    for (const auto& c : pickupGrid.cells) entries += c.size();
+    for (int i = 0; ok && i < (int)collectibles.size(); i++) {
+        const CellRange& cr = collectCells[i];
+        ok = cr == collectRange(collectibles[i]);
+        expect += (size_t)(cr.c1 - cr.c0 + 1) * (cr.r1 - cr.r0 + 1);
+        const std::vector<int>& cell = pickupGrid.at(cr.c0, cr.r0);
+        ok = ok && std::find(cell.begin(), cell.end(), i) != cell.end();
+    }
+    ok = ok && entries == expect;
+    printf("%d collectibles, %d ticks, radius %.0f px: %.0f pulled per tick, %d picked up\n", N, TICKS, MAGNET_RADIUS, (double)pulled / TICKS, picked);
+    printf("%-28s %10s\n", "", "ms/tick");
+    printf("%-28s %10.3f\n", "scan every collectible", scanMs);
+    printf("%-28s %10.3f  %.0fx, same result: %s\n", "grid query + cell moves", idxMs, scanMs / idxMs, ok ? "yes" : "NO");
+}
@@ -0,0 +1,241 @@
+// ====== Boids swarm ======
+// Enemies that flock (alignment, cohesion, separation), chase a point and
+// steer around avoid-circles (the placed obstacles).
+//
+// Neighbor search is a cell list rebuilt every tick by counting sort: bin
+// counts, prefix sum, scatter. Cells are the neighbor radius, so a query
+// scans 3x3 cells, and because cells are numbered row-major the three cells
+// of a row are one contiguous range of the sorted list. The state is gathered
+// into cell order before the update and stays in that order, so neighbor
+// reads are sequential and the update can write slot k in place of slot k
+// from many threads (parallelFor) without sharing anything.
+
+#pragma once
+#include "Math2D.h"
+#include "TileMap.h"
+#include "Parallel.h"
+#include <vector>
+#include <atomic>
+
+struct CellList {
+    float x0 = 0, y0 = 0, cell = 1, inv = 1;
+    int cols = 0, rows = 0;
+    std::vector<int> start;    // cols*rows + 1 offsets into order
+    std::vector<int> cellOf;   // per item
+    std::vector<int> order;    // item ids grouped by cell, row-major
+    std::vector<int> cursor;   // scatter positions (scratch)
+
+    void init(float ox, float oy, float w, float h, float cellSize) {
+        x0 = ox; y0 = oy; cell = cellSize; inv = 1.0f / cellSize;
+        cols = std::max(1, (int)ceilf(w * inv));
+        rows = std::max(1, (int)ceilf(h * inv));
+        start.assign((size_t)cols * rows + 1, 0);
+    }
+    // truncation equals floor once clamped at 0 (and avoids a libm call)
+    int col(float x) const { return std::max(0, std::min(cols - 1, (int)((x - x0) * inv))); }
+    int row(float y) const { return std::max(0, std::min(rows - 1, (int)((y - y0) * inv))); }
+
+    void build(const float* x, const float* y, int n) {
+        cellOf.resize(n); order.resize(n);
+        std::fill(start.begin(), start.end(), 0);
+        for (int i = 0; i < n; i++) {
+            int c = row(y[i]) * cols + col(x[i]);
+            cellOf[i] = c;
+            start[c + 1]++;
+        }
+        for (size_t c = 1; c < start.size(); c++) start[c] += start[c - 1];
+        cursor.assign(start.begin(), start.end() - 1);
+        for (int i = 0; i < n; i++) order[cursor[cellOf[i]]++] = i;
+    }
+
+    // Sorted range covering columns c0..c1 of row r
+    int rangeBegin(int r, int c0) const { return start[r * cols + c0]; }
+    int rangeEnd(int r, int c1) const { return start[r * cols + c1 + 1]; }
+};
+
+struct BoidSwarm {
+    // tuning (px, seconds)
+    float radius = 40.0f;        // neighbor radius = cell size
+    float sepRadius = 16.0f;
+    float minSpeed = 40.0f, maxSpeed = 150.0f;
+    float wAlign = 1.5f, wCohesion = 0.8f, wSeparation = 3.0f, wChase = 1.2f, wAvoid = 6.0f;
+    float avoidMargin = 24.0f;
+    int   maxNeighbors = 16;     // no further rows are scanned once this many are found
+
+    std::vector<float> x, y, vx, vy;        // state, in cell order after step()
+    std::vector<float> sx, sy, svx, svy;    // gathered copies the update reads
+    int count = 0;
+    float fx0 = 0, fy0 = 0, fx1 = 0, fy1 = 0;   // field; boids bounce off its edges
+    CellList cells;
+
+    // avoid circles, binned once per setAvoid
+    std::vector<float> ax, ay, ar;
+    CellList avoidCells;
+    float avoidMaxR = 0;
+
+    long long lastNeighbors = 0;   // neighbors used by the last step (stats)
+
+    void init(float ox, float oy, float w, float h) {
+        fx0 = ox; fy0 = oy; fx1 = ox + w; fy1 = oy + h;
+        cells.init(ox, oy, w, h, radius);
+        avoidCells.init(ox, oy, w, h, radius);
+        clear();
+    }
+    void clear() {
+        for (auto* v : { &x, &y, &vx, &vy }) v->clear();
+        count = 0;
+    }
+    void add(float px, float py, float pvx, float pvy) {
+        x.push_back(px); y.push_back(py); vx.push_back(pvx); vy.push_back(pvy);
+        count++;
+    }
+
+    void setAvoid(const float* cx, const float* cy, const float* r, int n) {
+        ax.assign(cx, cx + n); ay.assign(cy, cy + n); ar.assign(r, r + n);
+        avoidMaxR = 0;
+        for (int i = 0; i < n; i++) avoidMaxR = std::max(avoidMaxR, r[i]);
+        avoidCells.build(ax.data(), ay.data(), n);
+        // keep avoid data in cell order so queries index it directly
+        std::vector<float> tx(n), ty(n), tr(n);
+        for (int k = 0; k < n; k++) { int i = avoidCells.order[k]; tx[k] = ax[i]; ty[k] = ay[i]; tr[k] = ar[i]; }
+        ax.swap(tx); ay.swap(ty); ar.swap(tr);
+    }
+
+    // Drop the avoid circle centered at (cx, cy) without rebinning: only its
+    // cell is searched, and a radius of -avoidMargin makes avoid() skip it
+    bool removeAvoid(float cx, float cy) {
+        if (ax.empty()) return false;
+        int c = avoidCells.col(cx), row = avoidCells.row(cy);
+        for (int j = avoidCells.rangeBegin(row, c), je = avoidCells.rangeEnd(row, c); j < je; j++)
+            if (ax[j] == cx && ay[j] == cy && ar[j] > -avoidMargin) { ar[j] = -avoidMargin; return true; }
+        return false;
+    }
+
+    // One tick: rebuild the cell list, gather, update in parallel.
+    // (tx, ty): chase point; walls: boids bounce off solid tiles (may be empty),
+    // but one that starts inside a wall may leave it.
+    void step(float dt, float tx, float ty, const TileMap& walls) {
+        cells.build(x.data(), y.data(), count);
+        // +3 far-away pad entries for the masked block loads in update()
+        sx.assign(count + 3, 1e15f); sy.assign(count + 3, 1e15f); svx.assign(count + 3, 0.0f); svy.assign(count + 3, 0.0f);
+        for (int k = 0; k < count; k++) {
+            int i = cells.order[k];
+            sx[k] = x[i]; sy[k] = y[i]; svx[k] = vx[i]; svy[k] = vy[i];
+        }
+        std::atomic<long long> used{ 0 };
+        bool tiles = walls.rows > 0 && walls.count() > 0;
+        parallelFor(count, 1024, [&](int b, int e) {
+            long long u = 0;
+            for (int k = b; k < e; k++) u += update(k, dt, tx, ty, walls, tiles);
+            used += u;
+        });
+        lastNeighbors = used;
+    }
+
+    // Returns neighbors used
+    int update(int k, float dt, float tx, float ty, const TileMap& walls, bool tiles) {
+        float px = sx[k], py = sy[k], pvx = svx[k], pvy = svy[k];
+        float r2 = radius * radius, s2 = sepRadius * sepRadius;
+        int c = cells.col(px), r = cells.row(py);
+        int c0 = std::max(c - 1, 0), c1 = std::min(c + 1, cells.cols - 1);
+        int r0 = std::max(r - 1, 0), r1 = std::min(r + 1, cells.rows - 1);
+
+        float n = 0, avx = 0, avy = 0, cx = 0, cy = 0, sepx = 0, sepy = 0;
+#ifdef MATH2D_SSE
+        // whole blocks of four; lanes past the range end are masked off (the
+        // arrays are padded, so the load stays in bounds)
+        float4 qx = f4(px), qy = f4(py), vr2 = f4(r2), vs2 = f4(s2), zero = f4(0), one = f4(1);
+        float4 lane = f4(0, 1, 2, 3);
+        float4 an = zero, avx4 = zero, avy4 = zero, cx4 = zero, cy4 = zero, spx = zero, spy = zero;
+        for (int row = r0; row <= r1; row++) {
+            int j = cells.rangeBegin(row, c0), je = cells.rangeEnd(row, c1);
+            float4 end = f4((float)je);
+            for (; j < je; j += 4) {
+                float4 dx = load4(&sx[j]) - qx, dy = load4(&sy[j]) - qy;
+                float4 d2 = dx * dx + dy * dy;
+                float4 m = and4(and4(lt4(d2, vr2), gt4(d2, zero)), lt4(lane + f4((float)j), end));
+                an = an + and4(m, one);
+                avx4 = avx4 + and4(m, load4(&svx[j])); avy4 = avy4 + and4(m, load4(&svy[j]));
+                cx4 = cx4 + and4(m, dx); cy4 = cy4 + and4(m, dy);
+                float4 w = and4(and4(m, lt4(d2, vs2)), one / max4(d2, f4(1e-3f)));
+                spx = spx - dx * w; spy = spy - dy * w;
+            }
+            if (hsum4(an) >= maxNeighbors) break;
+        }
+        n = hsum4(an); avx = hsum4(avx4); avy = hsum4(avy4);
+        cx = hsum4(cx4); cy = hsum4(cy4); sepx = hsum4(spx); sepy = hsum4(spy);
+#else
+        for (int row = r0; row <= r1 && n < maxNeighbors; row++) {
+            for (int j = cells.rangeBegin(row, c0), je = cells.rangeEnd(row, c1); j < je; j++) {
+                float dx = sx[j] - px, dy = sy[j] - py, d2 = dx * dx + dy * dy;
+                if (d2 >= r2 || d2 <= 0) continue;
+                n++; avx += svx[j]; avy += svy[j]; cx += dx; cy += dy;
+                if (d2 < s2) { sepx -= dx / d2; sepy -= dy / d2; }
+            }
+        }
+#endif
+
+        float accx = 0, accy = 0;
+        if (n > 0) {
+            float in = 1.0f / n;
+            accx += wAlign * (avx * in - pvx) + wCohesion * cx * in;
+            accy += wAlign * (avy * in - pvy) + wCohesion * cy * in;
+            accx += wSeparation * maxSpeed * sepRadius * sepx;
+            accy += wSeparation * maxSpeed * sepRadius * sepy;
+        }
+        float dx = tx - px, dy = ty - py, d = sqrtf(dx * dx + dy * dy);
+        if (d > 1) {
+            accx += wChase * (dx / d * maxSpeed - pvx);
+            accy += wChase * (dy / d * maxSpeed - pvy);
+        }
+        avoid(px, py, accx, accy);
+
+        float nvx = pvx + accx * dt, nvy = pvy + accy * dt;
+        float sp = sqrtf(nvx * nvx + nvy * nvy);
+        if (sp > maxSpeed) { nvx *= maxSpeed / sp; nvy *= maxSpeed / sp; }
+        else if (sp < minSpeed && sp > 0) { nvx *= minSpeed / sp; nvy *= minSpeed / sp; }
+        float nx = px + nvx * dt, ny = py + nvy * dt;
+
+        // field edges and wall tiles bounce
+        if (nx < fx0 || nx > fx1) { nvx = -nvx; nx = px; }
+        if (ny < fy0 || ny > fy1) { nvy = -nvy; ny = py; }
+        if (tiles && solidAt(walls, nx, ny) && !solidAt(walls, px, py)) { nx = px; ny = py; nvx = -nvx; nvy = -nvy; }
+        x[k] = nx; y[k] = ny; vx[k] = nvx; vy[k] = nvy;
+        return (int)n;
+    }
+
+    static bool solidAt(const TileMap& tm, float px, float py) {
+        int c = tm.colAt(px), r = tm.rowAt(py);
+        return tm.inside(c, r) && tm.get(c, r);
+    }
+
+    // Push away from avoid circles within their radius + avoidMargin
+    void avoid(float px, float py, float& accx, float& accy) const {
+        if (ax.empty()) return;
+        float reach = avoidMaxR + avoidMargin;
+        const CellList& g = avoidCells;
+        int c0 = g.col(px - reach), c1 = g.col(px + reach), r0 = g.row(py - reach), r1 = g.row(py + reach);
+        for (int row = r0; row <= r1; row++)
+            for (int j = g.rangeBegin(row, c0), je = g.rangeEnd(row, c1); j < je; j++) {
+                float dx = px - ax[j], dy = py - ay[j], d = sqrtf(dx * dx + dy * dy);
+                float edge = ar[j] + avoidMargin;
+                if (d >= edge || d <= 0) continue;
+                float s = wAvoid * maxSpeed * (1.0f - (d - ar[j]) / avoidMargin) / d;
+                accx += dx * s; accy += dy * s;
+            }
+    }
+
+    // Any boid center within r of (qx, qy); uses the last step's cell list,
+    // so r plus one tick of movement must stay under a cell
+    bool anyWithin(float qx, float qy, float r) const {
+        if (count == 0 || (int)cells.order.size() != count) return false;
+        int c0 = cells.col(qx - r) - 1, c1 = cells.col(qx + r) + 1;
+        int r0 = cells.row(qy - r) - 1, r1 = cells.row(qy + r) + 1;
+        c0 = std::max(c0, 0); c1 = std::min(c1, cells.cols - 1);
+        r0 = std::max(r0, 0); r1 = std::min(r1, cells.rows - 1);
+        for (int row = r0; row <= r1; row++)
+            for (int j = cells.rangeBegin(row, c0), je = cells.rangeEnd(row, c1); j < je; j++)
+                if (dist2(qx, qy, x[j], y[j]) < r * r) return true;
+        return false;
+    }
+};
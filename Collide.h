@@ -0,0 +1,233 @@
+// ====== Shape-pair collision matrix ======
+// Narrow phase for mixed shape kinds without a type switch per pair.
+// Candidate pairs are appended to the batch of their (kind A, kind B) cell;
+// run() walks the matrix cells at compile time and hands each non-empty batch
+// to PairKernel<A, B>, a static, inlinable kernel that tests four pairs per
+// step. The only runtime dispatch left is one emptiness check per cell.
+//
+// Pairs are stored with A <= B, so circles are always the A side. Kinds with
+// no kernel (e.g. square vs box) never report a hit; add<A, B>() rejects them
+// at compile time.
+
+#pragma once
+#include "Math2D.h"
+#include "Convex2D.h"
+#include <stdint.h>
+#include <vector>
+#include <utility>
+
+enum ShapeKind { SHAPE_CIRCLE = 0, SHAPE_SQUARE = 1, SHAPE_BOX = 2, SHAPE_POLY = 3, SHAPE_KINDS = 4 };
+
+// Where kernels read shapes from. Circles are SoA and filled by the caller;
+// squares view any {x, y, r} array (Obj, half size in r); boxes and polygons
+// view the SoA blocks from Convex2D.h (shape j = block j/4, lane j%4).
+template <class SquareT>
+struct ShapeTables {
+    std::vector<float> cx, cy, cr;
+    const SquareT* squares = nullptr;
+    const BoxBlock* boxes = nullptr;
+    const PolyBlock* polys = nullptr;
+
+    int addCircle(float x, float y, float r) {
+        cx.push_back(x); cy.push_back(y); cr.push_back(r);
+        return (int)cx.size() - 1;
+    }
+    void clearCircles() { cx.clear(); cy.clear(); cr.clear(); }
+};
+
+// Candidate pairs of one kind pair and their results (hit[k] for pair k)
+struct PairBatch {
+    std::vector<int> a, b;
+    std::vector<uint8_t> hit;
+    int size() const { return (int)a.size(); }
+};
+
+// ---------------- kernels ----------------
+template <ShapeKind A, ShapeKind B>
+struct PairKernel {
+    static const bool supported = false;
+    template <class T> static void run(const T&, PairBatch&, int) {}
+};
+
+#ifdef MATH2D_SSE
+#define COLLIDE_GATHER(arr, idx, k) f4(arr[idx[k]], arr[idx[k + 1]], arr[idx[k + 2]], arr[idx[k + 3]])
+#define COLLIDE_GATHER_F(arr, f, idx, k) f4(arr[idx[k]].f, arr[idx[k + 1]].f, arr[idx[k + 2]].f, arr[idx[k + 3]].f)
+#define COLLIDE_GATHER_L(blk, f, idx, k) f4(blk[idx[k] >> 2].f[idx[k] & 3], blk[idx[k + 1] >> 2].f[idx[k + 1] & 3], \
+                                            blk[idx[k + 2] >> 2].f[idx[k + 2] & 3], blk[idx[k + 3] >> 2].f[idx[k + 3] & 3])
+
+inline void storeHits(uint8_t* hit, int m) {
+    hit[0] = m & 1; hit[1] = (m >> 1) & 1; hit[2] = (m >> 2) & 1; hit[3] = (m >> 3) & 1;
+}
+#endif
+
+// n is a multiple of 4 (run() pads the batch)
+template <>
+struct PairKernel<SHAPE_CIRCLE, SHAPE_CIRCLE> {
+    static const bool supported = true;
+    template <class T> static void run(const T& t, PairBatch& pb, int n) {
+        const int* a = pb.a.data(); const int* b = pb.b.data();
+#ifdef MATH2D_SSE
+        for (int k = 0; k < n; k += 4) {
+            float4 rr = COLLIDE_GATHER(t.cr, a, k) + COLLIDE_GATHER(t.cr, b, k);
+            float4 d = dist2_4(COLLIDE_GATHER(t.cx, a, k), COLLIDE_GATHER(t.cy, a, k),
+                               COLLIDE_GATHER(t.cx, b, k), COLLIDE_GATHER(t.cy, b, k));
+            storeHits(&pb.hit[k], mask4(le4(d, rr * rr)));   // touching counts, as intersectCircleCircle
+        }
+#else
+        for (int k = 0; k < n; k++)
+            pb.hit[k] = intersectCircleCircle(t.cx[a[k]], t.cy[a[k]], t.cr[a[k]], t.cx[b[k]], t.cy[b[k]], t.cr[b[k]]);
+#endif
+    }
+};
+
+template <>
+struct PairKernel<SHAPE_CIRCLE, SHAPE_SQUARE> {
+    static const bool supported = true;
+    template <class T> static void run(const T& t, PairBatch& pb, int n) {
+        const int* a = pb.a.data(); const int* b = pb.b.data();
+        const auto* sq = t.squares;
+#ifdef MATH2D_SSE
+        for (int k = 0; k < n; k += 4) {
+            float4 px = COLLIDE_GATHER(t.cx, a, k), py = COLLIDE_GATHER(t.cy, a, k), r = COLLIDE_GATHER(t.cr, a, k);
+            float4 ox = COLLIDE_GATHER_F(sq, x, b, k), oy = COLLIDE_GATHER_F(sq, y, b, k), oh = COLLIDE_GATHER_F(sq, r, b, k);
+            float4 qx = clamp4(px, ox - oh, ox + oh), qy = clamp4(py, oy - oh, oy + oh);
+            storeHits(&pb.hit[k], mask4(lt4(dist2_4(px, py, qx, qy), r * r)));
+        }
+#else
+        for (int k = 0; k < n; k++) {
+            float x = t.cx[a[k]], y = t.cy[a[k]], r = t.cr[a[k]];
+            const auto& o = sq[b[k]];
+            float qx = clampf(x, o.x - o.r, o.x + o.r), qy = clampf(y, o.y - o.r, o.y + o.r);
+            pb.hit[k] = dist2(x, y, qx, qy) < r * r;
+        }
+#endif
+    }
+};
+
+template <>
+struct PairKernel<SHAPE_CIRCLE, SHAPE_BOX> {
+    static const bool supported = true;
+    template <class T> static void run(const T& t, PairBatch& pb, int n) {
+        const int* a = pb.a.data(); const int* b = pb.b.data();
+        const BoxBlock* bx = t.boxes;
+#ifdef MATH2D_SSE
+        for (int k = 0; k < n; k += 4) {
+            float4 r = COLLIDE_GATHER(t.cr, a, k);
+            float4 dx = COLLIDE_GATHER(t.cx, a, k) - COLLIDE_GATHER_L(bx, cx, b, k);
+            float4 dy = COLLIDE_GATHER(t.cy, a, k) - COLLIDE_GATHER_L(bx, cy, b, k);
+            float4 cs = COLLIDE_GATHER_L(bx, cs, b, k), sn = COLLIDE_GATHER_L(bx, sn, b, k);
+            float4 hx = COLLIDE_GATHER_L(bx, hx, b, k), hy = COLLIDE_GATHER_L(bx, hy, b, k);
+            float4 lx = dx * cs + dy * sn, ly = dy * cs - dx * sn;
+            float4 qx = clamp4(lx, f4(0) - hx, hx), qy = clamp4(ly, f4(0) - hy, hy);
+            storeHits(&pb.hit[k], mask4(lt4(dist2_4(lx, ly, qx, qy), r * r)));
+        }
+#else
+        for (int k = 0; k < n; k++) {
+            const BoxBlock& o = bx[b[k] >> 2]; int l = b[k] & 3;
+            float dx = t.cx[a[k]] - o.cx[l], dy = t.cy[a[k]] - o.cy[l], r = t.cr[a[k]];
+            float lx = dx * o.cs[l] + dy * o.sn[l], ly = dy * o.cs[l] - dx * o.sn[l];
+            float qx = clampf(lx, -o.hx[l], o.hx[l]), qy = clampf(ly, -o.hy[l], o.hy[l]);
+            pb.hit[k] = dist2(lx, ly, qx, qy) < r * r;
+        }
+#endif
+    }
+};
+
+template <>
+struct PairKernel<SHAPE_CIRCLE, SHAPE_POLY> {
+    static const bool supported = true;
+    template <class T> static void run(const T& t, PairBatch& pb, int n) {
+        const int* a = pb.a.data(); const int* b = pb.b.data();
+        const PolyBlock* pl = t.polys;
+#ifdef MATH2D_SSE
+        for (int k = 0; k < n; k += 4) {
+            float4 px = COLLIDE_GATHER(t.cx, a, k), py = COLLIDE_GATHER(t.cy, a, k), r = COLLIDE_GATHER(t.cr, a, k);
+            int edges = std::max(std::max(pl[b[k] >> 2].edges, pl[b[k + 1] >> 2].edges),
+                                 std::max(pl[b[k + 2] >> 2].edges, pl[b[k + 3] >> 2].edges));
+            float4 maxd = f4(-1e30f), minSeg = f4(1e30f), zero = f4(0), one = f4(1);
+            for (int e = 0; e < edges; e++) {   // short polygons repeat their last edge
+                float4 wx = px - COLLIDE_GATHER_L(pl, vx[e], b, k), wy = py - COLLIDE_GATHER_L(pl, vy[e], b, k);
+                float4 ex = COLLIDE_GATHER_L(pl, ex[e], b, k), ey = COLLIDE_GATHER_L(pl, ey[e], b, k);
+                maxd = max4(maxd, wx * COLLIDE_GATHER_L(pl, nx[e], b, k) + wy * COLLIDE_GATHER_L(pl, ny[e], b, k));
+                float4 s = clamp4((wx * ex + wy * ey) * COLLIDE_GATHER_L(pl, il2[e], b, k), zero, one);
+                minSeg = min4(minSeg, dist2_4(wx, wy, ex * s, ey * s));
+            }
+            storeHits(&pb.hit[k], mask4(le4(maxd, zero)) | mask4(lt4(minSeg, r * r)));
+        }
+#else
+        for (int k = 0; k < n; k++) {
+            const PolyBlock& o = pl[b[k] >> 2]; int l = b[k] & 3;
+            float x = t.cx[a[k]], y = t.cy[a[k]], r = t.cr[a[k]], maxd = -1e30f, minSeg = 1e30f;
+            for (int e = 0; e < o.edges; e++) {
+                float wx = x - o.vx[e][l], wy = y - o.vy[e][l];
+                maxd = std::max(maxd, wx * o.nx[e][l] + wy * o.ny[e][l]);
+                float s = clampf((wx * o.ex[e][l] + wy * o.ey[e][l]) * o.il2[e][l], 0, 1);
+                minSeg = std::min(minSeg, dist2(wx, wy, o.ex[e][l] * s, o.ey[e][l] * s));
+            }
+            pb.hit[k] = maxd <= 0 || minSeg < r * r;
+        }
+#endif
+    }
+};
+
+// ---------------- matrix ----------------
+struct CollisionMatrix {
+    PairBatch cell[SHAPE_KINDS][SHAPE_KINDS];
+
+    void clear() {
+        for (auto& row : cell)
+            for (auto& pb : row) { pb.a.clear(); pb.b.clear(); pb.hit.clear(); }
+    }
+
+    // Kinds known at compile time (the common case)
+    template <ShapeKind A, ShapeKind B>
+    void add(int i, int j) {
+        static_assert(A <= B, "list the lower ShapeKind first");
+        static_assert(PairKernel<A, B>::supported, "no kernel for this shape pair");
+        cell[A][B].a.push_back(i); cell[A][B].b.push_back(j);
+    }
+
+    // Kinds only known at run time: ordered here, once per pair
+    void add(ShapeKind ka, int i, ShapeKind kb, int j) {
+        if (ka > kb) { std::swap(ka, kb); std::swap(i, j); }
+        cell[ka][kb].a.push_back(i); cell[ka][kb].b.push_back(j);
+    }
+
+    const PairBatch& batch(ShapeKind a, ShapeKind b) const { return cell[a][b]; }
+
+    template <class T> void run(const T& tables);
+
+    bool anyHit() const {
+        for (const auto& row : cell)
+            for (const auto& pb : row)
+                for (uint8_t h : pb.hit) if (h) return true;
+        return false;
+    }
+};
+
+// Compile-time walk over all cells; I = A * SHAPE_KINDS + B
+template <int I>
+struct MatrixCells {
+    template <class T>
+    static void run(CollisionMatrix& m, const T& tables) {
+        const ShapeKind A = (ShapeKind)(I / SHAPE_KINDS), B = (ShapeKind)(I % SHAPE_KINDS);
+        PairBatch& pb = m.cell[A][B];
+        int n = pb.size();
+        if (n > 0) {
+            int padded = (n + 3) & ~3;   // kernels take whole groups of four
+            pb.a.resize(padded, pb.a[n - 1]); pb.b.resize(padded, pb.b[n - 1]);
+            pb.hit.assign(padded, 0);
+            PairKernel<A, B>::run(tables, pb, padded);
+            pb.a.resize(n); pb.b.resize(n); pb.hit.resize(n);
+        }
+        MatrixCells<I + 1>::run(m, tables);
+    }
+};
+
+template <>
+struct MatrixCells<SHAPE_KINDS * SHAPE_KINDS> {
+    template <class T> static void run(CollisionMatrix&, const T&) {}
+};
+
+template <class T>
+void CollisionMatrix::run(const T& tables) { MatrixCells<0>::run(*this, tables); }
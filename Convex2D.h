@@ -0,0 +1,215 @@
+// ====== Convex obstacles: oriented boxes and polygons ======
+// Circle-vs-shape tests for obstacles that are not axis-aligned squares.
+// The game keeps an AoS list per kind for editing/drawing and rebuilds a
+// SoA copy (four shapes per block) when shapes are added; removing one patches
+// just the lanes it touched (removeBoxAt / removePolyAt). The tests run
+// on the SoA copy four obstacles per step, with a bounding-circle reject per
+// block before any edge math.
+//
+// Polygon test (separating axes): the edge normals give the signed distance
+// of the center to each edge line (all <= 0 means the center is inside), and
+// the remaining axis, center to closest feature, is the distance to the
+// nearest edge segment. Boxes go to box space and clamp, like tryMove does.
+
+#pragma once
+#include "Math2D.h"
+#include <vector>
+#include <algorithm>
+
+const int POLY_MAX_VERTS = 8;
+
+struct OBox {
+    float x, y, hx, hy;   // center, half extents
+    float angle;          // radians, CCW
+};
+
+struct ConvexPoly {
+    int n;                                        // 3..POLY_MAX_VERTS, CCW order
+    float px[POLY_MAX_VERTS], py[POLY_MAX_VERTS];  // world space
+};
+
+inline void boxCorners(const OBox& b, float* px, float* py) {
+    float sn, cs; fastSinCos(b.angle, sn, cs);
+    const float sx[4] = { -1, 1, 1, -1 }, sy[4] = { -1, -1, 1, 1 };
+    for (int i = 0; i < 4; i++) {
+        float lx = sx[i] * b.hx, ly = sy[i] * b.hy;
+        px[i] = b.x + lx * cs - ly * sn;
+        py[i] = b.y + lx * sn + ly * cs;
+    }
+}
+
+inline void polyBounds(const ConvexPoly& p, float& cx, float& cy, float& br) {
+    cx = cy = 0;
+    for (int i = 0; i < p.n; i++) { cx += p.px[i]; cy += p.py[i]; }
+    cx /= p.n; cy /= p.n;
+    float m = 0;
+    for (int i = 0; i < p.n; i++) m = std::max(m, dist2(cx, cy, p.px[i], p.py[i]));
+    br = sqrtf(m);
+}
+
+// ---------------- scalar reference ----------------
+inline bool circleHitsBox(const OBox& b, float x, float y, float r) {
+    float sn, cs; fastSinCos(b.angle, sn, cs);
+    float dx = x - b.x, dy = y - b.y;
+    float lx = dx * cs + dy * sn, ly = -dx * sn + dy * cs;
+    float qx = clampf(lx, -b.hx, b.hx), qy = clampf(ly, -b.hy, b.hy);
+    return dist2(lx, ly, qx, qy) < r * r;
+}
+
+inline bool circleHitsPoly(const ConvexPoly& p, float x, float y, float r) {
+    float maxd = -1e30f, minSeg = 1e30f;
+    for (int i = 0; i < p.n; i++) {
+        int j = (i + 1 == p.n) ? 0 : i + 1;
+        float ex = p.px[j] - p.px[i], ey = p.py[j] - p.py[i];
+        float wx = x - p.px[i], wy = y - p.py[i];
+        float il = 1.0f / sqrtf(ex * ex + ey * ey);
+        maxd = std::max(maxd, (wx * ey - wy * ex) * il);    // outward normal (ey,-ex) for CCW
+        float t = clampf((wx * ex + wy * ey) * il * il, 0, 1);
+        minSeg = std::min(minSeg, dist2(wx, wy, ex * t, ey * t));
+    }
+    return maxd <= 0 || minSeg < r * r;
+}
+
+// ---------------- SoA blocks ----------------
+// Lanes past the end of the list get a far-away bounding circle so they never hit.
+struct BoxBlock {
+    float cx[4], cy[4], hx[4], hy[4], cs[4], sn[4], br[4];
+};
+
+struct PolyBlock {
+    float cx[4], cy[4], br[4];
+    // per edge k: start vertex, edge vector, unit outward normal, 1/|e|^2
+    float vx[POLY_MAX_VERTS][4], vy[POLY_MAX_VERTS][4];
+    float ex[POLY_MAX_VERTS][4], ey[POLY_MAX_VERTS][4];
+    float nx[POLY_MAX_VERTS][4], ny[POLY_MAX_VERTS][4];
+    float il2[POLY_MAX_VERTS][4];
+    int edges;   // max n over the four lanes
+};
+
+const float SHAPE_FAR = 1e15f;
+
+// Lane l of a block from one shape; null empties it
+inline void setBoxLane(BoxBlock& k, int l, const OBox* o) {
+    if (!o) { k.cx[l] = k.cy[l] = SHAPE_FAR; k.hx[l] = k.hy[l] = k.br[l] = 0; k.cs[l] = 1; k.sn[l] = 0; return; }
+    k.cx[l] = o->x; k.cy[l] = o->y; k.hx[l] = o->hx; k.hy[l] = o->hy;
+    fastSinCos(o->angle, k.sn[l], k.cs[l]);
+    k.br[l] = sqrtf(o->hx * o->hx + o->hy * o->hy);
+}
+
+inline void setPolyLane(PolyBlock& k, int l, const ConvexPoly* p) {
+    if (!p) {   // empty lane: never inside (normal faces the query), never near
+        k.cx[l] = k.cy[l] = SHAPE_FAR; k.br[l] = 0;
+        for (int e = 0; e < POLY_MAX_VERTS; e++) {
+            k.vx[e][l] = k.vy[e][l] = SHAPE_FAR; k.ex[e][l] = k.ey[e][l] = 0;
+            k.nx[e][l] = -1; k.ny[e][l] = 0; k.il2[e][l] = 0;
+        }
+        return;
+    }
+    polyBounds(*p, k.cx[l], k.cy[l], k.br[l]);
+    k.edges = std::max(k.edges, p->n);   // never shrinks; extra edges repeat the last one
+    for (int e = 0; e < POLY_MAX_VERTS; e++) {
+        int a = std::min(e, p->n - 1);            // pad by repeating the last edge
+        int c = (a + 1 == p->n) ? 0 : a + 1;
+        float ex = p->px[c] - p->px[a], ey = p->py[c] - p->py[a];
+        float l2 = ex * ex + ey * ey, il = 1.0f / sqrtf(l2);
+        k.vx[e][l] = p->px[a]; k.vy[e][l] = p->py[a];
+        k.ex[e][l] = ex; k.ey[e][l] = ey;
+        k.nx[e][l] = ey * il; k.ny[e][l] = -ex * il;
+        k.il2[e][l] = 1.0f / l2;
+    }
+}
+
+inline void buildBoxBlocks(const std::vector<OBox>& src, std::vector<BoxBlock>& dst) {
+    dst.assign((src.size() + 3) / 4, BoxBlock());
+    for (size_t i = 0; i < dst.size() * 4; i++)
+        setBoxLane(dst[i >> 2], (int)(i & 3), i < src.size() ? &src[i] : nullptr);
+}
+
+inline void buildPolyBlocks(const std::vector<ConvexPoly>& src, std::vector<PolyBlock>& dst) {
+    dst.assign((src.size() + 3) / 4, PolyBlock());
+    for (auto& k : dst) k.edges = 3;
+    for (size_t i = 0; i < dst.size() * 4; i++)
+        setPolyLane(dst[i >> 2], (int)(i & 3), i < src.size() ? &src[i] : nullptr);
+}
+
+// Swap-remove shape i from the list and patch only the two lanes that changed
+// (i now holds the old last shape; the last lane empties), instead of a rebuild
+inline void removeBoxAt(std::vector<OBox>& src, std::vector<BoxBlock>& dst, int i) {
+    int last = (int)src.size() - 1;
+    src[i] = src[last];
+    src.pop_back();
+    if (i != last) setBoxLane(dst[i >> 2], i & 3, &src[i]);
+    setBoxLane(dst[last >> 2], last & 3, nullptr);
+    if ((last & 3) == 0) dst.pop_back();
+}
+
+inline void removePolyAt(std::vector<ConvexPoly>& src, std::vector<PolyBlock>& dst, int i) {
+    int last = (int)src.size() - 1;
+    src[i] = src[last];
+    src.pop_back();
+    if (i != last) setPolyLane(dst[i >> 2], i & 3, &src[i]);
+    setPolyLane(dst[last >> 2], last & 3, nullptr);
+    if ((last & 3) == 0) dst.pop_back();
+}
+
+// ---------------- batched tests ----------------
+inline bool circleHitsBoxBlock(const BoxBlock& k, float x, float y, float r) {
+#ifdef MATH2D_SSE
+    float4 rr = f4(r * r);
+    float4 dx = f4(x) - load4(k.cx), dy = f4(y) - load4(k.cy);
+    float4 reach = load4(k.br) + f4(r);
+    if (!any4(lt4(dx * dx + dy * dy, reach * reach))) return false;
+    float4 cs = load4(k.cs), sn = load4(k.sn), hx = load4(k.hx), hy = load4(k.hy);
+    float4 lx = dx * cs + dy * sn, ly = dy * cs - dx * sn;
+    float4 qx = clamp4(lx, f4(0) - hx, hx), qy = clamp4(ly, f4(0) - hy, hy);
+    return any4(lt4(dist2_4(lx, ly, qx, qy), rr));
+#else
+    for (int l = 0; l < 4; l++) {
+        float dx = x - k.cx[l], dy = y - k.cy[l];
+        float lx = dx * k.cs[l] + dy * k.sn[l], ly = dy * k.cs[l] - dx * k.sn[l];
+        float qx = clampf(lx, -k.hx[l], k.hx[l]), qy = clampf(ly, -k.hy[l], k.hy[l]);
+        if (dist2(lx, ly, qx, qy) < r * r) return true;
+    }
+    return false;
+#endif
+}
+
+inline bool circleHitsPolyBlock(const PolyBlock& k, float x, float y, float r) {
+#ifdef MATH2D_SSE
+    float4 px = f4(x), py = f4(y);
+    float4 reach = load4(k.br) + f4(r);
+    if (!any4(lt4(dist2_4(px, py, load4(k.cx), load4(k.cy)), reach * reach))) return false;
+    float4 maxd = f4(-1e30f), minSeg = f4(1e30f), zero = f4(0), one = f4(1);
+    for (int e = 0; e < k.edges; e++) {
+        float4 wx = px - load4(k.vx[e]), wy = py - load4(k.vy[e]);
+        float4 ex = load4(k.ex[e]), ey = load4(k.ey[e]);
+        maxd = max4(maxd, wx * load4(k.nx[e]) + wy * load4(k.ny[e]));
+        float4 t = clamp4((wx * ex + wy * ey) * load4(k.il2[e]), zero, one);
+        minSeg = min4(minSeg, dist2_4(wx, wy, ex * t, ey * t));
+    }
+    return (mask4(le4(maxd, zero)) | mask4(lt4(minSeg, f4(r * r)))) != 0;
+#else
+    for (int l = 0; l < 4; l++) {
+        if (dist2(x, y, k.cx[l], k.cy[l]) >= (k.br[l] + r) * (k.br[l] + r)) continue;
+        float maxd = -1e30f, minSeg = 1e30f;
+        for (int e = 0; e < k.edges; e++) {
+            float wx = x - k.vx[e][l], wy = y - k.vy[e][l];
+            maxd = std::max(maxd, wx * k.nx[e][l] + wy * k.ny[e][l]);
+            float t = clampf((wx * k.ex[e][l] + wy * k.ey[e][l]) * k.il2[e][l], 0, 1);
+            minSeg = std::min(minSeg, dist2(wx, wy, k.ex[e][l] * t, k.ey[e][l] * t));
+        }
+        if (maxd <= 0 || minSeg < r * r) return true;
+    }
+    return false;
+#endif
+}
+
+inline bool circleHitsBoxes(const std::vector<BoxBlock>& v, float x, float y, float r) {
+    for (const auto& k : v) if (circleHitsBoxBlock(k, x, y, r)) return true;
+    return false;
+}
+
+inline bool circleHitsPolys(const std::vector<PolyBlock>& v, float x, float y, float r) {
+    for (const auto& k : v) if (circleHitsPolyBlock(k, x, y, r)) return true;
+    return false;
+}
@@ -0,0 +1,134 @@
+// ====== Level difficulty estimate ======
+// Monte Carlo over noisy bot rounds (playBotRound) on headless copies of a
+// level: waves of rounds go to the worker pool, and after each wave the 95%
+// Wilson interval on the win rate is checked. It stops once that interval is
+// tight enough, or when the time or round budget runs out. Each round is
+// seeded by its index and starts the target at its own place on the path,
+// so the rounds played so far are the same however many threads ran them.
+//
+// The score folds the three estimates into 0 (easy) .. 100 (hard): losing
+// weighs most, then how long wins take, then hits taken.
+//
+// estimateDifficulties plays a fixed count for many levels at once, all in
+// one pool pass over (level, round), and scores each the way
+// estimateDifficulty would with that count.
+
+#pragma once
+#include "BatchEnv.h"
+#include <math.h>
+#include <chrono>
+
+struct DifficultyOptions {
+    float noise = 0.1f;         // share of time the bot acts at random
+    float tolerance = 0.02f;    // stop at this 95% half-width on the win rate
+    int minRounds = 128, maxRounds = 20000;
+    double budgetMs = 900;      // stop after the wave that passes this
+    float cell = 8;             // bot map cell (px)
+};
+
+struct DifficultyReport {
+    int rounds = 0, wins = 0;
+    float winRate = 0, winLo = 0, winHi = 0;   // estimate and Wilson 95% bounds
+    float timeToTarget = 0;                     // mean seconds, won rounds
+    float hits = 0;                             // mean lives lost per round
+    float score = 0;
+    bool converged = false;                     // tolerance reached within budget
+    double ms = 0;
+};
+
+// Wilson score interval for k successes in n trials at z (1.96: 95%)
+inline void wilson(int k, int n, float z, float& lo, float& hi) {
+    double p = (double)k / n, z2 = (double)z * z, d = 1 + z2 / n;
+    double c = (p + z2 / (2 * n)) / d, h = z * sqrt(p * (1 - p) / n + z2 / (4.0 * n * n)) / d;
+    lo = (float)std::max(0.0, c - h); hi = (float)std::min(1.0, c + h);
+}
+
+// Round `id` in world w: the target starts at a place hashed from id
+inline bool playDifficultyRound(const EnvLevel& L, const EnvBotMap& M, const EnvRules& R, EnvBatch& B, int w, float noise, uint32_t id) {
+    B.reset(L, w, R.maxLives);
+    B.targetT[w] = (float)((id * 2654435761u) >> 8) * (1.0f / 16777216.0f);
+    B.targetDir[w] = (id & 1) ? -1.0f : 1.0f;
+    return playBotRound(L, M, R, B, w, noise, id);
+}
+
+// Means and score from rep.rounds, rep.wins and the won rounds' time and hits
+inline void scoreDifficulty(DifficultyReport& rep, const EnvRules& R, double winTime, double hits) {
+    rep.winRate = (float)rep.wins / rep.rounds;
+    rep.timeToTarget = rep.wins ? (float)(winTime / rep.wins) : R.roundTime;
+    rep.hits = (float)(hits / rep.rounds);
+    float slow = std::min(1.0f, rep.timeToTarget / R.roundTime), hurt = std::min(1.0f, rep.hits / std::max(1, R.maxLives));
+    rep.score = 100 * (0.6f * (1 - rep.winRate) + 0.25f * slow + 0.15f * hurt);
+}
+
+// `map` skips building the bot map when the caller keeps one for L
+inline DifficultyReport estimateDifficulty(const EnvLevel& L, const EnvRules& base, const DifficultyOptions& opt = DifficultyOptions(),
+                                           const EnvBotMap* map = nullptr) {
+    auto t0 = std::chrono::steady_clock::now();
+    auto ms = [&]() { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count(); };
+    EnvRules R = base;
+    R.repeat = 1;
+    EnvBotMap own;
+    if (!map) { own.build(L, opt.cell); map = &own; }
+    const EnvBotMap& M = *map;
+
+    DifficultyReport rep;
+    double winTime = 0, hits = 0;
+    const int wave = std::max(64, 16 * workers().size());
+    EnvBatch B;
+    B.resize(L, wave);
+    std::vector<uint8_t> won(wave);
+    while (rep.rounds < opt.maxRounds) {
+        int n = std::min(wave, opt.maxRounds - rep.rounds), first = rep.rounds;
+        parallelFor(n, 4, [&](int b, int e) {
+            for (int w = b; w < e; w++) won[w] = playDifficultyRound(L, M, R, B, w, opt.noise, (uint32_t)(first + w));
+        });
+        for (int w = 0; w < n; w++) {
+            rep.wins += won[w];
+            if (won[w]) winTime += B.time[w];
+            hits += R.maxLives - B.lives[w];
+        }
+        rep.rounds += n;
+        wilson(rep.wins, rep.rounds, 1.96f, rep.winLo, rep.winHi);
+        if (rep.rounds >= opt.minRounds && (rep.winHi - rep.winLo) * 0.5f <= opt.tolerance) { rep.converged = true; break; }
+        if (ms() > opt.budgetMs) break;
+    }
+
+    scoreDifficulty(rep, R, winTime, hits);
+    rep.ms = ms();
+    return rep;
+}
+
+// opt.maxRounds rounds for each of levels[i] on maps[i], no early stop. A
+// batch of small estimates still fills the pool: rounds x levels tasks
+inline std::vector<DifficultyReport> estimateDifficulties(const std::vector<const EnvLevel*>& levels, const std::vector<const EnvBotMap*>& maps,
+                                                          const EnvRules& base, const DifficultyOptions& opt) {
+    auto t0 = std::chrono::steady_clock::now();
+    EnvRules R = base;
+    R.repeat = 1;
+    int m = (int)levels.size(), rounds = std::max(1, opt.maxRounds);
+    std::vector<EnvBatch> B(m);
+    for (int i = 0; i < m; i++) B[i].resize(*levels[i], rounds);
+    std::vector<uint8_t> won((size_t)m * rounds);
+    parallelFor(m * rounds, 4, [&](int b, int e) {
+        for (int t = b; t < e; t++) {
+            int i = t / rounds, w = t % rounds;
+            won[t] = playDifficultyRound(*levels[i], *maps[i], R, B[i], w, opt.noise, (uint32_t)w);
+        }
+    });
+    std::vector<DifficultyReport> out(m);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    for (int i = 0; i < m; i++) {
+        DifficultyReport& rep = out[i];
+        double winTime = 0, hits = 0;
+        for (int w = 0; w < rounds; w++) {
+            rep.wins += won[(size_t)i * rounds + w];
+            if (won[(size_t)i * rounds + w]) winTime += B[i].time[w];
+            hits += R.maxLives - B[i].lives[w];
+        }
+        rep.rounds = rounds;
+        wilson(rep.wins, rep.rounds, 1.96f, rep.winLo, rep.winHi);
+        scoreDifficulty(rep, R, winTime, hits);
+        rep.ms = ms;
+    }
+    return out;
+}
@@ -0,0 +1,98 @@
+// ====== Free-space sampling index ======
+// A grid over the play area that keeps every cell where a spawn may go in a
+// dense list, so drawing a random free position is one pick from the list
+// whatever share of the area is taken. Rejection sampling against the layout
+// instead needs 1 / (free share) tries, each scanning every object.
+//
+// A cell counts as taken if any point of it is: disks block the cells whose
+// centre lies within r + pad (pad = half the cell diagonal), and solid
+// geometry is judged by the caller at the centre with the same pad. Any point
+// of a free cell is then a valid spawn. Disks come and go by reference count
+// (cover with +1 / -1); solid cells are re-judged per box (refresh) after the
+// geometry under them changes. Free cells leave and join the list by
+// swap-remove, so every update is O(cells touched).
+
+#pragma once
+#include <stdint.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+struct FreeSpace {
+    float x0 = 0, y0 = 0, cell = 1, inv = 1, pad = 0.7071f;
+    int cols = 0, rows = 0;
+    std::vector<uint16_t> covers;    // disks over the cell
+    std::vector<uint8_t> solid;      // geometry over the cell
+    std::vector<int> freeCells;      // dense, any order
+    std::vector<int> slot;           // index in freeCells, or -1
+
+    void init(float ox, float oy, float w, float h, float cellSize) {
+        x0 = ox; y0 = oy; cell = cellSize; inv = 1.0f / cellSize; pad = cellSize * 0.70711f;
+        cols = std::max(1, (int)floorf(w * inv));
+        rows = std::max(1, (int)floorf(h * inv));
+        int n = cols * rows;
+        covers.assign(n, 0);
+        solid.assign(n, 0);
+        freeCells.resize(n);
+        slot.resize(n);
+        for (int i = 0; i < n; i++) freeCells[i] = slot[i] = i;
+    }
+
+    int freeCount() const { return (int)freeCells.size(); }
+    float centreX(int i) const { return x0 + (i % cols + 0.5f) * cell; }
+    float centreY(int i) const { return y0 + (i / cols + 0.5f) * cell; }
+
+    void update(int i) {
+        bool f = covers[i] == 0 && !solid[i];
+        if (f && slot[i] < 0) { slot[i] = (int)freeCells.size(); freeCells.push_back(i); }
+        else if (!f && slot[i] >= 0) {
+            int last = freeCells.back();
+            freeCells[slot[i]] = last; slot[last] = slot[i];
+            freeCells.pop_back(); slot[i] = -1;
+        }
+    }
+
+    // Cells overlapping the box grown by `grow`
+    template <class F>
+    void forCells(float minx, float miny, float maxx, float maxy, float grow, F fn) {
+        int c0 = std::max(0, (int)floorf((minx - grow - x0) * inv)), c1 = std::min(cols - 1, (int)floorf((maxx + grow - x0) * inv));
+        int r0 = std::max(0, (int)floorf((miny - grow - y0) * inv)), r1 = std::min(rows - 1, (int)floorf((maxy + grow - y0) * inv));
+        for (int r = r0; r <= r1; r++)
+            for (int c = c0; c <= c1; c++) fn(r * cols + c);
+    }
+
+    // Blocks (delta 1) or unblocks (-1) every cell with a point within r of
+    // (x, y); calls must pair up with the same arguments
+    void cover(float x, float y, float r, int delta = 1) {
+        float rr = (r + pad) * (r + pad);
+        forCells(x, y, x, y, r + pad, [&](int i) {
+            float dx = centreX(i) - x, dy = centreY(i) - y;
+            if (dx * dx + dy * dy >= rr) return;
+            covers[i] = (uint16_t)(covers[i] + delta);
+            update(i);
+        });
+    }
+
+    // Re-judges the cells under a box: blockedAt(cx, cy, pad) is true when
+    // anything solid lies within pad of the centre, spawn radius included
+    template <class F>
+    void refresh(float minx, float miny, float maxx, float maxy, F blockedAt) {
+        forCells(minx, miny, maxx, maxy, pad, [&](int i) {
+            solid[i] = blockedAt(centreX(i), centreY(i), pad) ? 1 : 0;
+            update(i);
+        });
+    }
+    template <class F>
+    void refreshAll(F blockedAt) { refresh(x0, y0, x0 + cols * cell, y0 + rows * cell, blockedAt); }
+
+    // Uniform over the free area; false when nothing is free. `seed` is a
+    // xorshift32 state
+    bool sample(uint32_t& seed, float& x, float& y) const {
+        if (freeCells.empty()) return false;
+        auto next = [&]() { seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5; return seed; };
+        int i = freeCells[next() % freeCells.size()];
+        x = centreX(i) + ((next() >> 8) * (1.0f / 16777216.0f) - 0.5f) * cell;
+        y = centreY(i) + ((next() >> 8) * (1.0f / 16777216.0f) - 0.5f) * cell;
+        return true;
+    }
+};
@@ -0,0 +1,277 @@
+// ====== Level evolution ======
+// Genetic search over where a level's squares and items sit (the editor's
+// Obj placements) for a target difficulty. Walls, boxes, polygons, the start
+// and the target path stay as given, and so do each object's size and kind.
+// Fitness is |difficulty - target| over a fixed set of noisy bot rounds;
+// the rounds are seeded the same for every genome (estimateDifficulty), so
+// two layouts are compared on the same dice.
+//
+// Each generation keeps the elite as they are and breeds the rest by
+// tournament, uniform crossover per object and Gaussian moves. Scores are
+// cached by genome hash, so the elite and any child identical to a genome
+// seen before are never simulated again. The cache is checked first: a
+// child whose score is cached gets no bot map until it is picked as a
+// parent. Every other genome keeps its map; a child starts from its first
+// parent's, re-tests only the cells around squares that moved, and re-runs
+// only the BFS fields of moved items and of goals those cells can reach
+// (EnvBotMap::touches). A generation's uncached children are simulated
+// together (estimateDifficulties), so the pool gets children x rounds tasks
+// rather than one child's rounds at a time.
+
+#pragma once
+#include "Difficulty.h"
+#include <unordered_map>
+
+struct LevelGenome {
+    std::vector<float> sx, sy;      // squares
+    std::vector<float> ix, iy;      // items
+    uint64_t hash = 0;
+    float score = 0, fitness = 1e30f;
+    EnvBotMap map;
+    bool mapped = false;            // map is for these placements
+};
+
+struct EvolveOptions {
+    float target = 50;              // difficulty score to reach
+    int population = 24, elite = 6;    // elite: at most a quarter of the population
+    int rounds = 64;                // bot rounds per evaluation
+    float mutateRate = 0.15f;       // chance per object of a move
+    float step = 60;                // move sigma (px)
+    uint32_t seed = 1;
+};
+
+struct EvolveStats {
+    int evaluations = 0, cacheHits = 0;
+    long long cellsRetested = 0, fieldsRefilled = 0;
+};
+
+struct LevelEvolver {
+    EnvLevel base, scratch;
+    EnvRules rules;
+    EvolveOptions opt;
+    DifficultyOptions rounds;
+    std::vector<LevelGenome> pop;
+    std::unordered_map<uint64_t, float> cache;     // genome hash -> difficulty score
+    EvolveStats stats;
+    uint32_t rng = 1;
+
+    uint32_t next() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+    float uniform() { return (next() >> 8) * (1.0f / 16777216.0f); }
+    float gauss() { float u = std::max(uniform(), 1e-7f), v = uniform(); return sqrtf(-2 * logf(u)) * fastCos(TWO_PI_F * v); }
+
+    void init(const EnvLevel& seedLevel, const EnvRules& R, const EvolveOptions& o) {
+        base = seedLevel; base.finish();
+        scratch = base;
+        rules = R; opt = o;
+        rng = o.seed ? o.seed : 1;
+        rounds.noise = 0.1f;
+        rounds.minRounds = rounds.maxRounds = opt.rounds;
+        rounds.tolerance = 0;
+        rounds.budgetMs = 1e30;
+        cache.clear();
+        stats = EvolveStats();
+        pop.assign(std::max(2, opt.population), LevelGenome());
+        LevelGenome& g0 = pop[0];
+        g0.sx = base.sqx; g0.sy = base.sqy; g0.ix = base.ix; g0.iy = base.iy;
+        lookup(g0);
+        apply(g0);
+        g0.map.build(scratch, rounds.cell);
+        g0.mapped = true;
+        std::vector<LevelGenome*> todo(1, &g0), twins;
+        // The rest start as the seed with every object moved once
+        for (size_t i = 1; i < pop.size(); i++) {
+            LevelGenome& g = pop[i];
+            g = g0;
+            for (size_t k = 0; k < g.sx.size(); k++) moveSquare(g, (int)k);
+            for (size_t k = 0; k < g.ix.size(); k++) moveItem(g, (int)k);
+            if (lookup(g)) continue;
+            if (queued(todo, g)) { twins.push_back(&g); continue; }
+            rebuild(g, g0);
+            todo.push_back(&g);
+        }
+        evaluate(todo);
+        for (auto* g : twins) lookup(*g);
+    }
+
+    // Genome -> scratch level (a copy of base from init)
+    void apply(const LevelGenome& g) {
+        scratch.sqx = g.sx; scratch.sqy = g.sy;
+        scratch.ix = g.ix; scratch.iy = g.iy;
+    }
+
+    static uint64_t hashOf(const LevelGenome& g) {
+        uint64_t h = 1469598103934665603ull;
+        auto mix = [&](const std::vector<float>& v) {
+            for (float f : v) { uint32_t b; memcpy(&b, &f, 4); h = (h ^ b) * 1099511628211ull; }
+        };
+        mix(g.sx); mix(g.sy); mix(g.ix); mix(g.iy);
+        return h;
+    }
+
+    // Squares stay inside the area, clear of the start and off items; items
+    // off every shape
+    bool squareOk(const LevelGenome& g, int k, float x, float y) const {
+        float h = base.sqh[k], r = base.playerR;
+        if (x - h < base.x0 || x + h > base.x1 || y - h < base.y0 || y + h > base.y1) return false;
+        if (fabsf(x - base.startX) <= h + 2 * r && fabsf(y - base.startY) <= h + 2 * r) return false;
+        for (size_t i = 0; i < g.ix.size(); i++) {
+            float cx = clampf(g.ix[i], x - h, x + h), cy = clampf(g.iy[i], y - h, y + h);
+            if (dist2(g.ix[i], g.iy[i], cx, cy) < base.ir[i] * base.ir[i]) return false;
+        }
+        return true;
+    }
+    bool itemOk(const LevelGenome& g, int k, float x, float y) const {
+        float r = base.ir[k];
+        if (x - r < base.x0 || x + r > base.x1 || y - r < base.y0 || y + r > base.y1) return false;
+        for (size_t i = 0; i < g.sx.size(); i++) {
+            float h = base.sqh[i], cx = clampf(x, g.sx[i] - h, g.sx[i] + h), cy = clampf(y, g.sy[i] - h, g.sy[i] + h);
+            if (dist2(x, y, cx, cy) < r * r) return false;
+        }
+        return !tileCircleHits(base.walls, x, y, r) && !circleHitsBoxes(base.boxBlocks, x, y, r) && !circleHitsPolys(base.polyBlocks, x, y, r);
+    }
+
+    // A few tries at a Gaussian move; the object stays put if none is valid
+    void moveSquare(LevelGenome& g, int k) {
+        for (int t = 0; t < 4; t++) {
+            float x = g.sx[k] + gauss() * opt.step, y = g.sy[k] + gauss() * opt.step;
+            if (squareOk(g, k, x, y)) { g.sx[k] = x; g.sy[k] = y; return; }
+        }
+    }
+    void moveItem(LevelGenome& g, int k) {
+        for (int t = 0; t < 4; t++) {
+            float x = g.ix[k] + gauss() * opt.step, y = g.iy[k] + gauss() * opt.step;
+            if (itemOk(g, k, x, y)) { g.ix[k] = x; g.iy[k] = y; return; }
+        }
+    }
+
+    // g.map from `from`'s: cells around moved squares, then the fields of
+    // moved items and those the flipped cells can reach
+    void rebuild(LevelGenome& g, const LevelGenome& from) {
+        apply(g);
+        g.map = from.map;
+        float pad = base.playerR + g.map.cell;
+        std::vector<int> flipped;
+        for (size_t k = 0; k < g.sx.size(); k++) {
+            if (g.sx[k] == from.sx[k] && g.sy[k] == from.sy[k]) continue;
+            float h = base.sqh[k] + pad;
+            for (int s = 0; s < 2; s++) {
+                float x = s ? g.sx[k] : from.sx[k], y = s ? g.sy[k] : from.sy[k];
+                g.map.reopen(scratch, x - h, y - h, x + h, y + h, &flipped);
+                stats.cellsRetested += (long long)(2 * h / g.map.cell + 1) * (long long)(2 * h / g.map.cell + 1);
+            }
+        }
+        int fields = g.map.items + BOT_PATH_SAMPLES;
+        for (int f = 0; f < fields; f++) {
+            bool moved = f < g.map.items && (g.ix[f] != from.ix[f] || g.iy[f] != from.iy[f]);
+            if (moved || (!flipped.empty() && g.map.touches(scratch, f, flipped))) { g.map.refill(scratch, f); stats.fieldsRefilled++; }
+        }
+        g.mapped = true;
+    }
+
+    // Objects placed differently in a and b
+    static int moved(const LevelGenome& a, const LevelGenome& b) {
+        int n = 0;
+        for (size_t k = 0; k < a.sx.size(); k++) n += a.sx[k] != b.sx[k] || a.sy[k] != b.sy[k];
+        for (size_t k = 0; k < a.ix.size(); k++) n += a.ix[k] != b.ix[k] || a.iy[k] != b.iy[k];
+        return n;
+    }
+
+    // A parent whose score came from the cache: its map from the nearest
+    // genome that has one
+    void needMap(LevelGenome& g) {
+        if (g.mapped) return;
+        const LevelGenome* from = nullptr;
+        int best = 0;
+        for (const auto& o : pop) {
+            if (!o.mapped) continue;
+            int d = moved(g, o);
+            if (!from || d < best) { from = &o; best = d; }
+        }
+        if (from) rebuild(g, *from);
+        else { apply(g); g.map.build(scratch, rounds.cell); g.mapped = true; }
+    }
+
+    // Score from the cache, if this genome was seen before
+    bool lookup(LevelGenome& g) {
+        g.hash = hashOf(g);
+        auto it = cache.find(g.hash);
+        if (it == cache.end()) return false;
+        g.score = it->second;
+        g.fitness = fabsf(g.score - opt.target);
+        g.mapped = false;
+        stats.cacheHits++;
+        return true;
+    }
+
+    // A genome with g's hash already waits in todo: g takes its score after
+    static bool queued(const std::vector<LevelGenome*>& todo, const LevelGenome& g) {
+        for (const LevelGenome* o : todo) if (o->hash == g.hash) return true;
+        return false;
+    }
+
+    // Simulates todo in one batch; lookup() has hashed each and their maps
+    // are up to date
+    void evaluate(const std::vector<LevelGenome*>& todo) {
+        std::vector<EnvLevel> levels;
+        levels.reserve(todo.size());
+        std::vector<const EnvLevel*> L;
+        std::vector<const EnvBotMap*> M;
+        for (const LevelGenome* g : todo) {
+            levels.push_back(level(*g));
+            L.push_back(&levels.back());
+            M.push_back(&g->map);
+        }
+        std::vector<DifficultyReport> reps = estimateDifficulties(L, M, rules, rounds);
+        for (size_t i = 0; i < todo.size(); i++) {
+            LevelGenome& g = *todo[i];
+            g.score = reps[i].score;
+            cache[g.hash] = g.score;
+            stats.evaluations++;
+            g.fitness = fabsf(g.score - opt.target);
+        }
+    }
+
+    int tournament() {
+        int a = next() % pop.size(), b = next() % pop.size();
+        return pop[a].fitness <= pop[b].fitness ? a : b;
+    }
+
+    void generation() {
+        std::sort(pop.begin(), pop.end(), [](const LevelGenome& a, const LevelGenome& b) { return a.fitness < b.fitness; });
+        int keep = std::max(1, std::min(opt.elite, (int)pop.size() / 4));
+        std::vector<LevelGenome> kids(pop.size() - keep);
+        std::vector<LevelGenome*> todo, twins;
+        for (auto& c : kids) {
+            LevelGenome& a = pop[tournament()];
+            const LevelGenome& b = pop[tournament()];
+            c.sx = a.sx; c.sy = a.sy; c.ix = a.ix; c.iy = a.iy;
+            for (size_t k = 0; k < c.sx.size(); k++) {
+                if ((next() & 1) && squareOk(c, (int)k, b.sx[k], b.sy[k])) { c.sx[k] = b.sx[k]; c.sy[k] = b.sy[k]; }
+                if (uniform() < opt.mutateRate) moveSquare(c, (int)k);
+            }
+            for (size_t k = 0; k < c.ix.size(); k++) {
+                if ((next() & 1) && itemOk(c, (int)k, b.ix[k], b.iy[k])) { c.ix[k] = b.ix[k]; c.iy[k] = b.iy[k]; }
+                if (uniform() < opt.mutateRate) moveItem(c, (int)k);
+            }
+            if (lookup(c)) continue;
+            if (queued(todo, c)) { twins.push_back(&c); continue; }
+            needMap(a);
+            rebuild(c, a);
+            todo.push_back(&c);
+        }
+        evaluate(todo);
+        for (auto* c : twins) lookup(*c);
+        for (size_t i = 0; i < kids.size(); i++) pop[keep + i] = std::move(kids[i]);
+    }
+
+    const LevelGenome& best() const {
+        return *std::min_element(pop.begin(), pop.end(), [](const LevelGenome& a, const LevelGenome& b) { return a.fitness < b.fitness; });
+    }
+
+    // The seed level with g's placements
+    EnvLevel level(const LevelGenome& g) const {
+        EnvLevel L = base;
+        L.sqx = g.sx; L.sqy = g.sy; L.ix = g.ix; L.iy = g.iy;
+        return L;
+    }
+};
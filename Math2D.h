@@ -0,0 +1,262 @@
+// ====== 2D math for the hot path (header-only) ======
+// vec2, 4/8-wide SIMD floats, branchless clamp/distance helpers and polynomial
+// sin/cos/atan2. Error bounds below are measured by --bench-math over
+// 1M random inputs against libm.
+//
+// Vector types are passed by const reference: 32-bit MSVC cannot pass more
+// than three aligned SIMD values by value.
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MATH2D_SSE 1
+#endif
+#if defined(__AVX__)
+#include <immintrin.h>
+#define MATH2D_AVX 1
+#endif
+
+const float PI_F = 3.14159265f;
+const float TWO_PI_F = 6.2831853f;
+// 2*pi split for Cody-Waite reduction: k*TWO_PI_A is exact for |k| < 2^16
+const float TWO_PI_A = 6.28125f, TWO_PI_B = 1.9353072e-3f;
+const float RAD2DEG = 57.29578f;
+
+// ---------------- Scalar helpers ----------------
+
+// Written as max-then-min so compilers emit maxss/minss (no branch) and can
+// vectorize loops over it; same result as the old ternary for non-NaN input.
+inline float clampf(float v, float lo, float hi) {
+    v = v > lo ? v : lo;
+    return v < hi ? v : hi;
+}
+
+inline float dist2(float x1, float y1, float x2, float y2) { float dx = x1 - x2, dy = y1 - y2; return dx * dx + dy * dy; }
+
+inline bool intersectCircleCircle(float x1, float y1, float r1, float x2, float y2, float r2) {
+    float rr = (r1 + r2) * (r1 + r2);
+    return dist2(x1, y1, x2, y2) <= rr;
+}
+
+struct vec2 {
+    float x, y;
+};
+
+inline vec2  operator+(const vec2& a, const vec2& b) { vec2 r = { a.x + b.x, a.y + b.y }; return r; }
+inline vec2  operator-(const vec2& a, const vec2& b) { vec2 r = { a.x - b.x, a.y - b.y }; return r; }
+inline vec2  operator*(const vec2& a, float s) { vec2 r = { a.x * s, a.y * s }; return r; }
+inline float dot(const vec2& a, const vec2& b) { return a.x * b.x + a.y * b.y; }
+inline float len2(const vec2& a) { return a.x * a.x + a.y * a.y; }
+
+// Cubic Bezier (Bernstein form) of one coordinate
+inline float bezier1(float t, float a, float b, float c, float d) {
+    float u = 1.0f - t;
+    return u * u * u * a + 3 * u * u * t * b + 3 * u * t * t * c + t * t * t * d;
+}
+
+// ---------------- Polynomial transcendentals ----------------
+// Minimax coefficients (Lawson-weighted least squares).
+// fastSin/fastCos: degree-9 odd polynomial on [-pi/2, pi/2] after Cody-Waite
+//   reduction. |err| <= 3e-7 for |x| <= 100, <= 1.2e-6 for |x| < 1e5.
+// fastAtan2: degree-11 odd polynomial for atan on [0,1] plus octant fix-up.
+//   |err| <= 2e-6 rad (~1e-4 deg).
+
+const float SIN_C1 = 9.9999998e-1f, SIN_C3 = -1.6666648e-1f, SIN_C5 = 8.3328999e-3f,
+            SIN_C7 = -1.9800900e-4f, SIN_C9 = 2.5904927e-6f;
+const float ATAN_C1 = 9.9997722e-1f, ATAN_C3 = -3.3262282e-1f, ATAN_C5 = 1.9354033e-1f,
+            ATAN_C7 = -1.1642632e-1f, ATAN_C9 = 5.2647145e-2f, ATAN_C11 = -1.1719047e-2f;
+
+// x - 2*pi*round(x / 2*pi), in [-pi, pi]
+inline float reduceAngle(float x) {
+#ifdef MATH2D_SSE
+    float k = (float)_mm_cvtss_si32(_mm_set_ss(x * (1.0f / TWO_PI_F))); // round to nearest
+#else
+    float k = floorf(x * (1.0f / TWO_PI_F) + 0.5f);
+#endif
+    return (x - k * TWO_PI_A) - k * TWO_PI_B;
+}
+
+// sin for x in [-3pi/2, 3pi/2] without branches: sin(x) = sign(x) * sin(|x|) and
+// sin(a) = sin(pi - a), so min(|x|, pi - |x|) always lands in [-pi/2, pi/2]
+inline float sinFolded(float x) {
+    uint32_t bits, sign;
+    memcpy(&bits, &x, sizeof(bits));
+    sign = bits & 0x80000000u;
+    bits ^= sign;
+    float a;
+    memcpy(&a, &bits, sizeof(a));
+    a = a < PI_F - a ? a : PI_F - a;
+    float a2 = a * a;
+    float r = a * (SIN_C1 + a2 * (SIN_C3 + a2 * (SIN_C5 + a2 * (SIN_C7 + a2 * SIN_C9))));
+    memcpy(&bits, &r, sizeof(bits));
+    bits ^= sign;
+    memcpy(&r, &bits, sizeof(r));
+    return r;
+}
+
+inline float fastSin(float x) { return sinFolded(reduceAngle(x)); }
+
+// shift after the reduction so the +pi/2 does not round a large argument
+inline float fastCos(float x) { return sinFolded(reduceAngle(x) + 0.5f * PI_F); }
+
+inline void fastSinCos(float x, float& s, float& c) { s = fastSin(x); c = fastCos(x); }
+
+inline float fastAtan2(float y, float x) {
+    float ax = fabsf(x), ay = fabsf(y);
+    float mx = ax > ay ? ax : ay, mn = ax > ay ? ay : ax;
+    if (mx == 0.0f) return 0.0f;
+    float t = mn / mx, t2 = t * t;
+    float r = t * (ATAN_C1 + t2 * (ATAN_C3 + t2 * (ATAN_C5 + t2 * (ATAN_C7 + t2 * (ATAN_C9 + t2 * ATAN_C11)))));
+    if (ay > ax) r = 0.5f * PI_F - r;
+    if (x < 0) r = PI_F - r;
+    return y < 0 ? -r : r;
+}
+
+#ifdef MATH2D_SSE
+// ---------------- float4 (SSE) ----------------
+struct float4 {
+    __m128 v;
+};
+
+inline float4 f4(float s) { float4 r = { _mm_set1_ps(s) }; return r; }
+inline float4 f4(float a, float b, float c, float d) { float4 r = { _mm_setr_ps(a, b, c, d) }; return r; }
+inline float4 load4(const float* p) { float4 r = { _mm_loadu_ps(p) }; return r; }
+inline void   store4(float* p, const float4& a) { _mm_storeu_ps(p, a.v); }
+// p[0..7] = a0 b0 a1 b1 a2 b2 a3 b3 (SoA -> interleaved x,y for vertex arrays)
+inline void   store4x2(float* p, const float4& a, const float4& b) {
+    _mm_storeu_ps(p, _mm_unpacklo_ps(a.v, b.v));
+    _mm_storeu_ps(p + 4, _mm_unpackhi_ps(a.v, b.v));
+}
+
+inline float4 operator+(const float4& a, const float4& b) { float4 r = { _mm_add_ps(a.v, b.v) }; return r; }
+inline float4 operator-(const float4& a, const float4& b) { float4 r = { _mm_sub_ps(a.v, b.v) }; return r; }
+inline float4 operator*(const float4& a, const float4& b) { float4 r = { _mm_mul_ps(a.v, b.v) }; return r; }
+inline float4 operator/(const float4& a, const float4& b) { float4 r = { _mm_div_ps(a.v, b.v) }; return r; }
+inline float4 min4(const float4& a, const float4& b) { float4 r = { _mm_min_ps(a.v, b.v) }; return r; }
+inline float4 max4(const float4& a, const float4& b) { float4 r = { _mm_max_ps(a.v, b.v) }; return r; }
+inline float4 abs4(const float4& a) { float4 r = { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; return r; }
+inline float4 sqrt4(const float4& a) { float4 r = { _mm_sqrt_ps(a.v) }; return r; }
+inline float4 clamp4(const float4& v, const float4& lo, const float4& hi) { return min4(max4(v, lo), hi); }
+
+// masks: all-ones lanes where true
+inline float4 lt4(const float4& a, const float4& b) { float4 r = { _mm_cmplt_ps(a.v, b.v) }; return r; }
+inline float4 le4(const float4& a, const float4& b) { float4 r = { _mm_cmple_ps(a.v, b.v) }; return r; }
+inline float4 gt4(const float4& a, const float4& b) { float4 r = { _mm_cmpgt_ps(a.v, b.v) }; return r; }
+inline float4 select4(const float4& m, const float4& a, const float4& b) {
+    float4 r = { _mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v)) }; return r;
+}
+inline int  mask4(const float4& m) { return _mm_movemask_ps(m.v); }
+inline bool any4(const float4& m) { return _mm_movemask_ps(m.v) != 0; }
+// a where the mask is set, else 0 (also combines masks)
+inline float4 and4(const float4& m, const float4& a) { float4 r = { _mm_and_ps(m.v, a.v) }; return r; }
+
+inline float hsum4(const float4& a) {
+    __m128 s = _mm_add_ps(a.v, _mm_movehl_ps(a.v, a.v));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+
+inline float4 dist2_4(const float4& x1, const float4& y1, const float4& x2, const float4& y2) {
+    float4 dx = x1 - x2, dy = y1 - y2;
+    return dx * dx + dy * dy;
+}
+
+inline float4 bezier4(const float4& t, const float4& a, const float4& b, const float4& c, const float4& d) {
+    float4 u = f4(1) - t, three = f4(3);
+    return u * u * u * a + three * u * u * t * b + three * u * t * t * c + t * t * t * d;
+}
+
+inline float4 reduceAngle4(const float4& x) {
+    float4 k = { _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x.v, _mm_set1_ps(1.0f / TWO_PI_F)))) };
+    return (x - k * f4(TWO_PI_A)) - k * f4(TWO_PI_B);
+}
+
+inline float4 sinFolded4(const float4& x) {
+    __m128 sign = _mm_and_ps(x.v, _mm_set1_ps(-0.0f));
+    float4 a = { _mm_xor_ps(x.v, sign) };
+    a = min4(a, f4(PI_F) - a);
+    float4 a2 = a * a;
+    float4 r = a * (f4(SIN_C1) + a2 * (f4(SIN_C3) + a2 * (f4(SIN_C5) + a2 * (f4(SIN_C7) + a2 * f4(SIN_C9)))));
+    r.v = _mm_xor_ps(r.v, sign);
+    return r;
+}
+
+inline float4 fastSin4(const float4& x) { return sinFolded4(reduceAngle4(x)); }
+inline float4 fastCos4(const float4& x) { return sinFolded4(reduceAngle4(x) + f4(0.5f * PI_F)); }
+
+inline float4 fastAtan2_4(const float4& y, const float4& x) {
+    float4 ax = abs4(x), ay = abs4(y);
+    float4 mx = max4(ax, ay), mn = min4(ax, ay);
+    float4 t = mn / max4(mx, f4(1e-30f)), t2 = t * t;
+    float4 r = t * (f4(ATAN_C1) + t2 * (f4(ATAN_C3) + t2 * (f4(ATAN_C5) + t2 * (f4(ATAN_C7) + t2 * (f4(ATAN_C9) + t2 * f4(ATAN_C11))))));
+    r = select4(gt4(ay, ax), f4(0.5f * PI_F) - r, r);
+    r = select4(lt4(x, f4(0)), f4(PI_F) - r, r);
+    return select4(lt4(y, f4(0)), f4(0) - r, r); // y < 0 like the scalar, so -0 keeps +pi
+}
+
+// ---------------- float8 (AVX, or two SSE halves) ----------------
+#ifdef MATH2D_AVX
+struct float8 {
+    __m256 v;
+};
+inline float8 f8(float s) { float8 r = { _mm256_set1_ps(s) }; return r; }
+inline float8 load8(const float* p) { float8 r = { _mm256_loadu_ps(p) }; return r; }
+inline void   store8(float* p, const float8& a) { _mm256_storeu_ps(p, a.v); }
+inline float8 operator+(const float8& a, const float8& b) { float8 r = { _mm256_add_ps(a.v, b.v) }; return r; }
+inline float8 operator-(const float8& a, const float8& b) { float8 r = { _mm256_sub_ps(a.v, b.v) }; return r; }
+inline float8 operator*(const float8& a, const float8& b) { float8 r = { _mm256_mul_ps(a.v, b.v) }; return r; }
+inline float8 min8(const float8& a, const float8& b) { float8 r = { _mm256_min_ps(a.v, b.v) }; return r; }
+inline float8 max8(const float8& a, const float8& b) { float8 r = { _mm256_max_ps(a.v, b.v) }; return r; }
+inline float8 operator/(const float8& a, const float8& b) { float8 r = { _mm256_div_ps(a.v, b.v) }; return r; }
+inline float8 lt8(const float8& a, const float8& b) { float8 r = { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; return r; }
+inline float8 gt8(const float8& a, const float8& b) { float8 r = { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; return r; }
+inline int    mask8(const float8& m) { return _mm256_movemask_ps(m.v); }
+inline float8 select8(const float8& m, const float8& a, const float8& b) { float8 r = { _mm256_blendv_ps(b.v, a.v, m.v) }; return r; }
+inline float8 abs8(const float8& a) { float8 r = { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v) }; return r; }
+#else
+struct float8 {
+    float4 lo, hi;
+};
+inline float8 f8(float s) { float8 r = { f4(s), f4(s) }; return r; }
+inline float8 load8(const float* p) { float8 r = { load4(p), load4(p + 4) }; return r; }
+inline void   store8(float* p, const float8& a) { store4(p, a.lo); store4(p + 4, a.hi); }
+inline float8 operator+(const float8& a, const float8& b) { float8 r = { a.lo + b.lo, a.hi + b.hi }; return r; }
+inline float8 operator-(const float8& a, const float8& b) { float8 r = { a.lo - b.lo, a.hi - b.hi }; return r; }
+inline float8 operator*(const float8& a, const float8& b) { float8 r = { a.lo * b.lo, a.hi * b.hi }; return r; }
+inline float8 min8(const float8& a, const float8& b) { float8 r = { min4(a.lo, b.lo), min4(a.hi, b.hi) }; return r; }
+inline float8 max8(const float8& a, const float8& b) { float8 r = { max4(a.lo, b.lo), max4(a.hi, b.hi) }; return r; }
+inline float8 operator/(const float8& a, const float8& b) { float8 r = { a.lo / b.lo, a.hi / b.hi }; return r; }
+inline float8 lt8(const float8& a, const float8& b) { float8 r = { lt4(a.lo, b.lo), lt4(a.hi, b.hi) }; return r; }
+inline float8 gt8(const float8& a, const float8& b) { float8 r = { gt4(a.lo, b.lo), gt4(a.hi, b.hi) }; return r; }
+inline int    mask8(const float8& m) { return mask4(m.lo) | (mask4(m.hi) << 4); }
+inline float8 select8(const float8& m, const float8& a, const float8& b) { float8 r = { select4(m.lo, a.lo, b.lo), select4(m.hi, a.hi, b.hi) }; return r; }
+inline float8 abs8(const float8& a) { float8 r = { abs4(a.lo), abs4(a.hi) }; return r; }
+#endif
+
+inline float8 clamp8(const float8& v, const float8& lo, const float8& hi) { return min8(max8(v, lo), hi); }
+inline float8 dist2_8(const float8& x1, const float8& y1, const float8& x2, const float8& y2) {
+    float8 dx = x1 - x2, dy = y1 - y2;
+    return dx * dx + dy * dy;
+}
+
+// Same operation order as bezier1 and fastAtan2, so each lane gives the scalar result
+inline float8 bezier8(const float8& t, const float8& a, const float8& b, const float8& c, const float8& d) {
+    float8 u = f8(1) - t, three = f8(3);
+    return u * u * u * a + three * u * u * t * b + three * u * t * t * c + t * t * t * d;
+}
+
+inline float8 fastAtan2_8(const float8& y, const float8& x) {
+    float8 ax = abs8(x), ay = abs8(y);
+    float8 mx = max8(ax, ay), mn = min8(ax, ay);
+    float8 t = mn / max8(mx, f8(1e-30f)), t2 = t * t;
+    float8 r = t * (f8(ATAN_C1) + t2 * (f8(ATAN_C3) + t2 * (f8(ATAN_C5) + t2 * (f8(ATAN_C7) + t2 * (f8(ATAN_C9) + t2 * f8(ATAN_C11))))));
+    r = select8(gt8(ay, ax), f8(0.5f * PI_F) - r, r);
+    r = select8(lt8(x, f8(0)), f8(PI_F) - r, r);
+    return select8(lt8(y, f8(0)), f8(0) - r, r);
+}
+#endif // MATH2D_SSE
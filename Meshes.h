@@ -0,0 +1,110 @@
+// ====== Compile-time shape meshes ======
+// Every game shape as a normalized vertex array, built by constexpr functions
+// into constexpr tables (evaluated by the compiler, C++14). Draw code only
+// applies a per-instance translate/scale (and rotation for the ship), so the
+// GL and soft backends read the exact same geometry.
+//
+// Units: circles and item shapes have radius 1; the ship is in units of
+// Player::r (hull length 2.2, half-height 1.2).
+
+#pragma once
+
+struct MeshVtx {
+    float x, y;
+};
+
+template <int N>
+struct Mesh {
+    MeshVtx v[N];
+    static constexpr int count = N;
+};
+
+// ---------------- constexpr trig (Taylor, double) ----------------
+constexpr double CT_PI = 3.14159265358979323846;
+
+constexpr double ctSin(double x) {
+    while (x > CT_PI) x -= 2 * CT_PI;
+    while (x < -CT_PI) x += 2 * CT_PI;
+    double term = x, sum = x;
+    for (int n = 1; n < 12; n++) {
+        term *= -x * x / ((2.0 * n) * (2.0 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double ctCos(double x) { return ctSin(x + CT_PI / 2); }
+
+// ---------------- generators ----------------
+
+// Triangle fan: center, then SEG+1 rim points (first repeated to close)
+template <int SEG>
+constexpr Mesh<SEG + 2> makeCircleFan() {
+    Mesh<SEG + 2> m = {};
+    m.v[0].x = 0; m.v[0].y = 0;
+    for (int i = 0; i <= SEG; i++) {
+        double a = 2 * CT_PI * i / SEG;
+        m.v[i + 1].x = (float)ctCos(a);
+        m.v[i + 1].y = (float)ctSin(a);
+    }
+    return m;
+}
+
+// Line loop: SEG rim points
+template <int SEG>
+constexpr Mesh<SEG> makeCircleLoop() {
+    Mesh<SEG> m = {};
+    for (int i = 0; i < SEG; i++) {
+        double a = 2 * CT_PI * i / SEG;
+        m.v[i].x = (float)ctCos(a);
+        m.v[i].y = (float)ctSin(a);
+    }
+    return m;
+}
+
+// Ship hull outline (polygon and line loop share it)
+constexpr Mesh<6> makeHull() {
+    const float L = 2.2f, H = 1.2f;
+    Mesh<6> m = { { { +L * 0.55f, 0 }, { +L * 0.10f, +H * 0.95f }, { -L * 0.25f, +H * 0.70f },
+                    { -L * 0.55f, 0 }, { -L * 0.25f, -H * 0.70f }, { +L * 0.10f, -H * 0.95f } } };
+    return m;
+}
+
+// Two fins as a triangle list
+constexpr Mesh<6> makeFins() {
+    const float L = 2.2f, H = 1.2f;
+    Mesh<6> m = { { { -L * 0.18f, +H * 0.65f }, { -L * 0.60f, +H * 1.15f }, { -L * 0.35f, +H * 0.40f },
+                    { -L * 0.18f, -H * 0.65f }, { -L * 0.60f, -H * 1.15f }, { -L * 0.35f, -H * 0.40f } } };
+    return m;
+}
+
+// ---------------- tables ----------------
+constexpr Mesh<18> CIRCLE_FAN_16 = makeCircleFan<16>();
+constexpr Mesh<22> CIRCLE_FAN_20 = makeCircleFan<20>();
+constexpr Mesh<26> CIRCLE_FAN_24 = makeCircleFan<24>();
+constexpr Mesh<30> CIRCLE_FAN_28 = makeCircleFan<28>();
+constexpr Mesh<34> CIRCLE_FAN_32 = makeCircleFan<32>();
+constexpr Mesh<24> CIRCLE_LOOP_24 = makeCircleLoop<24>();
+constexpr Mesh<40> CIRCLE_LOOP_40 = makeCircleLoop<40>();
+
+constexpr Mesh<6> SHIP_HULL = makeHull();
+constexpr Mesh<6> SHIP_FINS = makeFins();
+const float SHIP_COCKPIT_X = 2.2f * 0.18f, SHIP_COCKPIT_R = 0.45f;
+const float SHIP_TAIL_X = -2.2f * 0.55f;   // exhaust attaches here
+
+constexpr Mesh<4> UNIT_QUAD = { { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } } };
+constexpr Mesh<4> UNIT_CROSS = { { { -1, -1 }, { 1, 1 }, { 1, -1 }, { -1, 1 } } };      // obstacle X (lines)
+constexpr Mesh<4> UNIT_PLUS = { { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } } };        // target crosshair (lines)
+constexpr Mesh<3> COIN_TRI = { { { 0, 1 }, { -0.8f, -0.6f }, { 0.8f, -0.6f } } };
+constexpr Mesh<2> COIN_LINE = { { { 0, 0.2f }, { 0, -0.8f } } };
+constexpr Mesh<4> DIAMOND = { { { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, 0 } } };
+constexpr Mesh<6> STAR = { { { 0, 1 }, { 0.9f, -0.2f }, { -0.9f, -0.2f },
+                             { 0, -1 }, { 0.9f, 0.2f }, { -0.9f, 0.2f } } };
+constexpr Mesh<7> MAGNET_U = { { { -0.7f, 0.9f }, { -0.7f, -0.1f }, { -0.45f, -0.7f }, { 0, -0.9f },
+                                 { 0.45f, -0.7f }, { 0.7f, -0.1f }, { 0.7f, 0.9f } } };   // horseshoe (line strip)
+constexpr Mesh<4> MAGNET_TIPS = { { { -0.95f, 0.9f }, { -0.45f, 0.9f }, { 0.45f, 0.9f }, { 0.95f, 0.9f } } };
+constexpr Mesh<3> HEART_TRI = { { { -0.75f, 0 }, { 0.75f, 0 }, { 0, -0.9f } } };
+const float HEART_LOBE_X = 0.3f, HEART_LOBE_R = 0.35f;
+
+static_assert(CIRCLE_FAN_32.v[9].y > 0.9999f && CIRCLE_FAN_32.v[9].y <= 1.0f, "constexpr trig off");
+static_assert(SHIP_HULL.v[0].x > 1.2f && SHIP_HULL.v[0].x < 1.22f, "hull nose at 0.55 L");
@@ -0,0 +1,217 @@
+// ====== Kinematic moving obstacles ======
+// Axis-aligned squares that patrol a cubic Bezier path (same curve as the
+// target's bezierPoint), ping-ponging t over [0,1]. State is SoA; step()
+// advances and evaluates four movers per SSE op, then updates the spatial
+// grid incrementally: each mover is indexed by its swept box (last tick's
+// square joined with this tick's), and only movers whose cell range changed
+// touch the grid.
+//
+// circleHits() tests the whole tick, not just the end position: in the
+// square's frame the circle center moves along a segment, and that segment is
+// tested against the square's Minkowski sum with the circle (two grown boxes
+// plus four corner circles). Fast movers cannot tunnel through the player.
+//
+// stepLod() is step() with levels of detail around a focus (the player):
+// movers in grid cells within lodNear step every tick, those within lodMid
+// every midDiv ticks (cells take turns), and all others in turn, farBudget a
+// tick. A tick's cost then follows what is near, not the world's size. The
+// path is closed form, so a mover that missed ticks catches up in one step
+// to where per-tick steps would have put it, last tick's position included:
+// its swept box and hits() are the same as at full rate. A set uses either
+// step() or stepLod(), not both.
+
+#pragma once
+#include "Math2D.h"
+#include "SpatialGrid.h"
+#include <stdlib.h>
+#include <vector>
+
+struct MoverSet {
+    std::vector<float> ax, ay, bx, by, cx, cy, dx, dy;   // control points p0..p3
+    std::vector<float> t, rate;                          // path parameter, dt/dt (sign = direction)
+    std::vector<float> x, y, px, py;                     // position now / last tick
+    std::vector<float> h;                                // half size
+    std::vector<CellRange> cellr;                        // grid cells of the swept box
+    SpatialGrid grid;
+    int count = 0;
+    int lastCellChanges = 0;                             // movers re-bucketed by the last step
+
+    // stepLod state
+    float lodNear = 256, lodMid = 768;                   // tier radii (px)
+    int midDiv = 4, farBudget = 256;
+    std::vector<double> last;                            // clock at each mover's last step
+    std::vector<uint32_t> stamp;                         // tick of the last step
+    std::vector<int> lodIds;                             // scratch
+    double clock = 0;
+    uint32_t tick = 0;
+    int farCursor = 0, lastStepped = 0;                  // movers stepped by the last stepLod
+
+    void init(float ox, float oy, float w, float hgt, float cellSize) {
+        grid.init(ox, oy, w, hgt, cellSize);
+        clear();
+    }
+
+    void clear() {
+        for (auto* v : { &ax, &ay, &bx, &by, &cx, &cy, &dx, &dy, &t, &rate, &x, &y, &px, &py, &h }) v->clear();
+        cellr.clear(); last.clear(); stamp.clear();
+        farCursor = 0;
+        grid.clear();
+        count = 0;
+    }
+
+    // p: four control points (x,y); speed in path lengths per second
+    int add(const float p[4][2], float half, float speed, float t0) {
+        ax.push_back(p[0][0]); ay.push_back(p[0][1]); bx.push_back(p[1][0]); by.push_back(p[1][1]);
+        cx.push_back(p[2][0]); cy.push_back(p[2][1]); dx.push_back(p[3][0]); dy.push_back(p[3][1]);
+        t.push_back(t0); rate.push_back(speed); h.push_back(half);
+        float sx = bezier1(t0, p[0][0], p[1][0], p[2][0], p[3][0]);
+        float sy = bezier1(t0, p[0][1], p[1][1], p[2][1], p[3][1]);
+        x.push_back(sx); y.push_back(sy); px.push_back(sx); py.push_back(sy);
+        CellRange cr = grid.range(sx - half, sy - half, sx + half, sy + half);
+        cellr.push_back(cr);
+        grid.insert(count, cr);
+        last.push_back(clock); stamp.push_back(tick);
+        return count++;
+    }
+
+    // Restart every mover at t0 (new round)
+    void rewind(float t0) {
+        for (int i = 0; i < count; i++) { t[i] = t0; rate[i] = fabsf(rate[i]); }
+        step(0);
+        for (int i = 0; i < count; i++) { px[i] = x[i]; py[i] = y[i]; last[i] = clock; }
+    }
+
+    CellRange sweptRange(int i) const {
+        float hh = h[i];
+        return grid.range(std::min(px[i], x[i]) - hh, std::min(py[i], y[i]) - hh,
+                          std::max(px[i], x[i]) + hh, std::max(py[i], y[i]) + hh);
+    }
+
+    void step(float dt) {
+        int i = 0;
+#ifdef MATH2D_SSE
+        float4 vdt = f4(dt), zero = f4(0), one = f4(1), two = f4(2);
+        for (; i + 4 <= count; i += 4) {
+            float4 r = load4(&rate[i]), tt = load4(&t[i]) + r * vdt;
+            float4 over = gt4(tt, one), under = lt4(tt, zero);
+            tt = select4(over, two - tt, select4(under, zero - tt, tt));
+            r = select4(over, zero - r, select4(under, zero - r, r));
+            store4(&t[i], tt); store4(&rate[i], r);
+            store4(&px[i], load4(&x[i])); store4(&py[i], load4(&y[i]));
+            store4(&x[i], bezier4(tt, load4(&ax[i]), load4(&bx[i]), load4(&cx[i]), load4(&dx[i])));
+            store4(&y[i], bezier4(tt, load4(&ay[i]), load4(&by[i]), load4(&cy[i]), load4(&dy[i])));
+        }
+#endif
+        for (; i < count; i++) {
+            float tt = t[i] + rate[i] * dt;
+            if (tt > 1) { tt = 2 - tt; rate[i] = -rate[i]; }
+            else if (tt < 0) { tt = -tt; rate[i] = -rate[i]; }
+            t[i] = tt;
+            px[i] = x[i]; py[i] = y[i];
+            x[i] = bezier1(tt, ax[i], bx[i], cx[i], dx[i]);
+            y[i] = bezier1(tt, ay[i], by[i], cy[i], dy[i]);
+        }
+
+        int changed = 0;
+        for (int k = 0; k < count; k++) {
+            CellRange cr = sweptRange(k);
+            if (cr != cellr[k]) { grid.move(k, cellr[k], cr); cellr[k] = cr; changed++; }
+        }
+        lastCellChanges = changed;
+    }
+
+    // Ping-pong t over [0,1] by rate * dt, for any dt: fold the unbounded
+    // parameter into [0,2); past 1 it is on the way back
+    static void advance(float& tt, float& r, float dt) {
+        float u = tt + r * dt;
+        if (u >= 0 && u <= 1) { tt = u; return; }
+        u -= 2 * floorf(u * 0.5f);
+        if (u > 1) { tt = 2 - u; r = -r; }
+        else tt = u;
+    }
+
+    // Mover i by the time since its last step; dt is one tick
+    void stepOne(int i, float dt) {
+        stamp[i] = tick;
+        float lag = (float)(clock - last[i]);
+        last[i] = clock;
+        if (lag > dt * 1.5f) {
+            advance(t[i], rate[i], lag - dt);
+            px[i] = bezier1(t[i], ax[i], bx[i], cx[i], dx[i]);
+            py[i] = bezier1(t[i], ay[i], by[i], cy[i], dy[i]);
+            advance(t[i], rate[i], dt);
+        }
+        else {
+            px[i] = x[i]; py[i] = y[i];
+            advance(t[i], rate[i], lag);
+        }
+        x[i] = bezier1(t[i], ax[i], bx[i], cx[i], dx[i]);
+        y[i] = bezier1(t[i], ay[i], by[i], cy[i], dy[i]);
+        CellRange cr = sweptRange(i);
+        if (cr != cellr[i]) { grid.move(i, cellr[i], cr); cellr[i] = cr; lastCellChanges++; }
+        lastStepped++;
+    }
+
+    void stepLod(float dt, float fx, float fy) {
+        clock += dt;
+        tick++;
+        lastCellChanges = lastStepped = 0;
+        if (count == 0) return;
+        int nearCells = (int)ceilf(lodNear * grid.inv), midCells = (int)ceilf(lodMid * grid.inv);
+        int fc = (int)floorf((fx - grid.x0) * grid.inv), fr = (int)floorf((fy - grid.y0) * grid.inv);
+        int c0 = std::max(0, fc - midCells), c1 = std::min(grid.cols - 1, fc + midCells);
+        int r0 = std::max(0, fr - midCells), r1 = std::min(grid.rows - 1, fr + midCells);
+        lodIds.clear();
+        for (int r = r0; r <= r1; r++)
+            for (int c = c0; c <= c1; c++) {
+                int ring = std::max(abs(c - fc), abs(r - fr));
+                if (ring > nearCells && (uint32_t)(c + r) % midDiv != tick % midDiv) continue;
+                const std::vector<int>& ids = grid.at(c, r);
+                lodIds.insert(lodIds.end(), ids.begin(), ids.end());
+            }
+        // stepping edits the cells, so the ids were gathered first
+        for (int i : lodIds) if (stamp[i] != tick) stepOne(i, dt);
+        for (int k = 0; k < std::min(farBudget, count); k++) {
+            if (farCursor >= count) farCursor = 0;
+            int i = farCursor++;
+            if (stamp[i] != tick) stepOne(i, dt);
+        }
+    }
+
+    // Segment o + s*d, s in [0,1], vs the open box [-ex,ex] x [-ey,ey]
+    static bool segHitsBox(float ox, float oy, float ddx, float ddy, float ex, float ey) {
+        float t0 = 0, t1 = 1;
+        const float o[2] = { ox, oy }, d[2] = { ddx, ddy }, e[2] = { ex, ey };
+        for (int a = 0; a < 2; a++) {
+            if (fabsf(d[a]) < 1e-9f) { if (o[a] <= -e[a] || o[a] >= e[a]) return false; continue; }
+            float inv = 1.0f / d[a], ta = (-e[a] - o[a]) * inv, tb = (e[a] - o[a]) * inv;
+            if (ta > tb) std::swap(ta, tb);
+            t0 = std::max(t0, ta); t1 = std::min(t1, tb);
+            if (t0 >= t1) return false;
+        }
+        return true;
+    }
+
+    // Segment vs circle of radius r at (cx0, cy0)
+    static bool segHitsCircle(float ox, float oy, float ddx, float ddy, float cx0, float cy0, float r) {
+        float wx = cx0 - ox, wy = cy0 - oy, l2 = ddx * ddx + ddy * ddy;
+        float s = l2 > 0 ? clampf((wx * ddx + wy * ddy) / l2, 0, 1) : 0;
+        return dist2(wx, wy, ddx * s, ddy * s) < r * r;
+    }
+
+    // Circle vs mover i over the last tick (see header comment)
+    bool hits(int i, float qx, float qy, float r) const {
+        float hh = h[i];
+        // in the square's frame the center goes from q - prev to q - now
+        float ox = qx - px[i], oy = qy - py[i];
+        float ddx = px[i] - x[i], ddy = py[i] - y[i];
+        if (segHitsBox(ox, oy, ddx, ddy, hh + r, hh) || segHitsBox(ox, oy, ddx, ddy, hh, hh + r)) return true;
+        for (int k = 0; k < 4; k++)
+            if (segHitsCircle(ox, oy, ddx, ddy, (k & 1) ? hh : -hh, (k & 2) ? hh : -hh, r)) return true;
+        return false;
+    }
+
+    bool circleHits(float qx, float qy, float r) const {
+        return grid.query(qx - r, qy - r, qx + r, qy + r, [&](int i) { return hits(i, qx, qy, r); });
+    }
+};
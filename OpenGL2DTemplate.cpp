@@ -10,11 +10,31 @@
 
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <vector>
 #include <algorithm>
+#include <chrono>
 #include <glut.h>
 
+#include "Math2D.h"
+#include "Meshes.h"
+#include "TileMap.h"
+#include "Convex2D.h"
+#include "Collide.h"
+#include "SpatialGrid.h"
+#include "FreeSpace.h"
+#include "Movers.h"
+#include "Projectiles.h"
+#include "Boids.h"
+#include "Visibility.h"
+#include "RayCast.h"
+#include "BatchEnv.h"
+#include "Sweep.h"
+#include "Difficulty.h"
+#include "LevelEvolve.h"
+#include "SoftRaster.h"
+
 
 
 
@@ -28,28 +48,258 @@ const int GAME_Y0 = BOT_H;
 const int GAME_Y1 = H - TOP_H;
 
 // ---------------- Game Config ----------------
-const int   MAX_LIVES = 5;
-const float PLAYER_SPEED = 240.0f;   // px/sec
-const float SPEED_BOOST = 420.0f;    // boosted speed
-const float POWERUP_DURATION = 4.0f; // seconds
-const float SHIELD_DURATION = 4.0f; // seconds
-const int   ROUND_TIME_SEC = 60;
+// Balance (speeds, power-up and round times, lives, target speed) is runtime:
+// --rule name=value on the command line (setRule), shared with the batched
+// worlds and the sweep
+EnvRules rules;
 
 const float PLACE_MIN_DIST = 26.0f;  // min distance between placed items
+const float TILE_SIZE = 10.0f;       // wall tile edge (px)
+const int   MAZE_PITCH = 5;          // maze cell = 4 open tiles + 1 wall
+const float BOX_HX = 26.0f, BOX_HY = 10.0f;  // placed oriented box
+const float POLY_R = 20.0f;                  // placed polygon circumradius
+const float MOVER_HALF = 14.0f;      // patrolling square half size
+const float MOVER_SPEED = 0.25f;     // path lengths per second (t units)
+const float MOVER_BEND = 80.0f;      // S-curve control point offset (px)
+const float MOVER_CLEAR = 40.0f;     // patrols keep this far from the ship's start (px)
+const float MOVER_CELL = 64.0f;      // spatial grid cell (px)
+
+// Bullet-hell hazard ('h': off -> on -> stress)
+const int   SHOT_CAPACITY = 1 << 18;
+const float SHOT_R = 3.0f;           // projectile radius (drawn as a 2r dot)
+const float SHOT_SPEED = 130.0f;     // px/sec
+const float SHOT_LIFE = 10.0f;       // seconds
+const int   EMITTERS = 8;            // spinning around the target
+const float EMITTER_ORBIT = 34.0f;
+const float HAZARD_RATE = 40.0f;     // shots/sec in normal mode
+const float STRESS_RATE0 = 2000.0f;  // stress mode starting rate; then adapts
+const float HAZARD_BUDGET_MS = 12.0f;  // stress: step + draw, of the 16.7 ms frame
+
+// Enemy swarm ('e')
+const int   SWARM_SIZE = 400;
+const float BOID_R = 5.0f;           // hit radius and drawn size
+
+// Player bolts (space, play only) destroy the obstacle or wall tiles they hit
+const float BOLT_SPEED = 520.0f;     // px/sec
+const float BOLT_R = 3.0f;
+const float BOLT_LIFE = 1.2f;        // seconds
+const float BOLT_COOLDOWN = 0.2f;    // seconds between shots while held
+const float BOLT_BLAST = 12.0f;      // wall tiles cleared around a hit (px)
+const float OBSTACLE_CELL = 64.0f;   // static obstacle grid cell (px)
+
+// Power-ups spawned during play at free spots (FreeSpace.h)
+const float SPAWN_EVERY = 6.0f;      // seconds between spawns
+const int   SPAWN_MAX = 6;           // none while this many power-ups are out
+const float SPAWN_R = 14.0f;         // as placed ones
+const float SPAWN_CELL = 8.0f;       // free-space grid cell (px)
+
+// Magnet power-up: collectibles within reach slide to the ship
+const float MAGNET_TIME = 6.0f;      // seconds
+const float MAGNET_RADIUS = 150.0f;  // px
+const float MAGNET_PULL = 320.0f;    // px/sec
+const float PICKUP_CELL = 32.0f;     // collectible grid cell (px)
+
+// Fast-forward ('t' steps the scale): fixed ticks per frame, one drawn
+const int   FF_SCALES[] = { 1, 2, 5, 10, 25, 50, 100 };
+const float SIM_DT = 1.0f / 60;      // tick while fast-forwarding (s)
+const double FF_BUDGET_MS = 14.0;    // simulation share of a frame
+
+// Fog of war ('f', play only): only what the ship can see is drawn
+const float FOG_RADIUS = 280.0f;     // sight range (px)
+const int   FOG_BINS = 720;          // half-degree rays
+const float FOG_REVEAL = TILE_SIZE;  // fog starts this far past the first hit, so wall faces show
+
+// Lidar sensors ('l' shows the ship's own scan, play only)
+const int   LIDAR_VIEW_RAYS = 64;
+const float LIDAR_RANGE = 300.0f;    // px
+
+// Headless worlds for bots and training (BatchEnv.h)
+const int   OBS_SIZE = 84;           // observation image edge (px)
 
 // ---------------- Utility ----------------
-float clampf(float v, float lo, float hi) { return v < lo ? lo : (v > hi ? hi : v); }
-float dist2(float x1, float y1, float x2, float y2) { float dx = x1 - x2, dy = y1 - y2; return dx * dx + dy * dy; }
+// clampf, dist2, intersectCircleCircle and the fast trig live in Math2D.h
 bool inGameArea(float x, float y) { return (x >= 0 && x <= W && y >= GAME_Y0 && y <= GAME_Y1); }
 
+// ---------------- Render Backend ----------------
+// Draw helpers call these r* wrappers instead of gl* directly, so the same scene
+// code feeds either GL immediate mode or the CPU rasterizer in SoftRaster.h.
+enum Backend { BACKEND_GL = 0, BACKEND_SOFT = 1 };
+Backend backend = BACKEND_GL;
+
+SoftFrame softFrame;   // scene at internal resolution
+SoftFrame softOut;     // W x H upscaled output (only used when renderScale < 1)
+
+// Internal render resolution as a fraction of W x H (soft backend only)
+float renderScale = 1.0f;
+bool  renderScaleAuto = false;   // adjust against SCALE_TARGET_MS
+bool  upscaleBilinear = true;    // else nearest
+
+// 2D affine transform for the soft path: x' = a*x + c*y + tx, y' = b*x + d*y + ty
+struct SoftXform { float a, b, c, d, tx, ty; };
+SoftXform softXf = { 1, 0, 0, 1, 0, 0 };
+std::vector<SoftXform> softXfStack;
+
+GLenum softMode = GL_POINTS;
+std::vector<float> softVerts;      // transformed x,y pairs of the open primitive
+std::vector<uint32_t> softColors;  // color per vertex (flat shading)
+float softRGB[3] = { 1, 1, 1 };
+uint32_t softColor = 0xFFFFFFFFu;
+float softLineW = 1.0f, softPointSz = 1.0f;
+float softLineScale = 1.0f;        // pixel scale of the current pass (line width, point size)
+
+// Text cannot be rasterized on the CPU (GLUT bitmap font), so the soft path
+// records print() calls and replays them with GL after presenting.
+struct SoftText { int x, y; float rgb[3]; char s[64]; };
+std::vector<SoftText> softTexts;
+bool softRecordText = false;
+
+void rBegin(GLenum mode) {
+    if (backend == BACKEND_GL) { glBegin(mode); return; }
+    softMode = mode;
+    softVerts.clear(); softColors.clear();
+}
+
+void rVertex2f(float x, float y) {
+    if (backend == BACKEND_GL) { glVertex2f(x, y); return; }
+    const SoftXform& m = softXf;
+    softVerts.push_back(m.a * x + m.c * y + m.tx);
+    softVerts.push_back(m.b * x + m.d * y + m.ty);
+    softColors.push_back(softColor);
+}
+
+void rColor3f(float r, float g, float b) {
+    if (backend == BACKEND_GL) { glColor3f(r, g, b); return; }
+    softRGB[0] = r; softRGB[1] = g; softRGB[2] = b;
+    softColor = packRGB(r, g, b);
+}
+
+void rEnd() {
+    if (backend == BACKEND_GL) { glEnd(); return; }
+    const float* v = softVerts.data();
+    int n = (int)softColors.size();
+    float lineW = std::max(1.0f, softLineW * softLineScale);
+    float pointSz = std::max(1.0f, softPointSz * softLineScale);
+    switch (softMode) {
+    case GL_QUADS:
+        for (int i = 0; i + 4 <= n; i += 4) softFillConvex(softFrame, v + 2 * i, 4, softColors[i + 3]);
+        break;
+    case GL_TRIANGLES:
+        for (int i = 0; i + 3 <= n; i += 3) softFillConvex(softFrame, v + 2 * i, 3, softColors[i + 2]);
+        break;
+    case GL_TRIANGLE_FAN:
+        if (n >= 3) softFillConvex(softFrame, v, n, softColors[n - 1]);
+        break;
+    case GL_POLYGON:
+        if (n >= 3) softFillConvex(softFrame, v, n, softColors[0]);
+        break;
+    case GL_LINES:
+        for (int i = 0; i + 2 <= n; i += 2)
+            softLine(softFrame, v[2 * i], v[2 * i + 1], v[2 * i + 2], v[2 * i + 3], lineW, softColors[i + 1]);
+        break;
+    case GL_LINE_STRIP:
+        for (int i = 0; i + 1 < n; i++)
+            softLine(softFrame, v[2 * i], v[2 * i + 1], v[2 * i + 2], v[2 * i + 3], lineW, softColors[i + 1]);
+        break;
+    case GL_LINE_LOOP:
+        for (int i = 0; i < n && n >= 2; i++) {
+            int j = (i + 1) % n;
+            softLine(softFrame, v[2 * i], v[2 * i + 1], v[2 * j], v[2 * j + 1], lineW, softColors[j]);
+        }
+        break;
+    case GL_POINTS:
+        for (int i = 0; i < n; i++) softPoint(softFrame, v[2 * i], v[2 * i + 1], pointSz, softColors[i]);
+        break;
+    }
+}
+
+void rPushMatrix() {
+    if (backend == BACKEND_GL) { glPushMatrix(); return; }
+    softXfStack.push_back(softXf);
+}
+
+void rPopMatrix() {
+    if (backend == BACKEND_GL) { glPopMatrix(); return; }
+    softXf = softXfStack.back();
+    softXfStack.pop_back();
+}
+
+void rTranslatef(float x, float y, float z) {
+    if (backend == BACKEND_GL) { glTranslatef(x, y, z); return; }
+    SoftXform& m = softXf;
+    m.tx += m.a * x + m.c * y;
+    m.ty += m.b * x + m.d * y;
+}
+
+// rotation about +Z only (all this game uses)
+void rRotatef(float deg, float x, float y, float z) {
+    if (backend == BACKEND_GL) { glRotatef(deg, x, y, z); return; }
+    float rad = deg * 0.017453293f, cs, sn;
+    fastSinCos(rad, sn, cs);
+    SoftXform& m = softXf;
+    SoftXform r = m;
+    r.a = m.a * cs + m.c * sn;  r.b = m.b * cs + m.d * sn;
+    r.c = -m.a * sn + m.c * cs; r.d = -m.b * sn + m.d * cs;
+    m = r;
+}
+
+void rLineWidth(float w) {
+    if (backend == BACKEND_GL) { glLineWidth(w); return; }
+    softLineW = w;
+}
+
+void rPointSize(float s) {
+    if (backend == BACKEND_GL) { glPointSize(s); return; }
+    softPointSz = s;
+}
+
+// Limit drawing to the game area (overlays that would spill onto the panels)
+SoftRect softClipSaved;
+
+void rClipGameArea(bool on) {
+    if (backend == BACKEND_GL) {
+        if (on) { glScissor(0, GAME_Y0, W, GAME_Y1 - GAME_Y0); glEnable(GL_SCISSOR_TEST); }
+        else glDisable(GL_SCISSOR_TEST);
+        return;
+    }
+    if (!on) { softFrame.clip = softClipSaved; return; }
+    const SoftXform& m = softXf;
+    SoftRect g = { (int)floorf(m.tx + 0.5f), (int)floorf(GAME_Y0 * m.d + m.ty + 0.5f),
+                   (int)floorf(W * m.a + m.tx + 0.5f), (int)floorf(GAME_Y1 * m.d + m.ty + 0.5f) };
+    softClipSaved = softFrame.clip;
+    softFrame.clip = rectIntersect(softClipSaved, g);
+}
+
+// Many points in one call from interleaved x,y: a vertex array on GL, one
+// softPoints batch on the CPU (scale/translate transforms only)
+void rPoints(const float* xy, int n) {
+    if (n <= 0) return;
+    if (backend == BACKEND_GL) {
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glVertexPointer(2, GL_FLOAT, 0, xy);
+        glDrawArrays(GL_POINTS, 0, n);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        return;
+    }
+    const SoftXform& m = softXf;
+    softPoints(softFrame, xy, n, m.a, m.d, m.tx, m.ty, std::max(1.0f, softPointSz * softLineScale), softColor);
+}
+
 // ---------------- Print (sample 4 compatible) ----------------
 void print(int x, int y, const char* s) {
+    if (backend == BACKEND_SOFT) {
+        if (!softRecordText) return;
+        SoftText t; t.x = x; t.y = y;
+        memcpy(t.rgb, softRGB, sizeof(t.rgb));
+        strncpy(t.s, s, sizeof(t.s) - 1); t.s[sizeof(t.s) - 1] = 0;
+        softTexts.push_back(t);
+        return;
+    }
     glRasterPos2f((float)x, (float)y);
     for (const char* p = s; *p; ++p) glutBitmapCharacter(GLUT_BITMAP_9_BY_15, *p);
 }
 
 // ---------------- Object Types ----------------
-enum ObjType { OBJ_OBSTACLE = 0, OBJ_COLLECT = 1, OBJ_PU_SPEED = 2, OBJ_PU_SHIELD = 3 };
+enum ObjType { OBJ_OBSTACLE = 0, OBJ_COLLECT = 1, OBJ_PU_SPEED = 2, OBJ_PU_SHIELD = 3, OBJ_PU_MAGNET = 4 };
 
 struct Obj {
     float x, y, r;
@@ -60,16 +310,115 @@ std::vector<Obj> obstacles;
 std::vector<Obj> collectibles;
 std::vector<Obj> powerups; // contains both types (distinguished by .type)
 
+// Wall tiles over the game area (1 bit each), sized in initScene
+TileMap walls;
+
+// Rotated boxes and convex polygons; *Blocks are the SoA copies tryMove scans
+std::vector<OBox> boxes;
+std::vector<ConvexPoly> polys;
+std::vector<BoxBlock> boxBlocks;
+std::vector<PolyBlock> polyBlocks;
+int shapesPlaced = 0;   // varies angle / side count of the next placed shape
+
+void rebuildShapeBlocks() {
+    buildBoxBlocks(boxes, boxBlocks);
+    buildPolyBlocks(polys, polyBlocks);
+}
+
+// Squares, boxes and polygons bucketed in one grid by bounding box (ids are
+// kind << 24 | index); circleBlocked and bolts query it. Adding a shape
+// inserts it, destroyShape edits only the cells of the shapes it touches.
+SpatialGrid obstacleGrid;
+std::vector<CellRange> squareCells, boxCells, polyCells;
+
+int shapeId(ShapeKind k, int i) { return (int)k << 24 | i; }
+
+std::vector<CellRange>& shapeCells(ShapeKind k) {
+    return k == SHAPE_SQUARE ? squareCells : (k == SHAPE_BOX ? boxCells : polyCells);
+}
+
+// Bounding circle of a placed shape (also its swarm avoid circle)
+void shapeBounds(ShapeKind k, int i, float& x, float& y, float& r) {
+    if (k == SHAPE_SQUARE) { const Obj& o = obstacles[i]; x = o.x; y = o.y; r = o.r * 1.414f; }
+    else if (k == SHAPE_BOX) { const OBox& b = boxes[i]; x = b.x; y = b.y; r = sqrtf(b.hx * b.hx + b.hy * b.hy); }
+    else polyBounds(polys[i], x, y, r);
+}
+
+// Call right after pushing shape i
+void indexShape(ShapeKind k, int i) {
+    float x, y, r; shapeBounds(k, i, x, y, r);
+    CellRange cr = obstacleGrid.range(x - r, y - r, x + r, y + r);
+    std::vector<CellRange>& cells = shapeCells(k);
+    if ((int)cells.size() <= i) cells.resize(i + 1);
+    cells[i] = cr;
+    obstacleGrid.insert(shapeId(k, i), cr);
+}
+
+// Full rebuild, for bulk changes only (restoring a layout)
+void reindexShapes() {
+    obstacleGrid.clear();
+    squareCells.clear(); boxCells.clear(); polyCells.clear();
+    for (int i = 0; i < (int)obstacles.size(); i++) indexShape(SHAPE_SQUARE, i);
+    for (int i = 0; i < (int)boxes.size(); i++) indexShape(SHAPE_BOX, i);
+    for (int i = 0; i < (int)polys.size(); i++) indexShape(SHAPE_POLY, i);
+}
+
+// First shape the circle touches (grid candidates, exact test), or -1
+int shapeHitAt(float x, float y, float r) {
+    int found = -1;
+    obstacleGrid.query(x - r, y - r, x + r, y + r, [&](int id) {
+        int i = id & 0xFFFFFF;
+        bool hit;
+        if ((id >> 24) == SHAPE_SQUARE) {
+            const Obj& o = obstacles[i];
+            hit = dist2(x, y, clampf(x, o.x - o.r, o.x + o.r), clampf(y, o.y - o.r, o.y + o.r)) < r * r;
+        }
+        else if ((id >> 24) == SHAPE_BOX) hit = circleHitsBox(boxes[i], x, y, r);
+        else hit = circleHitsPoly(polys[i], x, y, r);
+        if (hit) found = id;
+        return hit;
+    });
+    return found;
+}
+
+// Squares patrolling editor-drawn Bezier paths (Movers.h), gridded over the game area
+MoverSet movers;
+bool  moverPending = false;           // first click of a path placed
+float moverStartX = 0, moverStartY = 0;
+
+// S-curve from a to b: inner control points at 1/3 and 2/3, bent to opposite sides
+void makeMoverPath(float ax, float ay, float bx, float by, float p[4][2]) {
+    float dx = bx - ax, dy = by - ay, l = sqrtf(dx * dx + dy * dy);
+    float nx = l > 0 ? -dy / l * MOVER_BEND : 0, ny = l > 0 ? dx / l * MOVER_BEND : 0;
+    p[0][0] = ax;                       p[0][1] = ay;
+    p[1][0] = ax + dx / 3 + nx;         p[1][1] = ay + dy / 3 + ny;
+    p[2][0] = ax + dx * 2 / 3 - nx;     p[2][1] = ay + dy * 2 / 3 - ny;
+    p[3][0] = bx;                       p[3][1] = by;
+}
+
+// The curve stays inside its control points' box, so a patrol that misses
+// this box grown by the square never sweeps over the ship's start
+bool moverPathHitsSpawn(const float p[4][2]) {
+    float x0 = p[0][0], x1 = p[0][0], y0 = p[0][1], y1 = p[0][1];
+    for (int k = 1; k < 4; k++) {
+        x0 = std::min(x0, p[k][0]); x1 = std::max(x1, p[k][0]);
+        y0 = std::min(y0, p[k][1]); y1 = std::max(y1, p[k][1]);
+    }
+    float g = MOVER_HALF + MOVER_CLEAR, sx = W * 0.5f, sy = GAME_Y0 + 40.0f; // startRound's spawn
+    return sx > x0 - g && sx < x1 + g && sy > y0 - g && sy < y1 + g;
+}
+
 // ---------------- Player & Target ----------------
 struct Player {
     float x = W * 0.5f, y = GAME_Y0 + 40.0f;
     float r = 14.0f;
     float angleDeg = 90.0f; // faces up initially
-    int lives = MAX_LIVES;
+    int lives = rules.maxLives;
     int score = 0;
     bool shielded = false;
     float shieldUntil = 0.0f; // absolute time (seconds)
     float speedUntil = 0.0f;
+    float magnetUntil = 0.0f;
 } player;
 
 struct Target {
@@ -83,13 +432,8 @@ struct Target {
 
 // Safe Bezier: writes result in out[2]
 void bezierPoint(float t, const int* p0, const int* p1, const int* p2, const int* p3, int out[2]) {
-    float u = 1.0f - t;
-    float uu = u * u;
-    float tt = t * t;
-    float uuu = uu * u;
-    float ttt = tt * t;
-    float x = uuu * p0[0] + 3 * u * u * t * p1[0] + 3 * u * tt * p2[0] + ttt * p3[0];
-    float y = uuu * p0[1] + 3 * u * u * t * p1[1] + 3 * u * tt * p2[1] + ttt * p3[1];
+    float x = bezier1(t, (float)p0[0], (float)p1[0], (float)p2[0], (float)p3[0]);
+    float y = bezier1(t, (float)p0[1], (float)p1[1], (float)p2[1], (float)p3[1]);
     out[0] = (int)x; out[1] = (int)y;
 }
 
@@ -99,12 +443,28 @@ float nextHitTime = 0.0f; // when we’re allowed to take damage again
 enum Phase { PHASE_EDIT = 0, PHASE_PLAY = 1, PHASE_WIN = 2, PHASE_LOSE = 3 };
 Phase phase = PHASE_EDIT;
 
-enum PlaceMode { PLACE_NONE = 0, PLACE_OBS = 1, PLACE_COL = 2, PLACE_PU_SPEED = 3, PLACE_PU_SHIELD = 4 };
+enum PlaceMode { PLACE_NONE = 0, PLACE_OBS = 1, PLACE_COL = 2, PLACE_PU_SPEED = 3, PLACE_PU_SHIELD = 4, PLACE_TILE = 5, PLACE_BOX = 6, PLACE_POLY = 7, PLACE_MOVER = 8,
+                 PLACE_PU_MAGNET = 9 };
 PlaceMode placeMode = PLACE_NONE;
 
 float timeSec = 0.0f;     // global time since program start
 float roundStart = 0.0f;  // time when play started
-int   timeLeft = ROUND_TIME_SEC;
+int   timeLeft = (int)rules.roundTime;
+
+// Fast-forward (see Timer)
+int    ffLevel = 0;                  // index in FF_SCALES
+double ffDebt = 0;                   // simulated seconds not yet ticked
+double ffSimSec = 0, ffWallSec = 0;  // current measuring window
+float  ffAchieved = 1;               // simulated / wall seconds, last window
+
+int ffScale() { return FF_SCALES[ffLevel]; }
+
+void setFastForward(int level) {
+    ffLevel = level;
+    ffDebt = ffSimSec = ffWallSec = 0;
+    ffAchieved = (float)ffScale();
+    printf("fast-forward: %dx\n", ffScale());
+}
 
 // Input
 bool keyW = false, keyA = false, keyS = false, keyD = false;
@@ -117,206 +477,267 @@ float bgShift = 0.0f;
 
 // Simple quad
 void drawQuad(float x, float y, float w, float h) {
-    glBegin(GL_QUADS);
-    glVertex2f(x, y);
-    glVertex2f(x + w, y);
-    glVertex2f(x + w, y + h);
-    glVertex2f(x, y + h);
-    glEnd();
+    rBegin(GL_QUADS);
+    rVertex2f(x, y);
+    rVertex2f(x + w, y);
+    rVertex2f(x + w, y + h);
+    rVertex2f(x, y + h);
+    rEnd();
+}
+
+// Constexpr mesh (Meshes.h) placed at (cx,cy), scaled by s
+template <int N>
+void emitMesh(const Mesh<N>& m, float cx, float cy, float s) {
+    for (int i = 0; i < N; i++) rVertex2f(cx + m.v[i].x * s, cy + m.v[i].y * s);
 }
 
-// Circle (triangle fan)
+template <int N>
+void drawMesh(GLenum mode, const Mesh<N>& m, float cx, float cy, float s) {
+    rBegin(mode);
+    emitMesh(m, cx, cy, s);
+    rEnd();
+}
+
+// Circle (triangle fan); seg picks one of the precomputed fans
 void drawCircle(float cx, float cy, float r, int seg = 32) {
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2f(cx, cy);
-    for (int i = 0; i <= seg; i++) {
-        float a = (float)i / seg * 6.2831853f;
-        glVertex2f(cx + cosf(a) * r, cy + sinf(a) * r);
+    switch (seg) {
+    case 16: drawMesh(GL_TRIANGLE_FAN, CIRCLE_FAN_16, cx, cy, r); break;
+    case 20: drawMesh(GL_TRIANGLE_FAN, CIRCLE_FAN_20, cx, cy, r); break;
+    case 24: drawMesh(GL_TRIANGLE_FAN, CIRCLE_FAN_24, cx, cy, r); break;
+    case 28: drawMesh(GL_TRIANGLE_FAN, CIRCLE_FAN_28, cx, cy, r); break;
+    default: drawMesh(GL_TRIANGLE_FAN, CIRCLE_FAN_32, cx, cy, r); break;
     }
-    glEnd();
 }
 
 // Heart icon: uses the CURRENT color the caller sets.
 // (Two circles + triangle; no glColor calls inside.)
 void drawHeart(float cx, float cy, float s) {
-    // two circles
-    drawCircle(cx - 0.3f * s, cy, 0.35f * s, 20);
-    drawCircle(cx + 0.3f * s, cy, 0.35f * s, 20);
-    // bottom triangle
-    glBegin(GL_TRIANGLES);
-    glVertex2f(cx - 0.75f * s, cy);
-    glVertex2f(cx + 0.75f * s, cy);
-    glVertex2f(cx, cy - 0.9f * s);
-    glEnd();
+    drawCircle(cx - HEART_LOBE_X * s, cy, HEART_LOBE_R * s, 20);
+    drawCircle(cx + HEART_LOBE_X * s, cy, HEART_LOBE_R * s, 20);
+    drawMesh(GL_TRIANGLES, HEART_TRI, cx, cy, s);
 }
 
 
+// Exhaust flame length (also a glow source)
+float exhaustFlame() { return 6.0f + 4.0f * (0.5f + 0.5f * fastSin(timeSec * 18.0f)); }
+
+// Gentle bob of collectibles/power-ups (scaled per type by the caller)
+float bobOffset() { return fastSin(timeSec * 2.2f) * 4.0f; }
+
 // Player (>=4 primitives): circle body, triangle nose, line “visor”, point accent
 // Fancy spaceship player: polygon hull + 2 fins (triangles) + cockpit (circle)
 // + outline (line loop) + animated exhaust triangle. Shield ring kept.
 void drawPlayer(const Player& p) {
-    glPushMatrix();
-    glTranslatef(p.x, p.y, 0);
-    glRotatef(p.angleDeg, 0, 0, 1);
+    rPushMatrix();
+    rTranslatef(p.x, p.y, 0);
+    rRotatef(p.angleDeg, 0, 0, 1);
 
-    float L = p.r * 2.2f;   // hull length along +X
-    float H = p.r * 1.2f;   // hull half-height
+    float s = p.r;          // ship meshes are in units of r
 
     // --- HULL (polygon) ---
-    glBegin(GL_POLYGON);
-    glColor3f(0.18f, 0.65f, 0.95f); glVertex2f(+L * 0.55f, 0);        // nose
-    glColor3f(0.10f, 0.40f, 0.80f); glVertex2f(+L * 0.10f, +H * 0.95f); // top shoulder
-    glVertex2f(-L * 0.25f, +H * 0.70f);
-    glVertex2f(-L * 0.55f, 0);
-    glVertex2f(-L * 0.25f, -H * 0.70f);
-    glVertex2f(+L * 0.10f, -H * 0.95f);
-    glEnd();
+    rBegin(GL_POLYGON);
+    rColor3f(0.18f, 0.65f, 0.95f); rVertex2f(SHIP_HULL.v[0].x * s, SHIP_HULL.v[0].y * s); // nose
+    rColor3f(0.10f, 0.40f, 0.80f);
+    for (int i = 1; i < SHIP_HULL.count; i++) rVertex2f(SHIP_HULL.v[i].x * s, SHIP_HULL.v[i].y * s);
+    rEnd();
 
     // --- FINS (two triangles) ---
-    glColor3f(0.85f, 0.2f, 0.2f);
-    glBegin(GL_TRIANGLES);
-    // top fin
-    glVertex2f(-L * 0.18f, +H * 0.65f);
-    glVertex2f(-L * 0.60f, +H * 1.15f);
-    glVertex2f(-L * 0.35f, +H * 0.40f);
-    // bottom fin
-    glVertex2f(-L * 0.18f, -H * 0.65f);
-    glVertex2f(-L * 0.60f, -H * 1.15f);
-    glVertex2f(-L * 0.35f, -H * 0.40f);
-    glEnd();
+    rColor3f(0.85f, 0.2f, 0.2f);
+    drawMesh(GL_TRIANGLES, SHIP_FINS, 0, 0, s);
 
     // --- COCKPIT (circle) ---
-    glColor3f(1, 1, 1);
-    drawCircle(+L * 0.18f, 0, p.r * 0.45f, 24);
+    rColor3f(1, 1, 1);
+    drawCircle(SHIP_COCKPIT_X * s, 0, SHIP_COCKPIT_R * s, 24);
 
     // --- OUTLINE (line loop) ---
-    glColor3f(0.05f, 0.08f, 0.15f);
-    glBegin(GL_LINE_LOOP);
-    glVertex2f(+L * 0.55f, 0);
-    glVertex2f(+L * 0.10f, +H * 0.95f);
-    glVertex2f(-L * 0.25f, +H * 0.70f);
-    glVertex2f(-L * 0.55f, 0);
-    glVertex2f(-L * 0.25f, -H * 0.70f);
-    glVertex2f(+L * 0.10f, -H * 0.95f);
-    glEnd();
+    rColor3f(0.05f, 0.08f, 0.15f);
+    drawMesh(GL_LINE_LOOP, SHIP_HULL, 0, 0, s);
 
     // --- EXHAUST FLAME (animated triangle) ---
-    float flame = 6.0f + 4.0f * (0.5f + 0.5f * sinf(timeSec * 18.0f));
-    glBegin(GL_TRIANGLES);
-    glColor3f(1.0f, 0.75f, 0.2f); glVertex2f(-L * 0.55f, 4.0f);
-    glColor3f(1.0f, 0.50f, 0.0f); glVertex2f(-L * 0.55f, -4.0f);
-    glColor3f(1.0f, 0.25f, 0.0f); glVertex2f(-L * 0.55f - flame, 0.0f);
-    glEnd();
+    float tail = SHIP_TAIL_X * s, flame = exhaustFlame();
+    rBegin(GL_TRIANGLES);
+    rColor3f(1.0f, 0.75f, 0.2f); rVertex2f(tail, 4.0f);
+    rColor3f(1.0f, 0.50f, 0.0f); rVertex2f(tail, -4.0f);
+    rColor3f(1.0f, 0.25f, 0.0f); rVertex2f(tail - flame, 0.0f);
+    rEnd();
 
-    glPopMatrix();
+    rPopMatrix();
 
     // Shield ring (unchanged)
     if (p.shielded) {
-        glColor3f(0.8f, 0.8f, 1.0f);
-        glLineWidth(2);
-        glBegin(GL_LINE_LOOP);
-        for (int i = 0; i < 40; i++) {
-            float a = (float)i / 40 * 6.2831853f;
-            glVertex2f(p.x + cosf(a) * (p.r + 7), p.y + sinf(a) * (p.r + 7));
-        }
-        glEnd();
-        glLineWidth(1);
+        rColor3f(0.8f, 0.8f, 1.0f);
+        rLineWidth(2);
+        drawMesh(GL_LINE_LOOP, CIRCLE_LOOP_40, p.x, p.y, p.r + 7);
+        rLineWidth(1);
     }
 }
 
 
 // Obstacle (>=2 primitives): a filled quad + an X line over it
 void drawObstacle(const Obj& o) {
-    glColor3f(0.6f, 0.2f, 0.2f);
-    drawQuad(o.x - o.r, o.y - o.r, 2 * o.r, 2 * o.r);
-    glColor3f(0.1f, 0.0f, 0.0f);
-    glBegin(GL_LINES);
-    glVertex2f(o.x - o.r, o.y - o.r); glVertex2f(o.x + o.r, o.y + o.r);
-    glVertex2f(o.x + o.r, o.y - o.r); glVertex2f(o.x - o.r, o.y + o.r);
-    glEnd();
+    rColor3f(0.6f, 0.2f, 0.2f);
+    drawMesh(GL_QUADS, UNIT_QUAD, o.x, o.y, o.r);
+    rColor3f(0.1f, 0.0f, 0.0f);
+    drawMesh(GL_LINES, UNIT_CROSS, o.x, o.y, o.r);
 }
 
 // Collectible (>=3 primitives): triangle + line + point; bobbing handled outside
 void drawCollectible(const Obj& c) {
-    glColor3f(1, 0.84f, 0);
-    glBegin(GL_TRIANGLES);
-    glVertex2f(c.x, c.y + c.r);
-    glVertex2f(c.x - c.r * 0.8f, c.y - c.r * 0.6f);
-    glVertex2f(c.x + c.r * 0.8f, c.y - c.r * 0.6f);
-    glEnd();
-    glColor3f(0.2f, 0.2f, 0);
-    glBegin(GL_LINES);
-    glVertex2f(c.x, c.y + c.r * 0.2f);
-    glVertex2f(c.x, c.y - c.r * 0.8f);
-    glEnd();
-    glPointSize(3);
-    glBegin(GL_POINTS);
-    glVertex2f(c.x, c.y);
-    glEnd();
+    rColor3f(1, 0.84f, 0);
+    drawMesh(GL_TRIANGLES, COIN_TRI, c.x, c.y, c.r);
+    rColor3f(0.2f, 0.2f, 0);
+    drawMesh(GL_LINES, COIN_LINE, c.x, c.y, c.r);
+    rPointSize(3);
+    rBegin(GL_POINTS);
+    rVertex2f(c.x, c.y);
+    rEnd();
 }
 
 // Powerup A (speed): diamond + outline (>=2 primitives)
 void drawPowerupSpeed(const Obj& p) {
-    glColor3f(0.2f, 1.0f, 0.4f);
-    glBegin(GL_POLYGON);
-    glVertex2f(p.x, p.y + p.r);
-    glVertex2f(p.x + p.r, p.y);
-    glVertex2f(p.x, p.y - p.r);
-    glVertex2f(p.x - p.r, p.y);
-    glEnd();
-    glColor3f(0, 0.3f, 0.1f);
-    glBegin(GL_LINE_LOOP);
-    glVertex2f(p.x, p.y + p.r);
-    glVertex2f(p.x + p.r, p.y);
-    glVertex2f(p.x, p.y - p.r);
-    glVertex2f(p.x - p.r, p.y);
-    glEnd();
+    rColor3f(0.2f, 1.0f, 0.4f);
+    drawMesh(GL_POLYGON, DIAMOND, p.x, p.y, p.r);
+    rColor3f(0, 0.3f, 0.1f);
+    drawMesh(GL_LINE_LOOP, DIAMOND, p.x, p.y, p.r);
 }
 
 // Powerup B (shield): star (two triangles) + circle outline (>=2 primitives)
 void drawPowerupShield(const Obj& p) {
-    glColor3f(0.7f, 0.7f, 1.0f);
-    glBegin(GL_TRIANGLES);
-    glVertex2f(p.x, p.y + p.r);
-    glVertex2f(p.x + p.r * 0.9f, p.y - p.r * 0.2f);
-    glVertex2f(p.x - p.r * 0.9f, p.y - p.r * 0.2f);
-    glEnd();
-    glBegin(GL_TRIANGLES);
-    glVertex2f(p.x, p.y - p.r);
-    glVertex2f(p.x + p.r * 0.9f, p.y + p.r * 0.2f);
-    glVertex2f(p.x - p.r * 0.9f, p.y + p.r * 0.2f);
-    glEnd();
-    glColor3f(0.2f, 0.2f, 0.6f);
-    glBegin(GL_LINE_LOOP);
-    for (int i = 0; i < 24; i++) {
-        float a = (float)i / 24 * 6.2831853f;
-        glVertex2f(p.x + cosf(a) * (p.r + 3), p.y + sinf(a) * (p.r + 3));
-    }
-    glEnd();
+    rColor3f(0.7f, 0.7f, 1.0f);
+    drawMesh(GL_TRIANGLES, STAR, p.x, p.y, p.r);
+    rColor3f(0.2f, 0.2f, 0.6f);
+    drawMesh(GL_LINE_LOOP, CIRCLE_LOOP_24, p.x, p.y, p.r + 3);
+}
+
+// Powerup C (magnet): horseshoe strip + pole tips (>=2 primitives)
+void drawPowerupMagnet(const Obj& p) {
+    rLineWidth(4);
+    rColor3f(0.85f, 0.15f, 0.15f);
+    drawMesh(GL_LINE_STRIP, MAGNET_U, p.x, p.y, p.r);
+    rColor3f(0.85f, 0.85f, 0.9f);
+    drawMesh(GL_LINES, MAGNET_TIPS, p.x, p.y, p.r);
+    rLineWidth(1);
 }
 
 void drawPowerup(const Obj& p) {
-    if (p.type == OBJ_PU_SPEED)  drawPowerupSpeed(p);
-    else                      drawPowerupShield(p);
+    if (p.type == OBJ_PU_SPEED)       drawPowerupSpeed(p);
+    else if (p.type == OBJ_PU_MAGNET) drawPowerupMagnet(p);
+    else                              drawPowerupShield(p);
 }
 
 // Target: circle + crosshair
 void drawTarget(const Target& t) {
-    glColor3f(1, 0.3f, 0.3f);
+    rColor3f(1, 0.3f, 0.3f);
     drawCircle((float)t.p0[0], (float)t.p0[1], t.r, 28); // we’ll pass current pos in p0 during display
-    glColor3f(0.4f, 0, 0);
-    glBegin(GL_LINES);
-    glVertex2f(t.p0[0] - t.r, t.p0[1]); glVertex2f(t.p0[0] + t.r, t.p0[1]);
-    glVertex2f(t.p0[0], t.p0[1] - t.r); glVertex2f(t.p0[0], t.p0[1] + t.r);
-    glEnd();
+    rColor3f(0.4f, 0, 0);
+    drawMesh(GL_LINES, UNIT_PLUS, (float)t.p0[0], (float)t.p0[1], t.r);
+}
+
+// Wall tiles: one batched quad list, each horizontal run of tiles is one quad
+void drawTiles(const TileMap& tm) {
+    rColor3f(0.28f, 0.30f, 0.38f);
+    rBegin(GL_QUADS);
+    for (int r = 0; r < tm.rows; r++) {
+        float y0 = tm.y0 + r * tm.size, y1 = y0 + tm.size;
+        tileForEachRun(tm, r, [&](int c0, int c1) {
+            float x0 = tm.x0 + c0 * tm.size, x1 = tm.x0 + c1 * tm.size;
+            rVertex2f(x0, y0); rVertex2f(x1, y0); rVertex2f(x1, y1); rVertex2f(x0, y1);
+        });
+    }
+    rEnd();
+}
+
+// Palette icon for wall tiles: a small brick block
+void drawWallIcon(float cx, float cy, float s) {
+    rColor3f(0.28f, 0.30f, 0.38f);
+    drawMesh(GL_QUADS, UNIT_QUAD, cx, cy, s);
+    rColor3f(0.5f, 0.53f, 0.62f);
+    rBegin(GL_LINES);
+    rVertex2f(cx - s, cy); rVertex2f(cx + s, cy);
+    rVertex2f(cx, cy); rVertex2f(cx, cy + s);
+    rVertex2f(cx - s * 0.5f, cy); rVertex2f(cx - s * 0.5f, cy - s);
+    rVertex2f(cx + s * 0.5f, cy); rVertex2f(cx + s * 0.5f, cy - s);
+    rEnd();
+}
+
+// Convex obstacle: filled polygon + outline
+void drawConvex(const float* px, const float* py, int n) {
+    rColor3f(0.2f, 0.45f, 0.5f);
+    rBegin(GL_POLYGON);
+    for (int i = 0; i < n; i++) rVertex2f(px[i], py[i]);
+    rEnd();
+    rColor3f(0.05f, 0.15f, 0.2f);
+    rBegin(GL_LINE_LOOP);
+    for (int i = 0; i < n; i++) rVertex2f(px[i], py[i]);
+    rEnd();
+}
+
+void drawBox(const OBox& b) {
+    float px[4], py[4];
+    boxCorners(b, px, py);
+    drawConvex(px, py, 4);
+}
+
+void drawPoly(const ConvexPoly& p) { drawConvex(p.px, p.py, p.n); }
+
+// Moving obstacle: orange square + inner square outline
+void drawMover(float x, float y, float h) {
+    rColor3f(0.95f, 0.55f, 0.1f);
+    drawMesh(GL_QUADS, UNIT_QUAD, x, y, h);
+    rColor3f(0.4f, 0.2f, 0.0f);
+    drawMesh(GL_LINE_LOOP, UNIT_QUAD, x, y, h * 0.5f);
+}
+
+// Patrol path of mover i (edit mode only)
+void drawMoverPath(const MoverSet& m, int i) {
+    rColor3f(0.95f, 0.7f, 0.45f);
+    rBegin(GL_LINE_STRIP);
+    for (int k = 0; k <= 24; k++) {
+        float t = k / 24.0f;
+        rVertex2f(bezier1(t, m.ax[i], m.bx[i], m.cx[i], m.dx[i]), bezier1(t, m.ay[i], m.by[i], m.cy[i], m.dy[i]));
+    }
+    rEnd();
+}
+
+// Shapes the editor places: box turns 22.5 deg and polygon gains a side per placement
+OBox makeEditorBox(float x, float y, int k) {
+    OBox b = { x, y, BOX_HX, BOX_HY, k * (PI_F / 8) };
+    return b;
+}
+
+ConvexPoly makeEditorPoly(float x, float y, int k) {
+    ConvexPoly p;
+    p.n = 3 + k % 5;
+    for (int i = 0; i < p.n; i++) {
+        float a = k * 0.4f + TWO_PI_F * i / p.n, sn, cs;
+        fastSinCos(a, sn, cs);
+        p.px[i] = x + cs * POLY_R; p.py[i] = y + sn * POLY_R;
+    }
+    return p;
 }
 
 // ---------------- Placement & Overlap ----------------
+// Any center of v closer than sqrt(r2) to (x,y), four per step
+bool anyWithin(const std::vector<Obj>& v, float x, float y, float r2) {
+    size_t i = 0, n = v.size();
+#ifdef MATH2D_SSE
+    float4 px = f4(x), py = f4(y), rr = f4(r2);
+    for (; i + 4 <= n; i += 4) {
+        const Obj* o = &v[i];
+        float4 d = dist2_4(px, py, f4(o[0].x, o[1].x, o[2].x, o[3].x), f4(o[0].y, o[1].y, o[2].y, o[3].y));
+        if (any4(lt4(d, rr))) return true;
+    }
+#endif
+    for (; i < n; i++) if (dist2(x, y, v[i].x, v[i].y) < r2) return true;
+    return false;
+}
+
 bool overlapsAny(float x, float y, float r) {
     float r2 = (r + PLACE_MIN_DIST) * (r + PLACE_MIN_DIST);
-    for (auto& o : obstacles)   if (dist2(x, y, o.x, o.y) < r2) return true;
-    for (auto& c : collectibles)if (dist2(x, y, c.x, c.y) < r2) return true;
-    for (auto& p : powerups)    if (dist2(x, y, p.x, p.y) < r2) return true;
+    if (anyWithin(obstacles, x, y, r2) || anyWithin(collectibles, x, y, r2) || anyWithin(powerups, x, y, r2)) return true;
+    if (tileCircleHits(walls, x, y, r)) return true;
+    float gap = r + PLACE_MIN_DIST * 0.5f;
+    if (circleHitsBoxes(boxBlocks, x, y, gap) || circleHitsPolys(polyBlocks, x, y, gap)) return true;
     // also avoid placing on player or target current pos
     if (dist2(x, y, player.x, player.y) < r2) return true;
     int curT[2]; bezierPoint(target.t, target.p0, target.p1, target.p2, target.p3, curT);
@@ -324,6 +745,218 @@ bool overlapsAny(float x, float y, float r) {
     return false;
 }
 
+// ---------------- Collectible Index ----------------
+// Collectibles bucketed by bounding box, built at round start and kept in
+// step during play: pickups swap-remove (removeCollectible), the magnet moves
+// them (updateMagnet). The ship and the magnet only look at nearby cells.
+SpatialGrid pickupGrid;
+std::vector<CellRange> collectCells;
+std::vector<uint8_t> collectPulled;   // moved by the magnet and out of spawnSpace
+bool magnetPulling = false;           // some collectibles are pulled
+std::vector<int> pickupIds;           // scratch
+
+CellRange collectRange(const Obj& c) { return pickupGrid.range(c.x - c.r, c.y - c.r, c.x + c.r, c.y + c.r); }
+
+void indexCollectibles() {
+    int n = (int)collectibles.size();
+    pickupGrid.clear();
+    collectCells.resize(n);
+    collectPulled.assign(n, 0);
+    magnetPulling = false;
+    for (int i = 0; i < n; i++) {
+        collectCells[i] = collectRange(collectibles[i]);
+        pickupGrid.insert(i, collectCells[i]);
+    }
+}
+
+// Collectibles whose circle comes within reach of (x, y), each once: an id
+// counts only in the first query cell its range overlaps
+void collectiblesNear(float x, float y, float reach, std::vector<int>& out) {
+    out.clear();
+    CellRange q = pickupGrid.range(x - reach, y - reach, x + reach, y + reach);
+    for (int r = q.r0; r <= q.r1; r++)
+        for (int c = q.c0; c <= q.c1; c++)
+            for (int id : pickupGrid.at(c, r)) {
+                const CellRange& cr = collectCells[id];
+                if (c != std::max(q.c0, cr.c0) || r != std::max(q.r0, cr.r0)) continue;
+                const Obj& o = collectibles[id];
+                if (dist2(x, y, o.x, o.y) < (reach + o.r) * (reach + o.r)) out.push_back(id);
+            }
+}
+
+// ---------------- Power-up Spawns ----------------
+// Every cell where overlapsAny would accept a power-up, kept up to date during
+// play: placed objects are disks of SPAWN_R + PLACE_MIN_DIST, walls, boxes and
+// polygons are re-judged where bolts destroy them. The ship, the target and
+// collectibles the magnet is pulling move, so samples near them are retried.
+FreeSpace spawnSpace;
+float nextSpawnAt = 0.0f;
+uint32_t spawnSeed = 1;
+
+// overlapsAny's wall and shape tests (plus the area edge) within pad of (x, y)
+bool spawnSolidAt(float x, float y, float pad) {
+    float r = SPAWN_R + pad;
+    if (x - r < 0 || x + r > W || y - r < GAME_Y0 || y + r > GAME_Y1) return true;
+    float gap = r + PLACE_MIN_DIST * 0.5f;
+    return tileCircleHits(walls, x, y, r) || circleHitsBoxes(boxBlocks, x, y, gap) || circleHitsPolys(polyBlocks, x, y, gap);
+}
+
+void spawnCover(const Obj& o, int delta) { spawnSpace.cover(o.x, o.y, SPAWN_R + PLACE_MIN_DIST, delta); }
+
+// Whole index from the layout; once per round
+void rebuildSpawnSpace() {
+    spawnSpace.init(0, (float)GAME_Y0, (float)W, (float)(GAME_Y1 - GAME_Y0), SPAWN_CELL);
+    spawnSpace.refreshAll(spawnSolidAt);
+    for (const auto& o : obstacles) spawnCover(o, 1);
+    for (int i = 0; i < (int)collectibles.size(); i++) if (!collectPulled[i]) spawnCover(collectibles[i], 1);
+    for (const auto& p : powerups) spawnCover(p, 1);
+}
+
+// Walls or shapes within r of (x, y) were destroyed
+void refreshSpawnSpace(float x, float y, float r) {
+    float g = r + SPAWN_R + PLACE_MIN_DIST;
+    spawnSpace.refresh(x - g, y - g, x + g, y + g, spawnSolidAt);
+}
+
+void spawnPowerup() {
+    int curT[2]; bezierPoint(target.t, target.p0, target.p1, target.p2, target.p3, curT);
+    float r2 = (SPAWN_R + PLACE_MIN_DIST) * (SPAWN_R + PLACE_MIN_DIST);
+    for (int tries = 0; tries < 8; tries++) {
+        float x, y;
+        if (!spawnSpace.sample(spawnSeed, x, y)) return;
+        if (dist2(x, y, player.x, player.y) < r2 || dist2(x, y, (float)curT[0], (float)curT[1]) < r2) continue;
+        if (magnetPulling) {
+            collectiblesNear(x, y, SPAWN_R + PLACE_MIN_DIST, pickupIds);
+            bool near = false;
+            for (int id : pickupIds) near |= collectPulled[id] != 0;
+            if (near) continue;
+        }
+        Obj o = { x, y, SPAWN_R, (ObjType)(OBJ_PU_SPEED + spawnSeed % 3) };
+        powerups.push_back(o);
+        spawnCover(o, 1);
+        return;
+    }
+}
+
+void updateSpawns() {
+    if (timeSec < nextSpawnAt) return;
+    nextSpawnAt = timeSec + SPAWN_EVERY;
+    if ((int)powerups.size() < SPAWN_MAX) spawnPowerup();
+}
+
+// ---------------- Magnet ----------------
+// Swap-remove, like destroyShape: the last collectible takes slot i
+void removeCollectible(int i) {
+    int last = (int)collectibles.size() - 1;
+    if (!collectPulled[i]) spawnCover(collectibles[i], -1);
+    pickupGrid.remove(i, collectCells[i]);
+    if (i != last) {
+        pickupGrid.relabel(last, i, collectCells[last]);
+        collectibles[i] = collectibles[last];
+        collectCells[i] = collectCells[last];
+        collectPulled[i] = collectPulled[last];
+    }
+    collectibles.pop_back(); collectCells.pop_back(); collectPulled.pop_back();
+}
+
+// While the magnet lasts, collectibles within MAGNET_RADIUS slide straight at
+// the ship (over walls and shapes) and their grid cells follow. A pulled one
+// leaves spawnSpace until the magnet ends, so it is uncovered only once.
+void updateMagnet(float dt) {
+    if (timeSec >= player.magnetUntil) {
+        if (!magnetPulling) return;
+        for (int i = 0; i < (int)collectibles.size(); i++)
+            if (collectPulled[i]) { spawnCover(collectibles[i], 1); collectPulled[i] = 0; }
+        magnetPulling = false;
+        return;
+    }
+    magnetPulling = true;
+    float step = MAGNET_PULL * dt;
+    collectiblesNear(player.x, player.y, MAGNET_RADIUS, pickupIds);
+    for (int id : pickupIds) {
+        Obj& c = collectibles[id];
+        if (!collectPulled[id]) { spawnCover(c, -1); collectPulled[id] = 1; }
+        float dx = player.x - c.x, dy = player.y - c.y, d = sqrtf(dx * dx + dy * dy);
+        float k = d > step ? step / d : 1.0f;
+        c.x += dx * k; c.y += dy * k;
+        CellRange cr = collectRange(c);
+        if (cr != collectCells[id]) { pickupGrid.move(id, collectCells[id], cr); collectCells[id] = cr; }
+    }
+}
+
+// ---------------- Wall Tiles ----------------
+// Perfect maze (iterative backtracker) on cells of `pitch` tiles: pitch-1 open
+// tiles plus one wall row/column. Everything outside the cell grid stays solid.
+void tileMaze(TileMap& tm, int pitch, uint32_t seed) {
+    for (int r = 0; r < tm.rows; r++)
+        for (int c = 0; c < tm.cols; c++) tm.set(c, r, true);
+
+    int cw = (tm.cols - 1) / pitch, ch = (tm.rows - 1) / pitch;
+    if (cw <= 0 || ch <= 0) return;
+    auto carve = [&](int c0, int r0, int c1, int r1) {   // inclusive tile box
+        for (int r = r0; r <= r1; r++)
+            for (int c = c0; c <= c1; c++) tm.set(c, r, false);
+    };
+    uint32_t s = seed ? seed : 1u;
+    auto rnd = [&]() { s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; };
+
+    std::vector<uint8_t> seen((size_t)cw * ch, 0);
+    std::vector<int> stack;
+    stack.push_back(0); seen[0] = 1;
+    carve(1, 1, pitch - 1, pitch - 1);
+    const int dx[4] = { 1, -1, 0, 0 }, dy[4] = { 0, 0, 1, -1 };
+    while (!stack.empty()) {
+        int cur = stack.back(), cx = cur % cw, cy = cur / cw;
+        int opts[4], n = 0;
+        for (int d = 0; d < 4; d++) {
+            int nx = cx + dx[d], ny = cy + dy[d];
+            if (nx >= 0 && nx < cw && ny >= 0 && ny < ch && !seen[ny * cw + nx]) opts[n++] = d;
+        }
+        if (n == 0) { stack.pop_back(); continue; }
+        int d = opts[rnd() % n], nx = cx + dx[d], ny = cy + dy[d];
+        seen[ny * cw + nx] = 1;
+        stack.push_back(ny * cw + nx);
+        // open the target cell and the wall between the two
+        int ax = std::min(cx, nx) * pitch + 1, ay = std::min(cy, ny) * pitch + 1;
+        int bx = std::max(cx, nx) * pitch + pitch - 1, by = std::max(cy, ny) * pitch + pitch - 1;
+        carve(ax, ay, bx, by);
+    }
+}
+
+// Clears every tile the circle touches
+void tileClearCircle(TileMap& tm, float x, float y, float r) {
+    int r0 = std::max(tm.rowAt(y - r), 0), r1 = std::min(tm.rowAt(y + r), tm.rows - 1);
+    int c0 = std::max(tm.colAt(x - r), 0), c1 = std::min(tm.colAt(x + r), tm.cols - 1);
+    for (int row = r0; row <= r1; row++)
+        for (int c = c0; c <= c1; c++) {
+            float tx = tm.x0 + c * tm.size, ty = tm.y0 + row * tm.size;
+            float qx = clampf(x, tx, tx + tm.size), qy = clampf(y, ty, ty + tm.size);
+            if (dist2(x, y, qx, qy) < r * r) tm.set(c, row, false);
+        }
+}
+
+// Editor brush: mouse drag paints (or erases, if the first tile was solid)
+bool tilePainting = false, tilePaintValue = true;
+float tileLastX = 0, tileLastY = 0;   // previous brush position (drag fills the gap)
+
+void paintTile(float x, float y, bool first) {
+    if (!inGameArea(x, y)) return;
+    int c = walls.colAt(x), r = walls.rowAt(y);
+    if (!walls.inside(c, r)) return;
+    if (first) tilePaintValue = !walls.get(c, r);
+    // never wall in the player
+    float tx = walls.x0 + (c + 0.5f) * walls.size, ty = walls.y0 + (r + 0.5f) * walls.size;
+    if (tilePaintValue && dist2(tx, ty, player.x, player.y) < (player.r + walls.size) * (player.r + walls.size)) return;
+    walls.set(c, r, tilePaintValue);
+}
+
+void paintTileStroke(float x, float y) {
+    float dx = x - tileLastX, dy = y - tileLastY;
+    int steps = (int)(sqrtf(dx * dx + dy * dy) / (walls.size * 0.5f)) + 1;
+    for (int i = 1; i <= steps; i++) paintTile(tileLastX + dx * i / steps, tileLastY + dy * i / steps, false);
+    tileLastX = x; tileLastY = y;
+}
+
 // ---------------- Sound and Music ------------------
 
 // Background music with MCI (mp3/wav) — looped
@@ -347,65 +980,98 @@ void sfxPlay(const wchar_t* path) {
 
 
 // ---------------- Panels ----------------
-void drawPanels() {
-    // moving background stripes (animation requirement)
+// moving background stripes (animation requirement); once per displayed frame
+void animatePanels() {
     bgShift += 0.2f;
     if (bgShift > 20) bgShift -= 20;
+}
 
+// Palette icon centers; Mouse hit-tests the same positions
+const int   PALETTE_N = 9;
+const float PALETTE_X[PALETTE_N] = { 44, 130, 216, 302, 388, 474, 560, 646, 732 };
+
+void paletteLabel(int i, const char* s) { print((int)(PALETTE_X[i] - 4.5f * strlen(s)), 18, s); }
+
+void drawPanels() {
     // Game area subtle moving stripes
-    glColor3f(0.95f, 0.98f, 1.0f);
+    rColor3f(0.95f, 0.98f, 1.0f);
     drawQuad(0, GAME_Y0, W, GAME_Y1 - GAME_Y0);
-    glColor3f(0.9f, 0.95f, 1.0f);
+    rColor3f(0.9f, 0.95f, 1.0f);
     for (int i = -5; i < W / 40 + 5; i++) {
         float x = i * 40.0f + fmodf(bgShift, 40.0f);
         drawQuad(x, GAME_Y0, 8, GAME_Y1 - GAME_Y0);
     }
 
     // Top panel
-    glColor3f(0.15f, 0.15f, 0.2f);
+    rColor3f(0.15f, 0.15f, 0.2f);
     drawQuad(0, H - TOP_H, W, TOP_H);
     // Bottom panel
-    glColor3f(0.15f, 0.15f, 0.2f);
+    rColor3f(0.15f, 0.15f, 0.2f);
     drawQuad(0, 0, W, BOT_H);
 
     // HUD: Hearts
-    for (int i = 0; i < MAX_LIVES; i++) {
+    for (int i = 0; i < rules.maxLives; i++) {
         float cx = 20.0f + i * 30.0f;
         float cy = H - 45.0f;
-        if (i < player.lives) glColor3f(1, 0, 0);              // full
-        else                 glColor3f(0.35f, 0.15f, 0.15f);   // “empty”/dim
+        if (i < player.lives) rColor3f(1, 0, 0);              // full
+        else                 rColor3f(0.35f, 0.15f, 0.15f);   // “empty”/dim
         drawHeart(cx, cy, 12.0f);
     }
 
 
     // HUD: Score & Time
     char buf[128];
-    glColor3f(1, 1, 1);
+    rColor3f(1, 1, 1);
     sprintf(buf, "Score: %d", player.score);
     print(W / 2 - 40, H - 30, buf);
     sprintf(buf, "Time: %d", timeLeft);
     print(W - 130, H - 30, buf);
+    if (ffScale() > 1) {
+        sprintf(buf, "FF %dx (%.0fx)", ffScale(), ffAchieved);
+        print(W - 300, H - 30, buf);
+    }
 
-    // Palette icons (bottom): obstacle, collectible, PU speed, PU shield
+    // Palette icons (bottom), one per PlaceMode at PALETTE_X[mode - 1]
+    const float py = BOT_H * 0.5f;
     // Obstacle icon
-    Obj tmp; tmp.x = 80; tmp.y = BOT_H * 0.5f; tmp.r = 18; tmp.type = OBJ_OBSTACLE;
+    Obj tmp; tmp.x = PALETTE_X[0]; tmp.y = py; tmp.r = 18; tmp.type = OBJ_OBSTACLE;
     drawObstacle(tmp);
-    print(55, 18, "Obstacle");
+    paletteLabel(0, "Obstacle");
 
     // Collectible icon
-    Obj tc; tc.x = 240; tc.y = BOT_H * 0.5f; tc.r = 16; tc.type = OBJ_COLLECT;
+    Obj tc; tc.x = PALETTE_X[1]; tc.y = py; tc.r = 16; tc.type = OBJ_COLLECT;
     drawCollectible(tc);
-    print(210, 18, "Collectible");
+    paletteLabel(1, "Collectible");
 
     // Speed PU
-    Obj ts; ts.x = 400; ts.y = BOT_H * 0.5f; ts.r = 16; ts.type = OBJ_PU_SPEED;
+    Obj ts; ts.x = PALETTE_X[2]; ts.y = py; ts.r = 16; ts.type = OBJ_PU_SPEED;
     drawPowerupSpeed(ts);
-    print(365, 18, "Speed PU");
+    paletteLabel(2, "Speed PU");
 
     // Shield PU
-    Obj th; th.x = 560; th.y = BOT_H * 0.5f; th.r = 16; th.type = OBJ_PU_SHIELD;
+    Obj th; th.x = PALETTE_X[3]; th.y = py; th.r = 16; th.type = OBJ_PU_SHIELD;
     drawPowerupShield(th);
-    print(525, 18, "Shield PU");
+    paletteLabel(3, "Shield PU");
+
+    // Wall tiles (drag to paint)
+    drawWallIcon(PALETTE_X[4], py, 16);
+    paletteLabel(4, "Wall");
+
+    // Rotated box / convex polygon
+    OBox ib = { PALETTE_X[5], py, 20, 8, PI_F / 6 };
+    drawBox(ib);
+    paletteLabel(5, "Box");
+    drawPoly(makeEditorPoly(PALETTE_X[6], py, 3));
+    paletteLabel(6, "Polygon");
+
+    // Moving obstacle
+    drawMover(PALETTE_X[7], py, 14);
+    paletteLabel(7, "Mover");
+
+    // Magnet PU
+    Obj tm; tm.x = PALETTE_X[8]; tm.y = py; tm.r = 16; tm.type = OBJ_PU_MAGNET;
+    drawPowerupMagnet(tm);
+    paletteLabel(8, "Magnet PU");
 
     // Current mode hint
     const char* m = "Place: None";
@@ -413,6 +1079,11 @@ void drawPanels() {
     else if (placeMode == PLACE_COL) m = "Place: Collectible";
     else if (placeMode == PLACE_PU_SPEED) m = "Place: Speed PU";
     else if (placeMode == PLACE_PU_SHIELD) m = "Place: Shield PU";
+    else if (placeMode == PLACE_PU_MAGNET) m = "Place: Magnet PU";
+    else if (placeMode == PLACE_TILE) m = "Place: Wall (drag)";
+    else if (placeMode == PLACE_BOX) m = "Place: Box";
+    else if (placeMode == PLACE_POLY) m = "Place: Polygon";
+    else if (placeMode == PLACE_MOVER) m = moverPending ? "Mover: click path end" : "Place: Mover (2 clicks)";
     print(W - 220, 18, m);
     print(W - 120, 38, "Press R to start");
 }
@@ -420,13 +1091,70 @@ void drawPanels() {
 // ---------------- Collision & Movement ----------------
 float currentSpeed() {
     float now = timeSec;
-    if (now < player.speedUntil) return SPEED_BOOST;
-    return PLAYER_SPEED;
+    if (now < player.speedUntil) return rules.boost;
+    return rules.speed;
+}
+
+// Circle vs axis-aligned squares (half size = o.r), four obstacles per step
+bool circleHitsSquares(const std::vector<Obj>& sq, float x, float y, float r) {
+    size_t i = 0, n = sq.size();
+#ifdef MATH2D_SSE
+    float4 px = f4(x), py = f4(y), rr = f4(r * r);
+    for (; i + 4 <= n; i += 4) {
+        const Obj* o = &sq[i];
+        float4 ox = f4(o[0].x, o[1].x, o[2].x, o[3].x);
+        float4 oy = f4(o[0].y, o[1].y, o[2].y, o[3].y);
+        float4 oh = f4(o[0].r, o[1].r, o[2].r, o[3].r);
+        float4 cx = clamp4(px, ox - oh, ox + oh);
+        float4 cy = clamp4(py, oy - oh, oy + oh);
+        if (any4(lt4(dist2_4(px, py, cx, cy), rr))) return true;
+    }
+#endif
+    for (; i < n; i++) {
+        const Obj& o = sq[i];
+        float cx = clampf(x, o.x - o.r, o.x + o.r);
+        float cy = clampf(y, o.y - o.r, o.y + o.r);
+        if (dist2(x, y, cx, cy) < r * r) return true;
+    }
+    return false;
+}
+
+// Narrow phase for tryMove and pickups (Collide.h). Candidates come from the
+// obstacle grid; the matrix then runs one kernel per kind.
+ShapeTables<Obj> colTables;
+CollisionMatrix colPairs;
+
+// Circle at (x,y) against squares, rotated boxes, polygons, wall tiles and
+// movers (swept over the last tick, so a fast mover cannot skip the player)
+bool circleBlocked(float x, float y, float r) {
+    colTables.clearCircles();
+    colTables.squares = obstacles.data();
+    colTables.boxes = boxBlocks.data();
+    colTables.polys = polyBlocks.data();
+    int c = colTables.addCircle(x, y, r);
+
+    colPairs.clear();
+    // a shape spanning two queried cells is added twice; that only repeats a test
+    obstacleGrid.query(x - r, y - r, x + r, y + r, [&](int id) {
+        int j = id & 0xFFFFFF;
+        if ((id >> 24) == SHAPE_SQUARE) colPairs.add<SHAPE_CIRCLE, SHAPE_SQUARE>(c, j);
+        else if ((id >> 24) == SHAPE_BOX) colPairs.add<SHAPE_CIRCLE, SHAPE_BOX>(c, j);
+        else colPairs.add<SHAPE_CIRCLE, SHAPE_POLY>(c, j);
+        return false;
+    });
+    colPairs.run(colTables);
+    return colPairs.anyHit() || tileCircleHits(walls, x, y, r) || movers.circleHits(x, y, r);
 }
 
-bool intersectCircleCircle(float x1, float y1, float r1, float x2, float y2, float r2) {
-    float rr = (r1 + r2) * (r1 + r2);
-    return dist2(x1, y1, x2, y2) <= rr;
+// Lose a life unless shielded or still in i-frames
+void hurtPlayer() {
+    if (player.shielded || timeSec < nextHitTime) return;
+    player.lives = std::max(0, player.lives - 1);
+    sfxPlay(L"assets\\hit.wav");
+    nextHitTime = timeSec + 0.5f;  // half-second i-frames
+    if (player.lives == 0) {
+        phase = PHASE_LOSE; musicStop(); sfxPlay(L"assets\\lose.wav");
+    }
 }
 
 void tryMove(float dx, float dy, float dt) {
@@ -436,28 +1164,11 @@ void tryMove(float dx, float dy, float dt) {
     nx = clampf(nx, player.r, W - player.r);
     ny = clampf(ny, GAME_Y0 + player.r, GAME_Y1 - player.r);
 
-    // check obstacles
-    bool blocked = false;
-    for (const auto& o : obstacles) {
-        // treat obstacle as square; collide if circle center inside expanded square
-        float half = o.r;
-        float cx = clampf(nx, o.x - half, o.x + half);
-        float cy = clampf(ny, o.y - half, o.y + half);
-        if (dist2(nx, ny, cx, cy) < player.r * player.r) {
-            blocked = true;
-            break;
-        }
-    }
+    // check obstacles (treated as squares)
+    bool blocked = circleBlocked(nx, ny, player.r);
 
     if (blocked) {
-        if (!player.shielded && timeSec >= nextHitTime) {
-            player.lives = std::max(0, player.lives - 1);
-            sfxPlay(L"assets\\hit.wav");
-            nextHitTime = timeSec + 0.5f;  // half-second i-frames
-            if (player.lives == 0) {
-                phase = PHASE_LOSE; musicStop(); sfxPlay(L"assets\\lose.wav");
-            }
-        }
+        hurtPlayer();
         // stay in place
     }
     else {
@@ -471,12 +1182,13 @@ void updateGame(float dt) {
 
     // countdown
     float elapsed = timeSec - roundStart;
-    int remain = ROUND_TIME_SEC - (int)elapsed;
+    int remain = (int)rules.roundTime - (int)elapsed;
     timeLeft = (remain > 0 ? remain : 0);
     if (timeLeft <= 0) { phase = PHASE_LOSE; return; }
 
-    // expire powerups
+    // expire powerups, spawn new ones
     if (timeSec > player.shieldUntil) player.shielded = false;
+    updateSpawns();
 
     // input to velocity
     float vx = 0, vy = 0;
@@ -488,41 +1200,55 @@ void updateGame(float dt) {
 
     // rotate to face movement
     if (vx != 0 || vy != 0) {
-        player.angleDeg = atan2f(vy, vx) * 57.29578f;
+        player.angleDeg = fastAtan2(vy, vx) * RAD2DEG;
     }
 
     // integrate
     tryMove(vx * dt, vy * dt, dt);
-
-    // collectibles
-    for (size_t i = 0; i < collectibles.size();) {
-        if (intersectCircleCircle(player.x, player.y, player.r, collectibles[i].x, collectibles[i].y, collectibles[i].r)) {
-            player.score += 5;
-            sfxPlay(L"assets\\collect.wav");
-            collectibles.erase(collectibles.begin() + i);
-        }
-        else i++;
+    updateMagnet(dt);
+
+    // collectibles in the ship's cells (back to front so swap-removes keep the
+    // rest valid)
+    collectiblesNear(player.x, player.y, player.r, pickupIds);
+    std::sort(pickupIds.begin(), pickupIds.end(), [](int a, int b) { return a > b; });
+    for (int i : pickupIds) {
+        player.score += 5;
+        sfxPlay(L"assets\\collect.wav");
+        removeCollectible(i);
     }
 
+    // pickups: player vs powerups, then the target, as one circle-circle batch
+    int np = (int)powerups.size();
+    int curT[2]; bezierPoint(target.t, target.p0, target.p1, target.p2, target.p3, curT);
+    colTables.clearCircles();
+    colPairs.clear();
+    int pc = colTables.addCircle(player.x, player.y, player.r);
+    for (const auto& p : powerups) colPairs.add<SHAPE_CIRCLE, SHAPE_CIRCLE>(pc, colTables.addCircle(p.x, p.y, p.r));
+    colPairs.add<SHAPE_CIRCLE, SHAPE_CIRCLE>(pc, colTables.addCircle((float)curT[0], (float)curT[1], target.r));
+    colPairs.run(colTables);
+    const std::vector<uint8_t>& hit = colPairs.batch(SHAPE_CIRCLE, SHAPE_CIRCLE).hit;
+
     // powerups
-    for (size_t i = 0; i < powerups.size();) {
-        if (intersectCircleCircle(player.x, player.y, player.r, powerups[i].x, powerups[i].y, powerups[i].r)) {
+    for (int i = np - 1; i >= 0; i--) {
+        if (hit[i]) {
             if (powerups[i].type == OBJ_PU_SPEED) {
-                player.speedUntil = timeSec + POWERUP_DURATION;
+                player.speedUntil = timeSec + rules.boostTime;
+            }
+            else if (powerups[i].type == OBJ_PU_MAGNET) {
+                player.magnetUntil = timeSec + MAGNET_TIME;
             }
             else { // shield
                 player.shielded = true;
-                player.shieldUntil = timeSec + SHIELD_DURATION;
+                player.shieldUntil = timeSec + rules.shieldTime;
             }
-            sfxPlay(L"assets\\collect.wav");    
+            sfxPlay(L"assets\\collect.wav");
+            spawnCover(powerups[i], -1);
             powerups.erase(powerups.begin() + i);
         }
-        else i++;
     }
 
     // target
-    int curT[2]; bezierPoint(target.t, target.p0, target.p1, target.p2, target.p3, curT);
-    if (intersectCircleCircle(player.x, player.y, player.r, (float)curT[0], (float)curT[1], target.r)) {
+    if (hit[np]) {
         phase = PHASE_WIN;
         musicStop();
         sfxPlay(L"assets\\win.wav");
@@ -531,37 +1257,657 @@ void updateGame(float dt) {
 
 void updateTarget(float dt) {
     // ping-pong t in [0,1]
-    float speedT = 0.35f; // Bezier speed
-    target.t += target.dir * speedT * dt;
+    target.t += target.dir * rules.targetSpeed * dt;
     if (target.t > 1.0f) { target.t = 1.0f; target.dir = -1; }
     if (target.t < 0.0f) { target.t = 0.0f; target.dir = +1; }
 }
 
-// ---------------- Display ----------------
-void Display() {
-    glClear(GL_COLOR_BUFFER_BIT);
+// ---------------- Fog of War ----------------
+// Visibility polygon (Visibility.h) from the ship, rebuilt once per displayed
+// frame from the edges near it: shapes come from the obstacle grid and wall
+// tiles as one rectangle per run. The fog goes over the tiles; objects are
+// drawn above it only when some part is visible, the rest are not submitted.
+PolarVis fog;
+bool fogOn = false;
+std::vector<int> fogIds;   // grid candidates, deduplicated
+std::vector<float> fogXY;  // visible projectiles (interleaved x,y)
+
+double fogStatMs = 0.0;
+long long fogStatEdges = 0, fogStatBins = 0;
+int fogStatFrames = 0, fogStatLastMs = 0;
+
+bool fogActive() { return fogOn && phase == PHASE_PLAY; }
+
+// Culling for drawScene: false only when the bounding circle is surely hidden
+bool fogShown(float x, float y, float r) { return !fogActive() || fog.visible(x, y, r); }
+
+// Visible points of an interleaved x,y batch into fogXY; returns the count
+int fogFilter(const float* xy, int n) {
+    fogXY.resize(2 * (size_t)n);
+    int m = 0;
+    for (int i = 0; i < n; i++)
+        if (fog.pointVisible(xy[2 * i], xy[2 * i + 1])) { fogXY[2 * m] = xy[2 * i]; fogXY[2 * m + 1] = xy[2 * i + 1]; m++; }
+    return m;
+}
+
+void fogAddLoop(const float* px, const float* py, int n) {
+    for (int i = 0; i < n; i++) {
+        int j = (i + 1 == n) ? 0 : i + 1;
+        fog.addEdge(px[i], py[i], px[j], py[j]);
+    }
+}
+
+void fogGather(float x, float y, float r) {
+    fogIds.clear();
+    obstacleGrid.query(x - r, y - r, x + r, y + r, [&](int id) { fogIds.push_back(id); return false; });
+    std::sort(fogIds.begin(), fogIds.end());
+    fogIds.erase(std::unique(fogIds.begin(), fogIds.end()), fogIds.end());
+    float px[POLY_MAX_VERTS], py[POLY_MAX_VERTS];
+    for (int id : fogIds) {
+        int i = id & 0xFFFFFF;
+        if ((id >> 24) == SHAPE_SQUARE) {
+            const Obj& o = obstacles[i];
+            float qx[4] = { o.x - o.r, o.x + o.r, o.x + o.r, o.x - o.r }, qy[4] = { o.y - o.r, o.y - o.r, o.y + o.r, o.y + o.r };
+            fogAddLoop(qx, qy, 4);
+        }
+        else if ((id >> 24) == SHAPE_BOX) { boxCorners(boxes[i], px, py); fogAddLoop(px, py, 4); }
+        else fogAddLoop(polys[i].px, polys[i].py, polys[i].n);
+    }
+    if (walls.rows == 0) return;
+    int r0 = std::max(walls.rowAt(y - r), 0), r1 = std::min(walls.rowAt(y + r), walls.rows - 1);
+    int c0 = std::max(walls.colAt(x - r), 0), c1 = std::min(walls.colAt(x + r) + 1, walls.cols);
+    for (int row = r0; row <= r1; row++) {
+        float y0 = walls.y0 + row * walls.size, y1 = y0 + walls.size;
+        tileForEachRun(walls, row, [&](int a, int b) {
+            a = std::max(a, c0); b = std::min(b, c1);   // clip edges fall outside the radius
+            if (a >= b) return;
+            float x0 = walls.x0 + a * walls.size, x1 = walls.x0 + b * walls.size;
+            float qx[4] = { x0, x1, x1, x0 }, qy[4] = { y0, y0, y1, y1 };
+            fogAddLoop(qx, qy, 4);
+        });
+    }
+}
+
+void fogReportStats(double ms) {
+    fogStatMs += ms; fogStatEdges += fog.edges; fogStatBins += fog.edgeBins; fogStatFrames++;
+    int nowMs = glutGet(GLUT_ELAPSED_TIME);
+    if (nowMs - fogStatLastMs < 1000) return;
+    double n = fogStatFrames;
+    printf("[fog] %.3f ms/frame, %.0f edges, %.0f bin tests (%d bins)\n",
+        fogStatMs / n, fogStatEdges / n, fogStatBins / n, fog.bins);
+    fogStatMs = 0.0; fogStatEdges = fogStatBins = 0; fogStatFrames = 0;
+    fogStatLastMs = nowMs;
+}
+
+// Once per displayed frame, before drawing (the soft damage key reads it)
+void updateFog() {
+    if (!fogActive()) return;
+    auto t0 = std::chrono::steady_clock::now();
+    fog.begin(player.x, player.y, FOG_RADIUS);
+    fogGather(player.x, player.y, FOG_RADIUS);
+    fogReportStats(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count());
+}
+
+// Distance along (dx, dy) from the viewer to the game area's border grown by
+// 24 px: the margin keeps the 1/2 degree chords between far points outside the corners
+float fogFar(float dx, float dy) {
+    const float M = 24.0f;
+    float tx = dx > 0 ? (W + M - fog.px) / dx : (dx < 0 ? (-M - fog.px) / dx : 1e9f);
+    float ty = dy > 0 ? (GAME_Y1 + M - fog.py) / dy : (dy < 0 ? (GAME_Y0 - M - fog.py) / dy : 1e9f);
+    return std::min(tx, ty);
+}
+
+// The game area outside the polygon: per bin, two triangles from the
+// polygon out past the border, clipped to the game area
+void drawFog() {
+    if (!fogActive()) return;
+    rClipGameArea(true);
+    rColor3f(0.06f, 0.07f, 0.1f);
+    rBegin(GL_TRIANGLES);
+    for (int k = 0; k < fog.bins; k++) {
+        int j = (k + 1 == fog.bins) ? 0 : k + 1;
+        float dk = fog.dist[k] + FOG_REVEAL, dj = fog.dist[j] + FOG_REVEAL;
+        float nkx = fog.px + fog.dirx[k] * dk, nky = fog.py + fog.diry[k] * dk;
+        float njx = fog.px + fog.dirx[j] * dj, njy = fog.py + fog.diry[j] * dj;
+        float fk = fogFar(fog.dirx[k], fog.diry[k]), fj = fogFar(fog.dirx[j], fog.diry[j]);
+        float fkx = fog.px + fog.dirx[k] * fk, fky = fog.py + fog.diry[k] * fk;
+        float fjx = fog.px + fog.dirx[j] * fj, fjy = fog.py + fog.diry[j] * fj;
+        rVertex2f(nkx, nky); rVertex2f(fkx, fky); rVertex2f(fjx, fjy);
+        rVertex2f(nkx, nky); rVertex2f(fjx, fjy); rVertex2f(njx, njy);
+    }
+    rEnd();
+    rClipGameArea(false);
+}
+
+// ---------------- Lidar Sensors ----------------
+// Batched ray casts for bots and RL observations: K rays per origin, each
+// reporting how far it got and what stopped it. Rays go in packets of four
+// (RayCast.h); each lane walks the grid cells it crosses (shapes, items and
+// movers together) until its nearest hit lies inside the current cell, and every
+// candidate met is tested against all four lanes at once, at most once per
+// packet. Wall tiles and the border are cast first, so walks start short.
+// Origins are split across the worker pool.
+enum LidarHit { LIDAR_NONE = 0, LIDAR_WALL = 1, LIDAR_OBSTACLE = 2, LIDAR_COLLECT = 3,
+                LIDAR_PU_SPEED = 4, LIDAR_PU_SHIELD = 5, LIDAR_TARGET = 6, LIDAR_PU_MAGNET = 7 };
+
+int lidarPowerup(const Obj& o) {
+    return o.type == OBJ_PU_SPEED ? LIDAR_PU_SPEED : (o.type == OBJ_PU_MAGNET ? LIDAR_PU_MAGNET : LIDAR_PU_SHIELD);
+}
+
+// Collectibles (ids 0 << 24 | i) and powerups (1 << 24 | i), rebuilt per
+// scan; same cells as obstacleGrid (so is movers.grid)
+SpatialGrid itemGrid;
+float lidarArea[4] = { 0, (float)GAME_Y0, (float)W, (float)GAME_Y1 };   // border box; reads as a wall
+float lidarTargetX = 0, lidarTargetY = 0;
+// Start of each candidate kind in one flat id range: squares, boxes, polys,
+// collectibles, powerups, movers, end
+int lidarBase[7] = { 0 };
+
+// Per-thread "last tested in packet #" stamps over the flat ids
+struct LidarScratch {
+    std::vector<uint32_t> seen;
+    uint32_t packet = 0;
+
+    uint32_t next(int n) {
+        if ((int)seen.size() < n) seen.resize(n, 0);
+        if (++packet == 0) { std::fill(seen.begin(), seen.end(), 0u); packet = 1; }
+        return packet;
+    }
+    bool first(int flat, uint32_t stamp) {
+        if (seen[flat] == stamp) return false;
+        seen[flat] = stamp;
+        return true;
+    }
+};
+
+bool lidarOn = false;
+float lidarDist[LIDAR_VIEW_RAYS];
+uint8_t lidarType[LIDAR_VIEW_RAYS];
+
+bool lidarActive() { return lidarOn && phase == PHASE_PLAY; }
+
+// Items and the target as they are now; once per scan
+void lidarSync() {
+    itemGrid.clear();
+    for (int i = 0; i < (int)collectibles.size(); i++) {
+        const Obj& c = collectibles[i];
+        itemGrid.insert(i, itemGrid.range(c.x - c.r, c.y - c.r, c.x + c.r, c.y + c.r));
+    }
+    for (int i = 0; i < (int)powerups.size(); i++) {
+        const Obj& c = powerups[i];
+        itemGrid.insert(1 << 24 | i, itemGrid.range(c.x - c.r, c.y - c.r, c.x + c.r, c.y + c.r));
+    }
+    int counts[6] = { (int)obstacles.size(), (int)boxes.size(), (int)polys.size(),
+                      (int)collectibles.size(), (int)powerups.size(), movers.count };
+    for (int k = 0; k < 6; k++) lidarBase[k + 1] = lidarBase[k] + counts[k];
+    int cur[2]; bezierPoint(target.t, target.p0, target.p1, target.p2, target.p3, cur);
+    lidarTargetX = (float)cur[0]; lidarTargetY = (float)cur[1];
+}
+
+// Lanes past `lanes` only repeat the last ray and are not walked
+void lidarCastPacket(RayPacket& p, LidarScratch& s, int lanes) {
+    uint32_t stamp = s.next(lidarBase[6]);
+    float px[POLY_MAX_VERTS], py[POLY_MAX_VERTS];
+    auto shape = [&](int id) {
+        int k = id >> 24, i = id & 0xFFFFFF;
+        if (!s.first(lidarBase[k - SHAPE_SQUARE] + i, stamp)) return;
+        if (k == SHAPE_SQUARE) {
+            const Obj& o = obstacles[i];
+            rayHitBox(p, o.x - o.r, o.y - o.r, o.x + o.r, o.y + o.r, LIDAR_OBSTACLE);
+        }
+        else if (k == SHAPE_BOX) { boxCorners(boxes[i], px, py); rayHitConvex(p, px, py, 4, LIDAR_OBSTACLE); }
+        else rayHitConvex(p, polys[i].px, polys[i].py, polys[i].n, LIDAR_OBSTACLE);
+    };
+    auto item = [&](int id) {
+        int pu = id >> 24, i = id & 0xFFFFFF;
+        if (!s.first(lidarBase[3 + pu] + i, stamp)) return;
+        const Obj& o = pu ? powerups[i] : collectibles[i];
+        rayHitCircle(p, o.x, o.y, o.r, !pu ? LIDAR_COLLECT : lidarPowerup(o));
+    };
+    auto mover = [&](int i) {
+        if (!s.first(lidarBase[5] + i, stamp)) return;
+        float x = movers.x[i], y = movers.y[i], h = movers.h[i];
+        rayHitBox(p, x - h, y - h, x + h, y + h, LIDAR_OBSTACLE);
+    };
+
+    rayHitCircle(p, lidarTargetX, lidarTargetY, target.r, LIDAR_TARGET);
+    for (int l = 0; l < lanes; l++) {
+        float dx = p.dx[l], dy = p.dy[l];
+        float bx = dx > 0 ? (lidarArea[2] - p.ox) / dx : (dx < 0 ? (lidarArea[0] - p.ox) / dx : 1e30f);
+        float by = dy > 0 ? (lidarArea[3] - p.oy) / dy : (dy < 0 ? (lidarArea[1] - p.oy) / dy : 1e30f);
+        float tw = std::min(std::max(0.0f, std::min(bx, by)), tileRayHit(walls, p.ox, p.oy, dx, dy, p.t[l]));
+        if (tw < p.t[l]) { p.t[l] = tw; p.tag[l] = LIDAR_WALL; }
+
+        // one walk: itemGrid and movers.grid share obstacleGrid's cells
+        obstacleGrid.walkRay(p.ox, p.oy, dx, dy, p.t[l], [&](int c, int r, float exit) {
+            for (int id : obstacleGrid.at(c, r)) shape(id);
+            for (int id : itemGrid.at(c, r)) item(id);
+            if (movers.count > 0) for (int i : movers.grid.at(c, r)) mover(i);
+            return p.t[l] <= exit;
+        });
+    }
+}
+
+// Ray k of an origin: spread evenly over fov (all round when fov is 2 pi)
+float lidarAngle(float heading, int k, int K, float fov) {
+    if (fov >= TWO_PI_F - 1e-4f) return heading + k * (TWO_PI_F / K);
+    return heading - fov * 0.5f + (K > 1 ? k * fov / (K - 1) : fov * 0.5f);
+}
+
+// n origins (x, y, heading in radians), K rays each out to range. dist and
+// type hold n * K entries, origin-major; a ray that meets nothing reads range
+// and LIDAR_NONE.
+void lidarScan(const float* ox, const float* oy, const float* heading, int n, int K, float fov, float range,
+               float* dist, uint8_t* type) {
+    lidarSync();
+    parallelFor(n, std::max(1, 256 / K), [&](int b, int e) {
+        static thread_local LidarScratch s;
+        RayPacket p;
+        float ux[4], uy[4];
+        for (int i = b; i < e; i++) {
+            for (int k = 0; k < K; k += 4) {
+                for (int l = 0; l < 4; l++) fastSinCos(lidarAngle(heading[i], std::min(k + l, K - 1), K, fov), uy[l], ux[l]);
+                p.begin(ox[i], oy[i], ux, uy, range);
+                lidarCastPacket(p, s, std::min(4, K - k));
+                for (int l = 0; l < 4 && k + l < K; l++) {
+                    dist[(size_t)i * K + k + l] = p.t[l];
+                    type[(size_t)i * K + k + l] = (uint8_t)(p.tag[l] < 0 ? LIDAR_NONE : p.tag[l]);
+                }
+            }
+        }
+    });
+}
+
+// Once per displayed frame, like the fog
+void updateLidar() {
+    if (!lidarActive()) return;
+    float h = player.angleDeg / RAD2DEG;
+    lidarScan(&player.x, &player.y, &h, 1, LIDAR_VIEW_RAYS, TWO_PI_F, LIDAR_RANGE, lidarDist, lidarType);
+}
+
+// Each ray as a line to what it hit, tinted by kind, with a dot on the hit
+void drawLidar() {
+    if (!lidarActive()) return;
+    static const float TINT[8][3] = {
+        { 0.35f, 0.4f, 0.45f }, { 0.6f, 0.65f, 0.75f }, { 1.0f, 0.3f, 0.3f }, { 1.0f, 0.85f, 0.2f },
+        { 0.3f, 1.0f, 0.4f }, { 0.6f, 0.6f, 1.0f }, { 0.2f, 1.0f, 1.0f }, { 1.0f, 0.4f, 0.7f } };
+    float h = player.angleDeg / RAD2DEG;
+    float hx[LIDAR_VIEW_RAYS], hy[LIDAR_VIEW_RAYS];
+    for (int k = 0; k < LIDAR_VIEW_RAYS; k++) {
+        float sn, cs; fastSinCos(lidarAngle(h, k, LIDAR_VIEW_RAYS, TWO_PI_F), sn, cs);
+        hx[k] = player.x + cs * lidarDist[k]; hy[k] = player.y + sn * lidarDist[k];
+    }
+    rBegin(GL_LINES);
+    for (int k = 0; k < LIDAR_VIEW_RAYS; k++) {
+        const float* c = TINT[lidarType[k]];
+        rColor3f(c[0] * 0.5f, c[1] * 0.5f, c[2] * 0.5f);
+        rVertex2f(player.x, player.y); rVertex2f(hx[k], hy[k]);
+    }
+    rEnd();
+    rPointSize(4);
+    rBegin(GL_POINTS);
+    for (int k = 0; k < LIDAR_VIEW_RAYS; k++) {
+        if (lidarType[k] == LIDAR_NONE) continue;
+        const float* c = TINT[lidarType[k]];
+        rColor3f(c[0], c[1], c[2]);
+        rVertex2f(hx[k], hy[k]);
+    }
+    rEnd();
+    rPointSize(1);
+}
+
+// ---------------- Batch Environments ----------------
+// The edited level as an EnvLevel, for headless worlds stepped and observed
+// in batches (BatchEnv.h). Movers, hazards, the swarm and bolts stay in the
+// windowed game.
+void levelFromEditor(EnvLevel& L) {
+    L.x0 = 0; L.y0 = (float)GAME_Y0; L.x1 = (float)W; L.y1 = (float)GAME_Y1;
+    L.walls = walls;
+    L.sqx.clear(); L.sqy.clear(); L.sqh.clear();
+    for (const auto& o : obstacles) { L.sqx.push_back(o.x); L.sqy.push_back(o.y); L.sqh.push_back(o.r); }
+    L.boxes = boxes;
+    L.polys = polys;
+    L.ix.clear(); L.iy.clear(); L.ir.clear(); L.ikind.clear();
+    for (const auto& c : collectibles) { L.ix.push_back(c.x); L.iy.push_back(c.y); L.ir.push_back(c.r); L.ikind.push_back(ENV_COLLECT); }
+    for (const auto& p : powerups) {
+        if (p.type == OBJ_PU_MAGNET) continue;   // headless worlds have no magnet
+        L.ix.push_back(p.x); L.iy.push_back(p.y); L.ir.push_back(p.r);
+        L.ikind.push_back(p.type == OBJ_PU_SPEED ? ENV_PU_SPEED : ENV_PU_SHIELD);
+    }
+    const int* cp[4] = { target.p0, target.p1, target.p2, target.p3 };
+    for (int k = 0; k < 4; k++) { L.path[k][0] = (float)cp[k][0]; L.path[k][1] = (float)cp[k][1]; }
+    Player start;   // startRound's spawn
+    L.targetR = target.r; L.startX = start.x; L.startY = start.y; L.playerR = start.r;
+}
+
+void printDifficulty(const DifficultyReport& d) {
+    printf("difficulty %.0f/100: win %.1f%% [%.1f, %.1f], %.1f s to the target, %.2f hits; %d rounds in %.0f ms%s\n",
+        d.score, 100 * d.winRate, 100 * d.winLo, 100 * d.winHi, d.timeToTarget, d.hits, d.rounds, d.ms,
+        d.converged ? "" : " (budget hit before the interval closed)");
+}
+
+// ---------------- Bullet Hell ----------------
+// Emitters spin around the target and fire into a ProjectilePool
+// (Projectiles.h). Normal mode fires at a fixed rate; stress mode scales the
+// rate so step + draw stays at HAZARD_BUDGET_MS and reports how many
+// projectiles that is per frame.
+enum HazardMode { HAZARD_OFF = 0, HAZARD_ON = 1, HAZARD_STRESS = 2 };
+HazardMode hazard = HAZARD_OFF;
+ProjectilePool shots;
+float shotRate = HAZARD_RATE;   // spawns per second
+float shotCarry = 0.0f;         // fractional spawn carried to the next tick
+uint32_t shotSerial = 0;        // fan pattern phase
+double hazardDrawMs = 0.0;      // drawShots time since the last tick
+float hazardCostAvg = 0.0f;     // smoothed step + draw ms (stress controller)
+float hazardOutflow = 0.0f;     // smoothed projectiles/sec leaving the pool
+
+// Stats, printed about once per second while the hazard is on
+double hazardStatStepMs = 0.0, hazardStatDrawMs = 0.0;
+long long hazardStatShots = 0;
+int hazardStatTicks = 0, hazardStatLastMs = 0;
+
+void emitterPos(int e, float& x, float& y) {
+    int cur[2]; bezierPoint(target.t, target.p0, target.p1, target.p2, target.p3, cur);
+    float sn, cs; fastSinCos(timeSec * 1.7f + TWO_PI_F * e / EMITTERS, sn, cs);
+    x = cur[0] + cs * EMITTER_ORBIT; y = cur[1] + sn * EMITTER_ORBIT;
+}
+
+// Each emitter fires outward, fanned +-0.6 rad by a golden-angle sequence
+void fireEmitters(float dt) {
+    shotCarry += shotRate * dt;
+    int n = (int)shotCarry;
+    shotCarry -= n;
+    float ex[EMITTERS], ey[EMITTERS];
+    for (int e = 0; e < EMITTERS; e++) emitterPos(e, ex[e], ey[e]);
+    int cur[2]; bezierPoint(target.t, target.p0, target.p1, target.p2, target.p3, cur);
+    for (int k = 0; k < n; k++) {
+        uint32_t s = shotSerial++;
+        int e = s % EMITTERS;
+        float a = fastAtan2(ey[e] - cur[1], ex[e] - (float)cur[0]) + 0.6f * fastSin(s * 2.3999632f);
+        float sn, cs; fastSinCos(a, sn, cs);
+        if (!shots.spawn(ex[e], ey[e], cs * SHOT_SPEED, sn * SHOT_SPEED, SHOT_LIFE)) { shotCarry = 0; break; }
+    }
+}
+
+void hazardReportStats(double stepMs) {
+    hazardStatStepMs += stepMs; hazardStatShots += shots.count; hazardStatTicks++;
+    int nowMs = glutGet(GLUT_ELAPSED_TIME);
+    if (nowMs - hazardStatLastMs < 1000) return;
+    double n = hazardStatTicks;
+    printf("[hazard] %.0f projectiles/frame, step %.2f ms + draw %.2f ms (60 Hz frame 16.7 ms), %.0f shots/s\n",
+        hazardStatShots / n, hazardStatStepMs / n, hazardStatDrawMs / n, shotRate);
+    hazardStatStepMs = hazardStatDrawMs = 0.0;
+    hazardStatShots = 0; hazardStatTicks = 0;
+    hazardStatLastMs = nowMs;
+}
+
+// Runs in edit and play like the target; only play applies hits
+void updateHazard(float dt) {
+    if (hazard == HAZARD_OFF || phase == PHASE_WIN || phase == PHASE_LOSE) return;
+    auto t0 = std::chrono::steady_clock::now();
+    fireEmitters(dt);
+    int fired = shots.count;
+    bool live = (phase == PHASE_PLAY);
+    float rx = live ? player.x : -1e9f, ry = live ? player.y : -1e9f;
+    // bounds inset by the radius so dots never overhang the panels
+    int hits = shots.step(dt, SHOT_R, GAME_Y0 + SHOT_R, W - SHOT_R, GAME_Y1 - SHOT_R, walls, rx, ry, player.r);
+    if (hits > 0) hurtPlayer();
+    double stepMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    // stress: aim the live count at what the budget affords at the measured
+    // per-projectile cost; the rate replaces what leaves plus closes the gap
+    if (hazard == HAZARD_STRESS && dt > 0) {
+        hazardCostAvg = hazardCostAvg * 0.9f + (float)(stepMs + hazardDrawMs) * 0.1f;
+        hazardOutflow = hazardOutflow * 0.9f + (fired - shots.count) / dt * 0.1f;
+        float want = (float)shots.capacity;
+        if (shots.count >= 1000) want = std::min(want, HAZARD_BUDGET_MS * shots.count / std::max(hazardCostAvg, 0.01f));
+        shotRate = std::max(HAZARD_RATE, hazardOutflow + (want - shots.count) * 2.0f);
+    }
+    hazardStatDrawMs += hazardDrawMs;
+    hazardDrawMs = 0.0;
+    hazardReportStats(stepMs);
+}
+
+void setHazard(HazardMode m) {
+    hazard = m;
+    shots.clear();
+    shotCarry = 0.0f; hazardCostAvg = hazardOutflow = 0.0f;
+    shotRate = (m == HAZARD_STRESS) ? STRESS_RATE0 : HAZARD_RATE;
+    printf("hazard: %s\n", m == HAZARD_OFF ? "off" : (m == HAZARD_ON ? "on" : "stress"));
+}
+
+// Emitters + every projectile as one point batch
+void drawShots() {
+    if (hazard == HAZARD_OFF) return;
+    rColor3f(0.35f, 0.05f, 0.3f);
+    for (int e = 0; e < EMITTERS; e++) {
+        float x, y; emitterPos(e, x, y);
+        if (fogShown(x, y, 5)) drawCircle(x, y, 5, 12);
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    rColor3f(0.85f, 0.1f, 0.5f);
+    rPointSize(SHOT_R * 2);
+    if (fogActive()) rPoints(fogXY.data(), fogFilter(shots.xy.data(), shots.count));
+    else rPoints(shots.xy.data(), shots.count);
+    rPointSize(1);
+    hazardDrawMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// ---------------- Enemy Swarm ----------------
+// Boids (Boids.h) that flock, chase the player and steer around placed
+// obstacles; touching one costs a life like an obstacle does.
+BoidSwarm swarm;
+bool swarmOn = false;
+
+// Squares, boxes and polygons as bounding circles; call when the layout changes
+void updateSwarmAvoid() {
+    std::vector<float> cx, cy, cr;
+    const ShapeKind kinds[3] = { SHAPE_SQUARE, SHAPE_BOX, SHAPE_POLY };
+    for (ShapeKind k : kinds)
+        for (int i = 0; i < (int)shapeCells(k).size(); i++) {
+            float x, y, r; shapeBounds(k, i, x, y, r);
+            cx.push_back(x); cy.push_back(y); cr.push_back(r);
+        }
+    swarm.setAvoid(cx.data(), cy.data(), cr.data(), (int)cx.size());
+}
+
+// Sunflower disc around the target, flying outward
+void spawnSwarm() {
+    swarm.clear();
+    int cur[2]; bezierPoint(target.t, target.p0, target.p1, target.p2, target.p3, cur);
+    for (int i = 0; i < SWARM_SIZE; i++) {
+        float sn, cs; fastSinCos(i * 2.3999632f, sn, cs);
+        float d = 6.0f + 3.0f * sqrtf((float)i);
+        float x = clampf(cur[0] + cs * d, 2 * BOID_R, W - 2 * BOID_R);
+        float y = clampf(cur[1] + sn * d, GAME_Y0 + 2 * BOID_R, GAME_Y1 - 2 * BOID_R);
+        swarm.add(x, y, cs * swarm.minSpeed, sn * swarm.minSpeed);
+    }
+    updateSwarmAvoid();
+}
+
+void updateSwarm(float dt) {
+    if (!swarmOn || phase == PHASE_WIN || phase == PHASE_LOSE) return;
+    swarm.step(dt, player.x, player.y, walls);
+    if (phase == PHASE_PLAY && swarm.anyWithin(player.x, player.y, player.r + BOID_R)) hurtPlayer();
+}
+
+// One triangle batch, each boid pointing along its velocity
+void drawSwarm() {
+    if (!swarmOn) return;
+    rColor3f(0.45f, 0.1f, 0.55f);
+    rBegin(GL_TRIANGLES);
+    for (int i = 0; i < swarm.count; i++) {
+        float x = swarm.x[i], y = swarm.y[i], vx = swarm.vx[i], vy = swarm.vy[i];
+        if (!fogShown(x, y, 2 * BOID_R)) continue;
+        float il = 1.0f / std::max(1e-3f, sqrtf(vx * vx + vy * vy));
+        float fx = vx * il * BOID_R, fy = vy * il * BOID_R;
+        rVertex2f(x + 2 * fx, y + 2 * fy);
+        rVertex2f(x - fx - fy, y - fy + fx);
+        rVertex2f(x - fx + fy, y - fy - fx);
+    }
+    rEnd();
+}
+
+// ---------------- Destruction ----------------
+// Bolts the player fires destroy the first shape they touch, or blast a hole
+// in the wall tiles. Nothing is rebuilt: a destroyed shape is swap-removed and
+// only the entries naming it or the moved (old last) shape are patched, so the
+// cost does not grow with the number of shapes.
+struct Bolt { float x, y, vx, vy, life; };
+std::vector<Bolt> bolts;
+float boltReadyAt = 0.0f;
+bool keyFire = false;
+
+// Layout as edited; bolts destroy shapes and tiles and power-ups spawn, so
+// later rounds start from it again
+struct Layout {
+    std::vector<Obj> obstacles, powerups, collectibles;
+    std::vector<OBox> boxes;
+    std::vector<ConvexPoly> polys;
+    TileMap walls;
+} editedLayout;
+
+void saveLayout() {
+    editedLayout.obstacles = obstacles; editedLayout.boxes = boxes;
+    editedLayout.polys = polys; editedLayout.walls = walls;
+    editedLayout.powerups = powerups; editedLayout.collectibles = collectibles;
+}
+
+void restoreLayout() {
+    obstacles = editedLayout.obstacles; boxes = editedLayout.boxes;
+    polys = editedLayout.polys; walls = editedLayout.walls;
+    powerups = editedLayout.powerups; collectibles = editedLayout.collectibles;
+    rebuildShapeBlocks();
+    reindexShapes();
+}
+
+// Grid cells of the removed and moved shape, two SoA lanes (Convex2D.h) and
+// one swarm avoid slot. The soft renderer's damage items are matched per
+// list, so only the two shapes' rects repaint.
+void destroyShape(ShapeKind k, int i) {
+    float x, y, r; shapeBounds(k, i, x, y, r);
+    if (swarmOn) swarm.removeAvoid(x, y);
+
+    std::vector<CellRange>& cells = shapeCells(k);
+    int last = (int)cells.size() - 1;
+    obstacleGrid.remove(shapeId(k, i), cells[i]);
+    if (i != last) {
+        obstacleGrid.relabel(shapeId(k, last), shapeId(k, i), cells[last]);
+        cells[i] = cells[last];
+    }
+    cells.pop_back();
+    if (k == SHAPE_SQUARE) { obstacles[i] = obstacles.back(); obstacles.pop_back(); }
+    else if (k == SHAPE_BOX) removeBoxAt(boxes, boxBlocks, i);
+    else removePolyAt(polys, polyBlocks, i);
+}
+
+// destroyShape on a shapeHitAt id, timed and logged
+void destroyHit(int id) {
+    ShapeKind k = (ShapeKind)(id >> 24);
+    float x, y, r; shapeBounds(k, id & 0xFFFFFF, x, y, r);
+    if (k == SHAPE_SQUARE) spawnCover(obstacles[id & 0xFFFFFF], -1);
+    long long edits0 = obstacleGrid.cellEdits;
+    auto t0 = std::chrono::steady_clock::now();
+    destroyShape(k, id & 0xFFFFFF);
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    refreshSpawnSpace(x, y, r);
+    printf("[destroy] %s: %.2f us, %d grid edits, %d shapes left\n",
+        k == SHAPE_SQUARE ? "square" : (k == SHAPE_BOX ? "box" : "polygon"), us,
+        (int)(obstacleGrid.cellEdits - edits0), (int)(obstacles.size() + boxes.size() + polys.size()));
+}
+
+// From the ship's nose, along its heading
+void fireBolt() {
+    if (timeSec < boltReadyAt) return;
+    float sn, cs; fastSinCos(player.angleDeg * 0.017453293f, sn, cs);
+    Bolt b = { player.x + cs * player.r, player.y + sn * player.r, cs * BOLT_SPEED, sn * BOLT_SPEED, BOLT_LIFE };
+    bolts.push_back(b);
+    boltReadyAt = timeSec + BOLT_COOLDOWN;
+}
+
+void updateBolts(float dt) {
+    if (phase != PHASE_PLAY) { bolts.clear(); return; }
+    if (keyFire) fireBolt();
+    for (size_t n = 0; n < bolts.size();) {
+        Bolt& b = bolts[n];
+        b.life -= dt;
+        bool dead = b.life <= 0;
+        // sub-steps of half a tile so a bolt cannot skip a tile or a thin box
+        float dx = b.vx * dt, dy = b.vy * dt;
+        int steps = (int)(sqrtf(dx * dx + dy * dy) / (TILE_SIZE * 0.5f)) + 1;
+        for (int s = 0; s < steps && !dead; s++) {
+            b.x += dx / steps; b.y += dy / steps;
+            if (!inGameArea(b.x, b.y)) { dead = true; break; }
+            int id = shapeHitAt(b.x, b.y, BOLT_R);
+            if (id >= 0) { destroyHit(id); dead = true; }
+            else if (tileCircleHits(walls, b.x, b.y, BOLT_R)) {
+                tileClearCircle(walls, b.x, b.y, BOLT_BLAST);
+                refreshSpawnSpace(b.x, b.y, BOLT_BLAST);
+                dead = true;
+            }
+            else if (movers.circleHits(b.x, b.y, BOLT_R)) dead = true;
+        }
+        if (dead) { bolts[n] = bolts.back(); bolts.pop_back(); }
+        else n++;
+    }
+}
 
+// Bolt length drawn behind its head (px)
+const float BOLT_TRAIL = 10.0f;
+
+void drawBolts() {
+    if (bolts.empty()) return;
+    rColor3f(1.0f, 0.8f, 0.1f);
+    rLineWidth(3);
+    rBegin(GL_LINES);
+    for (const auto& b : bolts) {
+        rVertex2f(b.x - b.vx / BOLT_SPEED * BOLT_TRAIL, b.y - b.vy / BOLT_SPEED * BOLT_TRAIL);
+        rVertex2f(b.x, b.y);
+    }
+    rEnd();
+    rLineWidth(1);
+}
+
+// ---------------- Display ----------------
+// Everything a frame shows; backend-neutral (r* calls only)
+void drawScene() {
     drawPanels();
 
     // Draw placed objects (with gentle bob animation)
-    float bob = sinf(timeSec * 2.2f) * 4.0f;
-
-    for (const auto& o : obstacles) drawObstacle(o);
+    float bob = bobOffset();
+
+    // (fog of war: anything surely out of sight is skipped)
+    drawTiles(walls);
+    drawFog();
+    for (const auto& o : obstacles) if (fogShown(o.x, o.y, o.r * 1.414f)) drawObstacle(o);
+    for (const auto& b : boxes) if (fogShown(b.x, b.y, sqrtf(b.hx * b.hx + b.hy * b.hy))) drawBox(b);
+    for (const auto& p : polys) {
+        float cx, cy, e; polyBounds(p, cx, cy, e);
+        if (fogShown(cx, cy, e)) drawPoly(p);
+    }
+    if (phase == PHASE_EDIT)
+        for (int i = 0; i < movers.count; i++) drawMoverPath(movers, i);
+    for (int i = 0; i < movers.count; i++)
+        if (fogShown(movers.x[i], movers.y[i], movers.h[i] * 1.414f)) drawMover(movers.x[i], movers.y[i], movers.h[i]);
 
     for (const auto& c : collectibles) {
         Obj tmp = c; tmp.y += bob * 0.25f;
-        drawCollectible(tmp);
+        if (fogShown(tmp.x, tmp.y, tmp.r)) drawCollectible(tmp);
     }
 
     for (const auto& p : powerups) {
         Obj tmp = p; tmp.y += bob * 0.35f;
-        drawPowerup(tmp);
+        if (fogShown(tmp.x, tmp.y, tmp.r + 3)) drawPowerup(tmp);
     }
 
     // Target current position
     int cur[2]; bezierPoint(target.t, target.p0, target.p1, target.p2, target.p3, cur);
     Target drawT = target; drawT.p0[0] = cur[0]; drawT.p0[1] = cur[1];
-    drawTarget(drawT);
+    if (fogShown((float)cur[0], (float)cur[1], target.r)) drawTarget(drawT);
+    drawShots();
+    drawSwarm();
+    drawBolts();
+    drawLidar();
 
     // Player
     drawPlayer(player);
@@ -569,43 +1915,563 @@ void Display() {
     // End screens
     if (phase == PHASE_WIN) {
 
-        glColor3f(0, 0, 0); drawQuad(0, GAME_Y0, W, GAME_Y1 - GAME_Y0);
-        glColor3f(0, 1, 0);
+        rColor3f(0, 0, 0); drawQuad(0, GAME_Y0, W, GAME_Y1 - GAME_Y0);
+        rColor3f(0, 1, 0);
         print(W / 2 - 40, (GAME_Y0 + GAME_Y1) / 2 + 10, "YOU WIN!");
         char b[64]; sprintf(b, "Final Score: %d", player.score);
         print(W / 2 - 60, (GAME_Y0 + GAME_Y1) / 2 - 10, b);
     }
     else if (phase == PHASE_LOSE) {
-        glColor3f(0, 0, 0); drawQuad(0, GAME_Y0, W, GAME_Y1 - GAME_Y0);
-        glColor3f(1, 0, 0);
+        rColor3f(0, 0, 0); drawQuad(0, GAME_Y0, W, GAME_Y1 - GAME_Y0);
+        rColor3f(1, 0, 0);
         print(W / 2 - 40, (GAME_Y0 + GAME_Y1) / 2 + 10, "YOU LOSE");
         char b[64]; sprintf(b, "Final Score: %d", player.score);
         print(W / 2 - 60, (GAME_Y0 + GAME_Y1) / 2 - 10, b);
     }
+}
+
+// ---------------- CPU Backend (dirty rectangles) ----------------
+// Only regions whose pixels changed since the last frame are repainted and
+// presented. Each dynamic element reports its bounding box and a key of the
+// state it is drawn from; a changed key damages both its old and new box.
+struct DamageItem {
+    SoftRect r;
+    uint32_t key;
+    int group;   // list the item came from; items match by index within a group
+};
+
+std::vector<DamageItem> damagePrev, damageCur;
+std::vector<SoftRect> damage;   // rectangles repainted this frame
+int  damageGroup = 0;           // group of the items being collected
+int  damagePrevPhase = -1;
+bool damageAll = true;          // first frame, backend toggle, window exposed
+
+const int MAX_DAMAGE_RECTS = 64;
+
+// Dynamic scale: step between 50% and 100% to keep soft frames near the target
+const float SCALE_MIN = 0.5f, SCALE_MAX = 1.0f, SCALE_STEP = 0.125f;
+const float SCALE_TARGET_MS = 6.0f;
+float softFrameMsAvg = 0.0f;    // smoothed soft frame time
+int   scaleCooldown = 0;        // frames before the next dynamic step
+
+// Stats, printed to the console about once per second
+double softStatMs = 0.0;
+long long softStatTouched = 0, softStatPresented = 0;
+int softStatFrames = 0, softStatRects = 0, softStatLastMs = 0;
+
+// ---------------- Glow (soft backend) ----------------
+// Shield ring, power-ups and exhaust are drawn into a half-resolution emissive
+// mask, box-blurred (SoftRaster.h) and added over the damaged window rects;
+// only the parts of the mask those rects see are drawn and blurred.
+// Mask colors stay well below white since the playfield background is light.
+// Blur passes/radius step down when the glow pass exceeds GLOW_BUDGET_MS.
+bool glowOn = false;
+SoftFrame softGlow, softGlowB;      // blur ping-pongs between the two
+std::vector<SoftRect> glowRects;    // damaged rects at half resolution
+std::vector<uint32_t> glowTmp;
+
+const float GLOW_BUDGET_MS = 1.5f;  // mask + blur + composite at 1000x700
+const int   GLOW_RADIUS = 5;        // half-res pixels per pass
+const int   GLOW_PASSES = 3;        // 3 box passes ~ gaussian
+int   glowRadius = GLOW_RADIUS, glowPasses = GLOW_PASSES;
+float glowMsAvg = 0.0f;
+int   glowCooldown = 0;
+double glowStatBlurMs = 0.0, glowStatMs = 0.0;
+
+// How far (window px) glow spreads past its source; damage boxes grow by this
+float glowReach() { return glowOn ? 2.0f * glowRadius * glowPasses + 2 : 0.0f; }
+
+void drawGlowSources() {
+    if (phase == PHASE_WIN || phase == PHASE_LOSE) return; // end screens cover the field
+
+    float bob = bobOffset();
+    for (const auto& p : powerups) {
+        if (!fogShown(p.x, p.y + bob * 0.35f, p.r)) continue;
+        if (p.type == OBJ_PU_SPEED) rColor3f(0.05f, 0.5f, 0.15f);
+        else if (p.type == OBJ_PU_MAGNET) rColor3f(0.6f, 0.1f, 0.1f);
+        else                       rColor3f(0.25f, 0.25f, 0.6f);
+        drawCircle(p.x, p.y + bob * 0.35f, p.r, 16);
+    }
+
+    rPushMatrix();
+    rTranslatef(player.x, player.y, 0);
+    rRotatef(player.angleDeg, 0, 0, 1);
+    float tail = SHIP_TAIL_X * player.r, flame = exhaustFlame();
+    rColor3f(0.9f, 0.4f, 0.0f);
+    rBegin(GL_TRIANGLES);
+    rVertex2f(tail, 5.0f); rVertex2f(tail, -5.0f); rVertex2f(tail - flame * 1.3f, 0.0f);
+    rEnd();
+    rPopMatrix();
+
+    if (player.shielded) {
+        rColor3f(0.3f, 0.3f, 0.7f);
+        rLineWidth(4);
+        drawMesh(GL_LINE_LOOP, CIRCLE_LOOP_40, player.x, player.y, player.r + 7);
+        rLineWidth(1);
+    }
+}
+
+// Mask + blur into softGlow over the damaged rects only; returns blur time
+// in ms. Pass i writes the half-res rects grown by the radius times the
+// passes still to come, reading the last pass's buffer, so each rect sees
+// exactly the full-frame blur and overlapping rects don't feed each other.
+double buildGlow() {
+    int gw = (W + 1) / 2, gh = (H + 1) / 2;
+    if (softGlow.w != gw || softGlow.h != gh) { softGlow.resize(gw, gh); softGlowB.resize(gw, gh); }
+    SoftRect all = { 0, 0, gw, gh };
+    auto grown = [&](const SoftRect& g, int by) {
+        SoftRect r = { g.x0 - by, g.y0 - by, g.x1 + by, g.y1 + by };
+        return rectIntersect(r, all);
+    };
+    glowRects.clear();
+    for (const auto& d : damage) {
+        SoftRect g = { d.x0 >> 1, d.y0 >> 1, (d.x1 + 1) >> 1, (d.y1 + 1) >> 1 };
+        glowRects.push_back(g);
+    }
+
+    // mask pass through the same r* path, at half scale into the glow frame,
+    // over what the blur reads
+    SoftFrame saved;
+    std::swap(saved, softFrame);
+    std::swap(softFrame, softGlow);
+    SoftXform half = { 0.5f, 0, 0, 0.5f, 0, 0 };
+    for (const auto& g : glowRects) {
+        SoftRect m = grown(g, glowRadius * glowPasses);
+        softFrame.clip = m;
+        softFillRect(softFrame, (float)m.x0, (float)m.y0, (float)m.x1, (float)m.y1, 0u);
+        softXf = half;
+        softLineScale = 0.5f;
+        drawGlowSources();
+    }
+    std::swap(softFrame, softGlow);
+    std::swap(saved, softFrame);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < glowPasses; i++) {
+        for (const auto& g : glowRects) softBoxBlur(softGlow, softGlowB, glowTmp, glowRadius, grown(g, glowRadius * (glowPasses - 1 - i)));
+        std::swap(softGlow, softGlowB);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Keep the glow pass inside its budget: fewer passes first, then a smaller radius
+void updateGlowBudget(double ms) {
+    glowMsAvg = glowMsAvg * 0.9f + (float)ms * 0.1f;
+    if (glowCooldown > 0) { glowCooldown--; return; }
+    if (glowMsAvg > GLOW_BUDGET_MS) {
+        if (glowPasses > 1) glowPasses--;
+        else if (glowRadius > 2) glowRadius--;
+        else return;
+    }
+    else if (glowMsAvg < GLOW_BUDGET_MS * 0.5f) {
+        if (glowRadius < GLOW_RADIUS) glowRadius++;
+        else if (glowPasses < GLOW_PASSES) glowPasses++;
+        else return;
+    }
+    else return;
+    printf("[glow] %.2f ms avg -> %d pass(es) of radius %d\n", glowMsAvg, glowPasses, glowRadius);
+    damageAll = true; // reach changed
+    glowCooldown = 60;
+}
+
+uint32_t hashFloats(const float* v, int n) {
+    uint32_t h = 2166136261u; // FNV-1a over the raw bits
+    for (int i = 0; i < n; i++) {
+        uint32_t u; memcpy(&u, &v[i], sizeof(u));
+        h = (h ^ u) * 16777619u;
+    }
+    return h;
+}
+
+void addDamageItem(float x0, float y0, float x1, float y1, const float* key, int nk) {
+    DamageItem d;
+    d.r.x0 = (int)floorf(x0) - 2; d.r.y0 = (int)floorf(y0) - 2;
+    d.r.x1 = (int)ceilf(x1) + 2;  d.r.y1 = (int)ceilf(y1) + 2;
+    d.key = hashFloats(key, nk);
+    d.group = damageGroup;
+    damageCur.push_back(d);
+}
+
+// Must list items in the same order every frame (matched by index within a
+// group); every list whose length can change starts a new group
+void collectDamageItems() {
+    damageCur.clear();
+    damageGroup = 0;
+
+    // stripes: keyed on the first covered (internal) pixel column, so sub-pixel drift is free.
+    // Under fog each damages the whole game area: the fog triangles span it, so one
+    // repaint costs less than one per stripe
+    for (int i = -5; i < W / 40 + 5; i++) {
+        float x = i * 40.0f + fmodf(bgShift, 40.0f);
+        float k = ceilf(x * renderScale - 0.5f);
+        if (fogActive()) addDamageItem(0, (float)GAME_Y0, (float)W, (float)GAME_Y1, &k, 1);
+        else addDamageItem(x, (float)GAME_Y0, x + 8, (float)GAME_Y1, &k, 1);
+    }
+
+    // HUD
+    damageGroup++;
+    float lives = (float)player.lives, score = (float)player.score;
+    float tl = (float)timeLeft, pm = placeMode + (moverPending ? 0.5f : 0.0f);
+    addDamageItem(0, H - 70.0f, 30.0f * rules.maxLives + 20, H - 20.0f, &lives, 1);
+    addDamageItem(W / 2 - 40.0f, H - 34.0f, W / 2 + 110.0f, H - 16.0f, &score, 1);
+    addDamageItem(W - 130.0f, H - 34.0f, (float)W, H - 16.0f, &tl, 1);
+    float ff[2] = { (float)ffScale(), roundf(ffAchieved) };   // as printed
+    addDamageItem(W - 300.0f, H - 34.0f, W - 145.0f, H - 16.0f, ff, 2);
+    addDamageItem(W - 220.0f, 14.0f, (float)W, 32.0f, &pm, 1);
+
+    // wall tiles: one item per row, keyed on the row's bits
+    damageGroup++;
+    for (int r = 0; r < walls.rows; r++) {
+        float y0 = walls.y0 + r * walls.size;
+        addDamageItem(walls.x0, y0, walls.x0 + walls.cols * walls.size, y0 + walls.size,
+                      reinterpret_cast<const float*>(walls.row(r)), walls.stride * 2);
+    }
+
+    // placed objects (same bob as drawScene)
+    float bob = bobOffset();
+    damageGroup++;
+    for (const auto& o : obstacles) {
+        float k[2] = { o.x, o.y };
+        addDamageItem(o.x - o.r, o.y - o.r, o.x + o.r, o.y + o.r, k, 2);
+    }
+    damageGroup++;
+    for (const auto& b : boxes) {
+        float e = sqrtf(b.hx * b.hx + b.hy * b.hy);
+        float k[3] = { b.x, b.y, b.angle };
+        addDamageItem(b.x - e, b.y - e, b.x + e, b.y + e, k, 3);
+    }
+    damageGroup++;
+    for (const auto& p : polys) {
+        float cx, cy, e; polyBounds(p, cx, cy, e);
+        float k[3] = { cx, cy, (float)p.n };
+        addDamageItem(cx - e, cy - e, cx + e, cy + e, k, 3);
+    }
+    damageGroup++;
+    for (int i = 0; i < movers.count; i++) {
+        float x = movers.x[i], y = movers.y[i], h = movers.h[i];
+        float k[2] = { x, y };
+        addDamageItem(x - h, y - h, x + h, y + h, k, 2);
+    }
+    damageGroup++;
+    for (const auto& c : collectibles) {
+        float y = c.y + bob * 0.25f;
+        float k[2] = { c.x, y };
+        addDamageItem(c.x - c.r, y - c.r, c.x + c.r, y + c.r, k, 2);
+    }
+    damageGroup++;
+    for (const auto& p : powerups) {
+        float y = p.y + bob * 0.35f, e = p.r + 4 + glowReach(); // shield outline is r+3
+        float k[2] = { p.x, y };
+        addDamageItem(p.x - e, y - e, p.x + e, y + e, k, 2);
+    }
+
+    // projectiles and boids move every tick: while any are live the game area is one
+    // item; so is the fog, keyed on its polygon (which also decides what is culled)
+    damageGroup++;
+    float hk[3] = { (shots.count > 0 || (swarmOn && swarm.count > 0)) ? timeSec : 0.0f, hazard + 4.0f * swarmOn,
+                    fogActive() ? (float)hashFloats(fog.dist.data(), fog.bins) : 0.0f };
+    addDamageItem(0, (float)GAME_Y0, (float)W, (float)GAME_Y1, hk, 3);
+
+    int cur[2]; bezierPoint(target.t, target.p0, target.p1, target.p2, target.p3, cur);
+    float tk[2] = { (float)cur[0], (float)cur[1] };
+    addDamageItem(cur[0] - target.r, cur[1] - target.r, cur[0] + target.r, cur[1] + target.r, tk, 2);
+
+    // player: hull, fins, flame and shield ring all fit in ~2r; flame animates every frame
+    float e = player.r * 2.0f + 2 + glowReach();
+    float pk[5] = { player.x, player.y, player.angleDeg, player.shielded ? 1.0f : 0.0f, timeSec };
+    addDamageItem(player.x - e, player.y - e, player.x + e, player.y + e, pk, 5);
+
+    damageGroup++;
+    for (const auto& b : bolts) {
+        float tx = b.x - b.vx / BOLT_SPEED * BOLT_TRAIL, ty = b.y - b.vy / BOLT_SPEED * BOLT_TRAIL;
+        float k[2] = { b.x, b.y };
+        addDamageItem(std::min(b.x, tx) - 2, std::min(b.y, ty) - 2, std::max(b.x, tx) + 2, std::max(b.y, ty) + 2, k, 2);
+    }
 
+    // lidar fan: the box around its hit points, keyed on the scan
+    damageGroup++;
+    if (lidarActive()) {
+        float x0 = player.x, y0 = player.y, x1 = player.x, y1 = player.y;
+        float h = player.angleDeg / RAD2DEG;
+        for (int k = 0; k < LIDAR_VIEW_RAYS; k++) {
+            float sn, cs; fastSinCos(lidarAngle(h, k, LIDAR_VIEW_RAYS, TWO_PI_F), sn, cs);
+            float x = player.x + cs * lidarDist[k], y = player.y + sn * lidarDist[k];
+            x0 = std::min(x0, x); y0 = std::min(y0, y); x1 = std::max(x1, x); y1 = std::max(y1, y);
+        }
+        float lk[4] = { (float)hashFloats(lidarDist, LIDAR_VIEW_RAYS),
+                        (float)hashFloats(reinterpret_cast<const float*>(lidarType), LIDAR_VIEW_RAYS / 4), player.x, player.y };
+        addDamageItem(x0 - 3, y0 - 3, x1 + 3, y1 + 3, lk, 4);
+    }
+}
+
+void addDamage(SoftRect r) {
+    // at reduced scale one internal pixel (plus the bilinear tap) spans several window pixels
+    if (renderScale < 1.0f) {
+        int pad = (int)ceilf(2.0f / renderScale);
+        r.x0 -= pad; r.y0 -= pad; r.x1 += pad; r.y1 += pad;
+    }
+    SoftRect screen = { 0, 0, W, H };
+    r = rectIntersect(r, screen);
+    if (rectEmpty(r)) return;
+    // fold into an existing rect when the union wastes (almost) nothing
+    size_t k = 0;
+    for (; k < damage.size(); k++) {
+        SoftRect u = rectUnion(damage[k], r);
+        if (rectArea(u) <= rectArea(damage[k]) + rectArea(r)) { damage[k] = u; break; }
+    }
+    if (k == damage.size()) damage.push_back(r);
+    // drop rects the grown one now covers (else each repaints the scene again)
+    SoftRect g = damage[k];
+    for (size_t i = damage.size(); i-- > 0;) {
+        const SoftRect& d = damage[i];
+        if (i != k && d.x0 >= g.x0 && d.y0 >= g.y0 && d.x1 <= g.x1 && d.y1 <= g.y1)
+            damage.erase(damage.begin() + i);
+    }
+}
+
+// Too many rects: repeatedly merge the pair whose union adds the least area
+void limitDamage() {
+    while ((int)damage.size() > MAX_DAMAGE_RECTS) {
+        size_t bi = 0, bj = 1;
+        long long best = -1;
+        for (size_t i = 0; i < damage.size(); i++)
+            for (size_t j = i + 1; j < damage.size(); j++) {
+                long long waste = (long long)rectArea(rectUnion(damage[i], damage[j]))
+                    - rectArea(damage[i]) - rectArea(damage[j]);
+                if (best < 0 || waste < best) { best = waste; bi = i; bj = j; }
+            }
+        damage[bi] = rectUnion(damage[bi], damage[bj]);
+        damage.erase(damage.begin() + bj);
+    }
+}
+
+void computeDamage() {
+    collectDamageItems();
+    damage.clear();
+
+    // a phase change repaints everything
+    if ((int)phase != damagePrevPhase) damageAll = true;
+
+    // walk both lists group by group: items past the shorter list of a group
+    // (placed, picked up, destroyed) damage their own rect only
+    int unmatched = 0;
+    for (size_t i = 0, j = 0; !damageAll && (i < damagePrev.size() || j < damageCur.size());) {
+        const DamageItem* a = i < damagePrev.size() ? &damagePrev[i] : nullptr;
+        const DamageItem* b = j < damageCur.size() ? &damageCur[j] : nullptr;
+        if (a && b && a->group == b->group) {
+            i++; j++;
+            if (a->key == b->key && memcmp(&a->r, &b->r, sizeof(SoftRect)) == 0) continue;
+            addDamage(a->r);
+            addDamage(b->r);
+        }
+        else if (a && (!b || a->group < b->group)) { addDamage(a->r); i++; unmatched++; }
+        else { addDamage(b->r); j++; unmatched++; }
+        // bulk changes (clearing, restoring a layout): cheaper to repaint than to merge
+        if (unmatched > MAX_DAMAGE_RECTS) damageAll = true;
+    }
+
+    if (damageAll) {
+        damage.clear();
+        SoftRect all = { 0, 0, W, H };
+        damage.push_back(all);
+    }
+    else limitDamage();
+
+    damagePrev.swap(damageCur);
+    damagePrevPhase = (int)phase;
+    damageAll = false;
+}
+
+void softReportStats(double ms, long long touched, long long presented) {
+    softStatMs += ms; softStatTouched += touched; softStatPresented += presented;
+    softStatRects += (int)damage.size(); softStatFrames++;
+
+    int nowMs = glutGet(GLUT_ELAPSED_TIME);
+    if (nowMs - softStatLastMs < 1000) return;
+    double n = softStatFrames;
+    if (glowOn)
+        printf("[glow] %.2f ms/frame (blur %.2f ms, %d x radius %d, budget %.1f ms)\n",
+            glowStatMs / n, glowStatBlurMs / n, glowPasses, glowRadius, GLOW_BUDGET_MS);
+    glowStatMs = glowStatBlurMs = 0.0;
+    printf("[soft] %.2f ms/frame, %.0f px touched, %.0f px presented (%.1f%% of frame), %.1f rects, scale %d%%%s\n",
+        softStatMs / n, softStatTouched / n, softStatPresented / n,
+        100.0 * softStatPresented / (n * W * H), softStatRects / n,
+        (int)(renderScale * 100 + 0.5f), renderScaleAuto ? " (auto)" : "");
+    softStatMs = 0; softStatTouched = softStatPresented = 0;
+    softStatFrames = softStatRects = 0;
+    softStatLastMs = nowMs;
+}
+
+void setRenderScale(float s) {
+    s = clampf(s, SCALE_MIN, SCALE_MAX);
+    if (s == renderScale) return;
+    printf("[soft] render scale %d%% -> %d%% (%.2f ms/frame avg)\n",
+        (int)(renderScale * 100 + 0.5f), (int)(s * 100 + 0.5f), softFrameMsAvg);
+    renderScale = s;
+    damageAll = true;
+}
+
+// Dynamic mode: drop a step when over budget, climb back when well under it
+void updateRenderScale(double ms) {
+    softFrameMsAvg = softFrameMsAvg * 0.9f + (float)ms * 0.1f;
+    if (!renderScaleAuto) return;
+    if (scaleCooldown > 0) { scaleCooldown--; return; }
+    if (softFrameMsAvg > SCALE_TARGET_MS * 1.1f && renderScale > SCALE_MIN) {
+        setRenderScale(renderScale - SCALE_STEP);
+        scaleCooldown = 30;
+    }
+    else if (softFrameMsAvg < SCALE_TARGET_MS * 0.6f && renderScale < SCALE_MAX) {
+        setRenderScale(renderScale + SCALE_STEP);
+        scaleCooldown = 60; // climbing is slower than backing off
+    }
+}
+
+// Window rect -> internal rect, padded for the bilinear footprint when scaled
+SoftRect internalRect(const SoftRect& r) {
+    if (renderScale >= 1.0f) return r;
+    SoftRect i = { (int)floorf(r.x0 * renderScale) - 2, (int)floorf(r.y0 * renderScale) - 2,
+                   (int)ceilf(r.x1 * renderScale) + 2, (int)ceilf(r.y1 * renderScale) + 2 };
+    SoftRect all = { 0, 0, softFrame.w, softFrame.h };
+    return rectIntersect(i, all);
+}
+
+void softDisplay() {
+    auto t0 = std::chrono::steady_clock::now();
+
+    int iw = (int)(W * renderScale + 0.5f), ih = (int)(H * renderScale + 0.5f);
+    if (softFrame.w != iw || softFrame.h != ih) { softFrame.resize(iw, ih); damageAll = true; }
+    bool scaled = (iw != W || ih != H);
+    if (scaled && (softOut.w != W || softOut.h != H)) softOut.resize(W, H);
+    computeDamage();
+
+    bool glow = glowOn && !damage.empty();
+    auto tg = std::chrono::steady_clock::now();
+    double blurMs = glow ? buildGlow() : 0.0;
+    double glowMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tg).count();
+
+    // repaint: the whole scene, clipped to each damaged rect
+    SoftXform base = { renderScale, 0, 0, renderScale, 0, 0 };
+    softFrame.touched = 0;
+    softLineScale = renderScale;
+    softTexts.clear();
+    SoftFrame& out = scaled ? softOut : softFrame;
+    for (size_t i = 0; i < damage.size(); i++) {
+        softFrame.clip = internalRect(damage[i]);
+        softXf = base;
+        softFillRect(softFrame, 0, 0, (float)iw, (float)ih, 0xFF000000u); // glClear
+        softRecordText = (i == 0);
+        drawScene();
+        // unscaled: glow right after each repaint so overlapping rects get it once
+        if (glow && !scaled) {
+            auto tc = std::chrono::steady_clock::now();
+            softAddGlow2x(softFrame, softGlow, damage[i]);
+            glowMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tc).count();
+        }
+    }
+    softRecordText = false;
+
+    // upscale the damaged window rects (then glow, same reason)
+    if (scaled) {
+        for (const auto& r : damage) {
+            if (upscaleBilinear) softUpscaleBilinear(softFrame, softOut, r);
+            else                 softUpscaleNearest(softFrame, softOut, r);
+            if (glow) {
+                auto tc = std::chrono::steady_clock::now();
+                softAddGlow2x(softOut, softGlow, r);
+                glowMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tc).count();
+            }
+        }
+    }
+    if (glow) {
+        glowStatBlurMs += blurMs; glowStatMs += glowMs;
+        updateGlowBudget(glowMs);
+    }
+
+    // present only the damaged rects (single-buffered window keeps the rest)
+    long long presented = 0;
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, out.w);
+    for (const auto& r : damage) {
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, r.x0);
+        glPixelStorei(GL_UNPACK_SKIP_ROWS, r.y0);
+        glRasterPos2i(r.x0, r.y0);
+        glDrawPixels(r.x1 - r.x0, r.y1 - r.y0, GL_RGBA, GL_UNSIGNED_BYTE, out.px.data());
+        presented += rectArea(r);
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+
+    // text goes on top of whatever was just presented under it
+    for (const auto& t : softTexts) {
+        SoftRect tr = { t.x, t.y - 4, t.x + 9 * (int)strlen(t.s), t.y + 12 };
+        bool hit = false;
+        for (const auto& r : damage) if (!rectEmpty(rectIntersect(tr, r))) { hit = true; break; }
+        if (!hit) continue;
+        glColor3f(t.rgb[0], t.rgb[1], t.rgb[2]);
+        glRasterPos2f((float)t.x, (float)t.y);
+        for (const char* p = t.s; *p; ++p) glutBitmapCharacter(GLUT_BITMAP_9_BY_15, *p);
+    }
 
     glFlush();
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    softReportStats(ms, softFrame.touched, presented);
+    updateRenderScale(ms);
+}
+
+void Display() {
+    animatePanels();
+    updateFog();
+    updateLidar();
+
+    if (backend == BACKEND_SOFT) {
+        softDisplay();
+        return;
+    }
+
+    glClear(GL_COLOR_BUFFER_BIT);
+    drawScene();
+    glFlush();
 }
 
-// ---------------- Input ----------------
-void startRound() {
-    // Player at lower center; target opposite at near top
-    player.x = W * 0.5f; player.y = GAME_Y0 + 40.0f;
-    player.angleDeg = 90; player.lives = MAX_LIVES; player.shielded = false;
-    player.score = 0;
-    player.speedUntil = player.shieldUntil = 0;
 
-    // Target Bezier horizontally across the top band
+// ---------------- Input ----------------
+// Target Bezier horizontally across the top band
+void resetTarget() {
     int yTop = H - TOP_H - 60;
     target.p0[0] = 100; target.p0[1] = yTop;
     target.p1[0] = 300; target.p1[1] = yTop + 80;
     target.p2[0] = 700; target.p2[1] = yTop - 80;
     target.p3[0] = 900; target.p3[1] = yTop;
     target.t = 0.0f; target.dir = +1;
+}
+
+void startRound() {
+    // Player at lower center; target opposite at near top
+    player.x = W * 0.5f; player.y = GAME_Y0 + 40.0f;
+    player.angleDeg = 90; player.lives = rules.maxLives; player.shielded = false;
+    player.score = 0;
+    player.speedUntil = player.shieldUntil = player.magnetUntil = 0;
+
+    if (phase == PHASE_EDIT) saveLayout();
+    else restoreLayout();
+    bolts.clear();
+    boltReadyAt = 0.0f;
+
+    resetTarget();
+    indexCollectibles();
+    rebuildSpawnSpace();
+    nextSpawnAt = timeSec + SPAWN_EVERY;
+    spawnSeed = (uint32_t)glutGet(GLUT_ELAPSED_TIME) | 1;
+    movers.rewind(0);
+    shots.clear();
+    shotCarry = 0.0f;
+    if (swarmOn) spawnSwarm();
+    moverPending = false;
 
     // reset time
     roundStart = timeSec;
-    timeLeft = ROUND_TIME_SEC;
+    timeLeft = (int)rules.roundTime;
 
     musicPlayLoop(L"assets\\bgm.mp3");   // looped BGM
 
@@ -618,12 +2484,90 @@ void Keyboard(unsigned char key, int x, int y) {
         glutPostRedisplay();
         return;
     }
+    if (key == 'b' || key == 'B') { // toggle GL / CPU rasterizer
+        backend = (backend == BACKEND_GL) ? BACKEND_SOFT : BACKEND_GL;
+        damageAll = true;
+        printf("backend: %s\n", backend == BACKEND_GL ? "GL" : "soft");
+        glutPostRedisplay();
+        return;
+    }
+    if (key == 'v' || key == 'V') { // soft render scale: 100% -> 75% -> 50% -> auto
+        if (renderScaleAuto) { renderScaleAuto = false; setRenderScale(1.0f); }
+        else if (renderScale > 0.75f) setRenderScale(0.75f);
+        else if (renderScale > 0.5f) setRenderScale(0.5f);
+        else { renderScaleAuto = true; scaleCooldown = 0; }
+        printf("render scale: %s\n", renderScaleAuto ? "auto" : "fixed");
+        return;
+    }
+    if (key == 'g' || key == 'G') { // soft glow post-process
+        glowOn = !glowOn;
+        damageAll = true;
+        printf("glow: %s\n", glowOn ? "on" : "off");
+        return;
+    }
+    if (key == 'n' || key == 'N') { // upscale filter
+        upscaleBilinear = !upscaleBilinear;
+        damageAll = true;
+        printf("upscale: %s\n", upscaleBilinear ? "bilinear" : "nearest");
+        return;
+    }
+    if ((key == 'm' || key == 'M') && phase == PHASE_EDIT) { // maze walls on / off
+        if (walls.count() > 0) walls.clear();
+        else {
+            tileMaze(walls, MAZE_PITCH, (uint32_t)glutGet(GLUT_ELAPSED_TIME) + 1);
+            tileClearCircle(walls, player.x, player.y, player.r * 2.5f);
+        }
+        printf("maze: %d wall tiles, %d bytes\n", walls.count(), (int)walls.bytes());
+        glutPostRedisplay();
+        return;
+    }
+    if (key == 'h' || key == 'H') { // bullet-hell hazard: off -> on -> stress
+        setHazard((HazardMode)((hazard + 1) % 3));
+        return;
+    }
+    if (key == 'f' || key == 'F') { // fog of war (play only)
+        fogOn = !fogOn;
+        printf("fog: %s\n", fogOn ? "on" : "off");
+        return;
+    }
+    if ((key == 'o' || key == 'O') && phase == PHASE_EDIT) { // save the level for headless worlds
+        EnvLevel L;
+        levelFromEditor(L);
+        bool ok = saveLevel(L, "level.txt");
+        printf("level.txt: %s (%d shapes, %d items, %d wall tiles)\n", ok ? "saved" : "could not write",
+            (int)(L.sqx.size() + L.boxes.size() + L.polys.size()), L.items(), walls.count());
+        return;
+    }
+    if ((key == 'k' || key == 'K') && phase == PHASE_EDIT) { // difficulty estimate from bot rounds
+        EnvLevel L;
+        levelFromEditor(L);
+        L.finish();
+        printDifficulty(estimateDifficulty(L, rules));
+        return;
+    }
+    if (key == 'l' || key == 'L') { // lidar view of the ship's sensors (play only)
+        lidarOn = !lidarOn;
+        printf("lidar: %s (%d rays, %.0f px)\n", lidarOn ? "on" : "off", LIDAR_VIEW_RAYS, LIDAR_RANGE);
+        return;
+    }
+    if (key == 't' || key == 'T') { // fast-forward 1x .. 100x
+        setFastForward((ffLevel + 1) % (int)(sizeof(FF_SCALES) / sizeof(FF_SCALES[0])));
+        return;
+    }
+    if (key == 'e' || key == 'E') { // enemy swarm on / off
+        swarmOn = !swarmOn;
+        if (swarmOn) spawnSwarm();
+        printf("swarm: %s (%d boids, %d threads)\n", swarmOn ? "on" : "off", SWARM_SIZE, workers().size());
+        return;
+    }
+    if (key == ' ') keyFire = true;   // bolts (play only)
     if (key == 'w') keyW = true;
     if (key == 's') keyS = true;
     if (key == 'a') keyA = true;
     if (key == 'd') keyD = true;
 }
 void KeyboardUp(unsigned char key, int x, int y) {
+    if (key == ' ') keyFire = false;
     if (key == 'w') keyW = false;
     if (key == 's') keyS = false;
     if (key == 'a') keyA = false;
@@ -643,6 +2587,7 @@ void SpecialUp(int key, int x, int y) {
 }
 
 void Mouse(int button, int state, int x, int y) {
+    if (button == GLUT_LEFT_BUTTON && state == GLUT_UP) tilePainting = false;
     if (state != GLUT_DOWN || button != GLUT_LEFT_BUTTON) return;
 
     // flip y to OpenGL coords (like your sample 4)
@@ -650,11 +2595,10 @@ void Mouse(int button, int state, int x, int y) {
 
     // If clicked in bottom palette: choose mode
     if (y <= BOT_H) {
-        if (dist2((float)x, (float)y, 80.0f, BOT_H * 0.5f) < 35 * 35) placeMode = PLACE_OBS;
-        else if (dist2((float)x, (float)y, 240.0f, BOT_H * 0.5f) < 35 * 35) placeMode = PLACE_COL;
-        else if (dist2((float)x, (float)y, 400.0f, BOT_H * 0.5f) < 35 * 35) placeMode = PLACE_PU_SPEED;
-        else if (dist2((float)x, (float)y, 560.0f, BOT_H * 0.5f) < 35 * 35) placeMode = PLACE_PU_SHIELD;
-        else placeMode = PLACE_NONE;
+        placeMode = PLACE_NONE;
+        for (int i = 0; i < PALETTE_N; i++)
+            if (dist2((float)x, (float)y, PALETTE_X[i], BOT_H * 0.5f) < 35 * 35) placeMode = (PlaceMode)(i + 1);
+        moverPending = false;
         glutPostRedisplay();
         return;
     }
@@ -664,7 +2608,7 @@ void Mouse(int button, int state, int x, int y) {
         Obj o; o.x = (float)x; o.y = (float)y; o.r = 16.0f;
         if (placeMode == PLACE_OBS) {
             o.type = OBJ_OBSTACLE; o.r = 18.0f;
-            if (!overlapsAny(o.x, o.y, o.r)) obstacles.push_back(o);
+            if (!overlapsAny(o.x, o.y, o.r)) { obstacles.push_back(o); indexShape(SHAPE_SQUARE, (int)obstacles.size() - 1); }
         }
         else if (placeMode == PLACE_COL) {
             o.type = OBJ_COLLECT; o.r = 14.0f;
@@ -678,11 +2622,92 @@ void Mouse(int button, int state, int x, int y) {
             o.type = OBJ_PU_SHIELD; o.r = 14.0f;
             if (!overlapsAny(o.x, o.y, o.r)) powerups.push_back(o);
         }
+        else if (placeMode == PLACE_PU_MAGNET) {
+            o.type = OBJ_PU_MAGNET; o.r = 14.0f;
+            if (!overlapsAny(o.x, o.y, o.r)) powerups.push_back(o);
+        }
+        else if (placeMode == PLACE_BOX) {
+            if (!overlapsAny(o.x, o.y, sqrtf(BOX_HX * BOX_HX + BOX_HY * BOX_HY))) {
+                boxes.push_back(makeEditorBox(o.x, o.y, shapesPlaced++));
+                rebuildShapeBlocks();
+                indexShape(SHAPE_BOX, (int)boxes.size() - 1);
+            }
+        }
+        else if (placeMode == PLACE_POLY) {
+            if (!overlapsAny(o.x, o.y, POLY_R)) {
+                polys.push_back(makeEditorPoly(o.x, o.y, shapesPlaced++));
+                rebuildShapeBlocks();
+                indexShape(SHAPE_POLY, (int)polys.size() - 1);
+            }
+        }
+        else if (placeMode == PLACE_MOVER) {
+            // first click: path start (must be free); second click: path end
+            if (!moverPending) {
+                if (!overlapsAny(o.x, o.y, MOVER_HALF)) { moverPending = true; moverStartX = o.x; moverStartY = o.y; }
+            }
+            else if (!overlapsAny(o.x, o.y, MOVER_HALF)) {
+                float p[4][2];
+                makeMoverPath(moverStartX, moverStartY, o.x, o.y, p);
+                if (!moverPathHitsSpawn(p)) {
+                    movers.add(p, MOVER_HALF, MOVER_SPEED, 0);
+                    moverPending = false;
+                }
+            }
+        }
+        else if (placeMode == PLACE_TILE) {
+            paintTile(o.x, o.y, true);
+            tilePainting = true; tileLastX = o.x; tileLastY = o.y;
+        }
+        if (swarmOn) updateSwarmAvoid();
         glutPostRedisplay();
     }
 }
 
+// Drag with the left button held: keep painting wall tiles
+void Motion(int x, int y) {
+    if (!tilePainting || phase != PHASE_EDIT) return;
+    paintTileStroke((float)x, (float)(H - y));
+    glutPostRedisplay();
+}
+
 // ---------------- Timer (like your sample 3) ----------------
+// Everything the timer advances, over dt
+void simTick(float dt) {
+    timeSec += dt;
+
+    // Animate target even in edit so you can see it move
+    updateTarget(dt);
+    movers.stepLod(dt, player.x, player.y);
+    if (phase == PHASE_PLAY) updateGame(dt);
+    updateBolts(dt);
+    updateSwarm(dt);
+    updateHazard(dt);
+}
+
+// Fast-forward: the frame's time times the scale runs as fixed SIM_DT
+// ticks and only the last state is drawn. Ticks stop at FF_BUDGET_MS of wall
+// time and the rest of the frame's debt is dropped, not owed, so a slow tick
+// lowers the rate instead of freezing the window; the timer is re-armed for
+// what is left of the 16 ms, so the rate is bounded by tick cost alone.
+void fastForward(float dt) {
+    auto t0 = std::chrono::steady_clock::now();
+    ffDebt += (double)dt * ffScale();
+    int ticks = 0;
+    while (ffDebt >= SIM_DT) {
+        simTick(SIM_DT);
+        ffDebt -= SIM_DT;
+        ticks++;
+        if (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() > FF_BUDGET_MS) { ffDebt = 0; break; }
+    }
+    ffSimSec += ticks * (double)SIM_DT;
+    ffWallSec += dt;
+    if (ffWallSec >= 0.5) {
+        ffAchieved = (float)(ffSimSec / ffWallSec);
+        printf("fast-forward: %dx asked, %.1fx got (%d ticks last frame)\n", ffScale(), ffAchieved, ticks);
+        ffSimSec = ffWallSec = 0;
+    }
+}
+
 void Timer(int) {
     static int lastMs = 0;
     int nowMs = glutGet(GLUT_ELAPSED_TIME);
@@ -690,14 +2715,123 @@ void Timer(int) {
     float dt = (nowMs - lastMs) / 1000.0f;
     lastMs = nowMs;
 
-    timeSec += dt;
+    if (ffScale() == 1) {
+        simTick(dt);
+        glutPostRedisplay();
+        glutTimerFunc(16, Timer, 0); // ~60 FPS
+        return;
+    }
+    fastForward(dt);
+    glutPostRedisplay();
+    int spent = glutGet(GLUT_ELAPSED_TIME) - nowMs;
+    glutTimerFunc(std::max(0, 16 - spent), Timer, 0);
+}
 
-    // Animate target even in edit so you can see it move
-    updateTarget(dt);
-    if (phase == PHASE_PLAY) updateGame(dt);
+// ---------------- Benchmarks (--bench-<name>) ----------------
+// The benches live in Benchmarks.h; only the dispatch is here.
+#include "Benchmarks.h"
+
+// Returns true when argv asked for a benchmark (the game does not start)
+bool runBenchmarks(int argc, char** argv) {
+    bool ran = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bench-math") == 0) { benchMath(); ran = true; }
+        else if (strcmp(argv[i], "--bench-tiles") == 0) { benchTiles(); ran = true; }
+        else if (strcmp(argv[i], "--bench-shapes") == 0) { benchShapes(); ran = true; }
+        else if (strcmp(argv[i], "--bench-pairs") == 0) { benchPairs(); ran = true; }
+        else if (strcmp(argv[i], "--bench-movers") == 0) { benchMovers(); ran = true; }
+        else if (strcmp(argv[i], "--bench-lod") == 0) { benchLod(); ran = true; }
+        else if (strcmp(argv[i], "--bench-bullets") == 0) { benchBullets(); ran = true; }
+        else if (strcmp(argv[i], "--bench-boids") == 0) { benchBoids(); ran = true; }
+        else if (strcmp(argv[i], "--bench-destroy") == 0) { benchDestroy(); ran = true; }
+        else if (strcmp(argv[i], "--bench-fog") == 0) { benchFog(); ran = true; }
+        else if (strcmp(argv[i], "--bench-lidar") == 0) { benchLidar(); ran = true; }
+        else if (strcmp(argv[i], "--bench-obs") == 0) { benchObs(); ran = true; }
+        else if (strcmp(argv[i], "--bench-lanes") == 0) { benchLanes(); ran = true; }
+        else if (strcmp(argv[i], "--bench-spawn") == 0) { benchSpawn(); ran = true; }
+        else if (strcmp(argv[i], "--bench-magnet") == 0) { benchMagnet(); ran = true; }
+    }
+    return ran;
+}
 
-    glutPostRedisplay();
-    glutTimerFunc(16, Timer, 0); // ~60 FPS
+// --difficulty level.txt: printDifficulty for a saved level. Returns true when asked
+bool runDifficultyArgs(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--difficulty") != 0) continue;
+        EnvLevel L;
+        if (i + 1 >= argc || !loadLevel(L, argv[i + 1])) { fprintf(stderr, "--difficulty: cannot read level\n"); return true; }
+        L.finish();
+        printDifficulty(estimateDifficulty(L, rules));
+        return true;
+    }
+    return false;
+}
+
+// --sweep level.txt axis... [--rounds N]: CSV on stdout, one line per
+// combination (Sweep.h); --rule values are the base. Returns true when asked
+bool runSweepArgs(int argc, char** argv) {
+    int at = 0, rounds = 16;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--sweep") == 0) at = i;
+        else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) rounds = std::max(1, atoi(argv[i + 1]));
+    }
+    if (!at) return false;
+    EnvLevel L;
+    if (at + 1 >= argc || !loadLevel(L, argv[at + 1])) { fprintf(stderr, "--sweep: cannot read level\n"); return true; }
+    L.finish();
+    std::vector<SweepAxis> axes;
+    for (int i = at + 2; i < argc && strncmp(argv[i], "--", 2) != 0; i++) {
+        SweepAxis a;
+        if (!parseSweepAxis(argv[i], a)) { fprintf(stderr, "--sweep: bad axis '%s'\n", argv[i]); return true; }
+        axes.push_back(a);
+    }
+    EnvRules base = rules;
+    base.repeat = 1;    // the bot decides every tick
+    double t0 = benchNowMs();
+    long n = runSweep(L, base, axes, rounds, stdout);
+    double s = (benchNowMs() - t0) * 1e-3;
+    fprintf(stderr, "%ld combinations x %d rounds in %.1f s (%.0f combinations/s, %d threads)\n", n, rounds, s, n / s, workers().size());
+    return true;
+}
+
+// --evolve level.txt target [--gens N] [--pop P] [--elite E] [--out file]: moves the
+// level's squares and items toward a difficulty score (LevelEvolve.h) and
+// saves the best layout. Returns true when asked
+bool runEvolveArgs(int argc, char** argv) {
+    int at = 0, gens = 30;
+    const char* out = "evolved.txt";
+    EvolveOptions opt;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--evolve") == 0) at = i;
+        else if (strcmp(argv[i], "--gens") == 0 && i + 1 < argc) gens = std::max(1, atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--pop") == 0 && i + 1 < argc) opt.population = std::max(2, atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--elite") == 0 && i + 1 < argc) opt.elite = std::max(1, atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) out = argv[i + 1];
+    }
+    if (!at) return false;
+    EnvLevel L;
+    if (at + 2 >= argc || !loadLevel(L, argv[at + 1])) { fprintf(stderr, "--evolve: need a level and a target score\n"); return true; }
+    opt.target = (float)atof(argv[at + 2]);
+    LevelEvolver ev;
+    double t0 = benchNowMs();
+    ev.init(L, rules, opt);
+    printf("seed score %.1f, target %.1f, %d genomes, %d rounds each\n", ev.pop[0].score, opt.target, (int)ev.pop.size(), opt.rounds);
+    printf("%4s %8s %8s %6s %6s %8s\n", "gen", "best", "off by", "evals", "cached", "ms");
+    double tg = benchNowMs();
+    for (int g = 0; g < gens; g++) {
+        double t = benchNowMs();
+        int e = ev.stats.evaluations, c = ev.stats.cacheHits;
+        ev.generation();
+        const LevelGenome& b = ev.best();
+        printf("%4d %8.1f %8.2f %6d %6d %8.0f\n", g + 1, b.score, b.fitness, ev.stats.evaluations - e, ev.stats.cacheHits - c, benchNowMs() - t);
+    }
+    double ms = benchNowMs() - tg;
+    const LevelGenome& b = ev.best();
+    printf("%d generations in %.1f s: %.1f generations/min, %d evaluations, %d cache hits, %lld cells re-tested, %lld fields refilled (%d threads)\n",
+           gens, ms * 1e-3, gens * 60000.0 / ms, ev.stats.evaluations, ev.stats.cacheHits, ev.stats.cellsRetested, ev.stats.fieldsRefilled,
+           workers().size());
+    printf("best score %.1f; %s %s (%.1f s total)\n", b.score, saveLevel(ev.level(b), out) ? "saved" : "could not save", out, (benchNowMs() - t0) * 1e-3);
+    return true;
 }
 
 // ---------------- Main ----------------
@@ -705,17 +2839,48 @@ void initScene() {
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     gluOrtho2D(0.0, (GLdouble)W, 0.0, (GLdouble)H);
 
-    // Initial player bottom center; target top band Bezier set at startRound()
+    // Initial player bottom center; target on its top band Bezier (startRound resets both)
+    walls.resize((int)(W / TILE_SIZE), (int)((GAME_Y1 - GAME_Y0) / TILE_SIZE), TILE_SIZE, 0, (float)GAME_Y0);
+    movers.init(0, (float)GAME_Y0, (float)W, (float)(GAME_Y1 - GAME_Y0), MOVER_CELL);
+    obstacleGrid.init(0, (float)GAME_Y0, (float)W, (float)(GAME_Y1 - GAME_Y0), OBSTACLE_CELL);
+    itemGrid.init(0, (float)GAME_Y0, (float)W, (float)(GAME_Y1 - GAME_Y0), OBSTACLE_CELL);
+    pickupGrid.init(0, (float)GAME_Y0, (float)W, (float)(GAME_Y1 - GAME_Y0), PICKUP_CELL);
+    fog.init(FOG_BINS);
+    shots.reserve(SHOT_CAPACITY);
+    shots.radius = SHOT_R;
+    // inset so boid triangles (tip 2r ahead) never reach the panels
+    swarm.init(2 * BOID_R, GAME_Y0 + 2 * BOID_R, W - 4 * BOID_R, GAME_Y1 - GAME_Y0 - 4 * BOID_R);
+    resetTarget();
+
     // Begin in EDIT mode (place objects first)
     placeMode = PLACE_NONE;
     phase = PHASE_EDIT;
-    timeLeft = ROUND_TIME_SEC;
+    timeLeft = (int)rules.roundTime;
 }
 
 void DisplayWrapper() { Display(); }
 
+// window (re)exposed: single-buffered soft output must be presented in full
+void Visibility(int state) {
+    if (state == GLUT_VISIBLE) damageAll = true;
+}
+
 int main(int argc, char** argv) {
+    for (int i = 1; i + 1 < argc; i++)
+        if (strcmp(argv[i], "--rule") == 0 && !setRule(rules, argv[++i])) fprintf(stderr, "--rule: unknown '%s'\n", argv[i]);
+    if (runBenchmarks(argc, argv)) return 0;
+    if (runSweepArgs(argc, argv)) return 0;
+    if (runDifficultyArgs(argc, argv)) return 0;
+    if (runEvolveArgs(argc, argv)) return 0;
+
     glutInit(&argc, argv);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--soft") == 0) backend = BACKEND_SOFT;
+        else if (strcmp(argv[i], "--glow") == 0) glowOn = true;
+        else if (strcmp(argv[i], "--scale=auto") == 0) renderScaleAuto = true;
+        else if (strncmp(argv[i], "--scale=", 8) == 0) renderScale = clampf((float)atof(argv[i] + 8), SCALE_MIN, SCALE_MAX);
+    }
+
     glutInitDisplayMode(GLUT_SINGLE | GLUT_RGB);
     glutInitWindowSize(W, H);
     glutCreateWindow("OpenGL 2D Game - GLUT Skeleton");
@@ -726,6 +2891,8 @@ int main(int argc, char** argv) {
     glutSpecialFunc(Special);
     glutSpecialUpFunc(SpecialUp);
     glutMouseFunc(Mouse);
+    glutMotionFunc(Motion);
+    glutVisibilityFunc(Visibility);
     glutTimerFunc(0, Timer, 0);
 
     initScene();
@@ -0,0 +1,94 @@
+// ====== Fork-join worker pool ======
+// parallelFor(n, grain, fn) runs fn(begin, end) over [0, n) in chunks of
+// `grain`, on the calling thread plus persistent workers (hardware threads - 1
+// by default). Chunks are claimed from an atomic counter, so uneven chunks
+// balance themselves; the call returns when every chunk is done.
+//
+// Jobs must not call parallelFor themselves.
+
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include <algorithm>
+
+struct WorkerPool {
+    std::vector<std::thread> threads;
+    std::mutex m;
+    std::condition_variable wake, done;
+    std::function<void(int, int)> job;
+    std::atomic<int> next{ 0 };
+    int jobN = 0, grain = 1, busy = 0;
+    unsigned generation = 0;
+    bool quit = false;
+
+    ~WorkerPool() { stop(); }
+
+    // Total threads including the caller; 0 = hardware_concurrency
+    void setThreads(int total) {
+        stop();
+        if (total <= 0) total = (int)std::max(1u, std::thread::hardware_concurrency());
+        unsigned gen;
+        { std::lock_guard<std::mutex> lk(m); quit = false; gen = generation; }
+        // New threads start level with the last job, not at round 0
+        for (int i = 1; i < total; i++) threads.emplace_back([this, gen] { loop(gen); });
+    }
+    int size() const { return (int)threads.size() + 1; }
+
+    void stop() {
+        { std::lock_guard<std::mutex> lk(m); quit = true; }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+        threads.clear();
+    }
+
+    void work() {
+        for (;;) {
+            int b = next.fetch_add(grain);
+            if (b >= jobN) return;
+            job(b, std::min(b + grain, jobN));
+        }
+    }
+
+    void loop(unsigned seen) {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(m);
+                wake.wait(lk, [&] { return quit || generation != seen; });
+                if (quit) return;
+                seen = generation;
+            }
+            work();
+            std::lock_guard<std::mutex> lk(m);
+            if (--busy == 0) done.notify_one();
+        }
+    }
+
+    void run(int n, int g, const std::function<void(int, int)>& fn) {
+        if (n <= 0) return;
+        if (threads.empty() || n <= g) { fn(0, n); return; }
+        {
+            std::lock_guard<std::mutex> lk(m);
+            job = fn; jobN = n; grain = std::max(1, g); next = 0;
+            busy = (int)threads.size();
+            generation++;
+        }
+        wake.notify_all();
+        work();
+        std::unique_lock<std::mutex> lk(m);
+        done.wait(lk, [&] { return busy == 0; });
+    }
+};
+
+inline WorkerPool& workers() {
+    static WorkerPool pool;
+    static bool started = (pool.setThreads(0), true);
+    (void)started;
+    return pool;
+}
+
+template <class F>
+void parallelFor(int n, int grain, F fn) { workers().run(n, grain, fn); }
@@ -0,0 +1,108 @@
+// ====== Projectile pool (bullet-hell hazard) ======
+// Fixed-capacity SoA pool: live projectiles are always the first `count`
+// entries. step() is a single pass that, four projectiles per SSE op,
+// integrates, ages, culls against the field bounds and wall tiles, and tests
+// against one receiver circle. Survivors are compacted in place (writes never
+// pass reads), and their positions are also written interleaved into `xy`,
+// so the renderer can draw the whole pool as one vertex array.
+//
+// Receiver broadphase: a block of four is rejected with one compare against
+// the receiver's box grown by the projectile radius; only lanes inside it get
+// the exact circle test.
+
+#pragma once
+#include "Math2D.h"
+#include "TileMap.h"
+#include <vector>
+
+struct ProjectilePool {
+    std::vector<float> x, y, vx, vy, life;   // life: seconds left
+    std::vector<float> xy;                   // x0 y0 x1 y1 ... of the live set (after step)
+    int count = 0, capacity = 0;
+    float radius = 3.0f;
+
+    void reserve(int cap) {
+        capacity = cap;
+        for (auto* v : { &x, &y, &vx, &vy, &life }) v->assign(cap, 0.0f);
+        xy.assign((size_t)cap * 2, 0.0f);
+        count = 0;
+    }
+    void clear() { count = 0; }
+
+    bool spawn(float px, float py, float pvx, float pvy, float plife) {
+        if (count == capacity) return false;
+        x[count] = px; y[count] = py; vx[count] = pvx; vy[count] = pvy; life[count] = plife;
+        xy[2 * count] = px; xy[2 * count + 1] = py;
+        count++;
+        return true;
+    }
+
+    // Bounds are the field rect; walls may be empty (rows == 0).
+    // Returns how many projectiles hit the receiver circle (those are removed).
+    int step(float dt, float bx0, float by0, float bx1, float by1, const TileMap& walls,
+             float rx, float ry, float rr) {
+        int w = 0, i = 0, hits = 0;
+        float reach = rr + radius, reach2 = reach * reach;
+        bool tiles = walls.rows > 0 && walls.count() > 0;
+#ifdef MATH2D_SSE
+        float4 vdt = f4(dt), zero = f4(0);
+        float4 lo_x = f4(bx0), lo_y = f4(by0), hi_x = f4(bx1), hi_y = f4(by1);
+        float4 px = f4(rx), py = f4(ry), vr = f4(reach), vr2 = f4(reach2);
+        float tx[4], ty[4];
+        for (; i + 4 <= count; i += 4) {
+            float4 nx = load4(&x[i]) + load4(&vx[i]) * vdt;
+            float4 ny = load4(&y[i]) + load4(&vy[i]) * vdt;
+            float4 nl = load4(&life[i]) - vdt;
+            // dead: expired or outside the field (bit set = dead)
+            int dead = mask4(le4(nl, zero)) | mask4(lt4(nx, lo_x)) | mask4(lt4(ny, lo_y))
+                     | mask4(gt4(nx, hi_x)) | mask4(gt4(ny, hi_y));
+            float4 dx = abs4(nx - px), dy = abs4(ny - py);
+            int near = mask4(lt4(dx, vr)) & mask4(lt4(dy, vr)) & ~dead;
+            if (near) {
+                int h = mask4(lt4(dx * dx + dy * dy, vr2)) & near;
+                dead |= h;
+                while (h) { hits++; h &= h - 1; }
+            }
+            if (tiles && dead != 0xF) {
+                store4(tx, nx); store4(ty, ny);
+                for (int l = 0; l < 4; l++) {
+                    if (dead & (1 << l)) continue;
+                    int c = walls.colAt(tx[l]), r = walls.rowAt(ty[l]);
+                    if (walls.inside(c, r) && walls.get(c, r)) dead |= 1 << l;
+                }
+            }
+            if (!dead) {
+                store4(&x[w], nx); store4(&y[w], ny); store4(&life[w], nl);
+                if (w != i) { store4(&vx[w], load4(&vx[i])); store4(&vy[w], load4(&vy[i])); }
+                store4x2(&xy[2 * (size_t)w], nx, ny);
+                w += 4;
+                continue;
+            }
+            if (dead == 0xF) continue;
+            float sx[4], sy[4], sl[4];
+            store4(sx, nx); store4(sy, ny); store4(sl, nl);
+            for (int l = 0; l < 4; l++) {
+                if (dead & (1 << l)) continue;
+                x[w] = sx[l]; y[w] = sy[l]; life[w] = sl[l];
+                vx[w] = vx[i + l]; vy[w] = vy[i + l];
+                xy[2 * w] = sx[l]; xy[2 * w + 1] = sy[l];
+                w++;
+            }
+        }
+#endif
+        for (; i < count; i++) {
+            float nx = x[i] + vx[i] * dt, ny = y[i] + vy[i] * dt, nl = life[i] - dt;
+            if (nl <= 0 || nx < bx0 || ny < by0 || nx > bx1 || ny > by1) continue;
+            if (fabsf(nx - rx) < reach && fabsf(ny - ry) < reach && dist2(nx, ny, rx, ry) < reach2) { hits++; continue; }
+            if (tiles) {
+                int c = walls.colAt(nx), r = walls.rowAt(ny);
+                if (walls.inside(c, r) && walls.get(c, r)) continue;
+            }
+            x[w] = nx; y[w] = ny; life[w] = nl; vx[w] = vx[i]; vy[w] = vy[i];
+            xy[2 * w] = nx; xy[2 * w + 1] = ny;
+            w++;
+        }
+        count = w;
+        return hits;
+    }
+};
@@ -0,0 +1,125 @@
+// ====== Ray packets ======
+// Four rays from one origin, tested together against one shape at a time:
+// circles, axis-aligned boxes (slabs) and convex CCW polygons (Cyrus-Beck
+// clipping against each edge's half-plane). Each lane keeps its nearest hit
+// distance and a caller tag for what it hit; shapes farther than that change
+// nothing, so lanes start at the sensor range and only shrink.
+//
+// Because the origin is shared, every per-shape term that only depends on the
+// origin is computed once per shape, not once per lane.
+
+#pragma once
+#include "Math2D.h"
+#include <math.h>
+#include <algorithm>
+
+struct RayPacket {
+    float ox, oy;
+    float dx[4], dy[4];     // unit directions
+    float idx[4], idy[4];   // 1/d per axis (1e30 where d is 0)
+    float t[4];             // nearest hit so far
+    int tag[4];             // its tag (-1: none yet)
+
+    void begin(float x, float y, const float* ux, const float* uy, float range) {
+        ox = x; oy = y;
+        for (int l = 0; l < 4; l++) {
+            dx[l] = ux[l]; dy[l] = uy[l];
+            idx[l] = dx[l] != 0 ? 1.0f / dx[l] : 1e30f;
+            idy[l] = dy[l] != 0 ? 1.0f / dy[l] : 1e30f;
+            t[l] = range; tag[l] = -1;
+        }
+    }
+
+    // Lanes in `m` (bit l) take distance th[l]
+    void take(int m, const float* th, int tg) {
+        for (int l = 0; l < 4; l++) if (m >> l & 1) { t[l] = th[l]; tag[l] = tg; }
+    }
+};
+
+inline void rayHitCircle(RayPacket& p, float cx, float cy, float r, int tag) {
+    float mx = p.ox - cx, my = p.oy - cy, c = mx * mx + my * my - r * r;
+    float th[4];
+    int m = 0;
+    if (c <= 0) {   // origin inside: hit at 0
+        for (int l = 0; l < 4; l++) { th[l] = 0; if (p.t[l] > 0) m |= 1 << l; }
+    }
+    else {
+#ifdef MATH2D_SSE
+        float4 b = f4(mx) * load4(p.dx) + f4(my) * load4(p.dy);
+        float4 disc = b * b - f4(c);
+        float4 h = f4(0) - b - sqrt4(max4(disc, f4(0)));
+        float4 ok = and4(le4(f4(0), disc), and4(lt4(b, f4(0)), lt4(h, load4(p.t))));
+        store4(th, h);
+        m = mask4(ok);
+#else
+        for (int l = 0; l < 4; l++) {
+            float b = mx * p.dx[l] + my * p.dy[l], disc = b * b - c;
+            if (disc < 0 || b >= 0) continue;
+            th[l] = -b - sqrtf(disc);
+            if (th[l] < p.t[l]) m |= 1 << l;
+        }
+#endif
+    }
+    p.take(m, th, tag);
+}
+
+inline void rayHitBox(RayPacket& p, float x0, float y0, float x1, float y1, int tag) {
+    float ax = x0 - p.ox, bx = x1 - p.ox, ay = y0 - p.oy, by = y1 - p.oy;
+    float th[4];
+    int m = 0;
+#ifdef MATH2D_SSE
+    float4 ix = load4(p.idx), iy = load4(p.idy);
+    float4 tx0 = f4(ax) * ix, tx1 = f4(bx) * ix, ty0 = f4(ay) * iy, ty1 = f4(by) * iy;
+    float4 tin = max4(max4(min4(tx0, tx1), min4(ty0, ty1)), f4(0));
+    float4 tout = min4(max4(tx0, tx1), max4(ty0, ty1));
+    store4(th, tin);
+    m = mask4(and4(le4(tin, tout), lt4(tin, load4(p.t))));
+#else
+    for (int l = 0; l < 4; l++) {
+        float tx0 = ax * p.idx[l], tx1 = bx * p.idx[l], ty0 = ay * p.idy[l], ty1 = by * p.idy[l];
+        float tin = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), 0.0f);
+        float tout = std::min(std::max(tx0, tx1), std::max(ty0, ty1));
+        th[l] = tin;
+        if (tin <= tout && tin < p.t[l]) m |= 1 << l;
+    }
+#endif
+    p.take(m, th, tag);
+}
+
+// CCW polygon: inside is num >= t * den for every edge, with num the origin's
+// distance inside the edge and den the ray's speed out through it
+inline void rayHitConvex(RayPacket& p, const float* px, const float* py, int n, int tag) {
+    float th[4];
+    int m = 0;
+#ifdef MATH2D_SSE
+    float4 dx = load4(p.dx), dy = load4(p.dy), zero = f4(0);
+    float4 tin = zero, tout = f4(1e30f);
+    for (int i = 0; i < n; i++) {
+        int j = (i + 1 == n) ? 0 : i + 1;
+        float nx = py[j] - py[i], ny = px[i] - px[j];   // outward normal
+        float num = nx * (px[i] - p.ox) + ny * (py[i] - p.oy);
+        float4 den = f4(nx) * dx + f4(ny) * dy + zero;  // + 0 turns -0 into +0
+        float4 q = f4(num) / den;                       // 0/0 = NaN: min/max below keep the old bound
+        float4 enter = lt4(den, zero);
+        tin = select4(enter, max4(q, tin), tin);
+        tout = select4(enter, tout, min4(q, tout));
+    }
+    store4(th, tin);
+    m = mask4(and4(le4(tin, tout), lt4(tin, load4(p.t))));
+#else
+    for (int l = 0; l < 4; l++) {
+        float tin = 0, tout = 1e30f;
+        for (int i = 0; i < n && tin <= tout; i++) {
+            int j = (i + 1 == n) ? 0 : i + 1;
+            float nx = py[j] - py[i], ny = px[i] - px[j];
+            float num = nx * (px[i] - p.ox) + ny * (py[i] - p.oy), den = nx * p.dx[l] + ny * p.dy[l];
+            if (den < 0) tin = std::max(tin, num / den);
+            else if (den > 0) tout = std::min(tout, num / den);
+            else if (num < 0) tout = -1;
+        }
+        th[l] = tin;
+        if (tin <= tout && tin < p.t[l]) m |= 1 << l;
+    }
+#endif
+    p.take(m, th, tag);
+}
@@ -0,0 +1,360 @@
+// ====== Software rasterizer (CPU backend, no GL) ======
+// Span-based fills, lines and points into an RGBA8 framebuffer.
+// Rows are stored bottom-up and coordinates match gluOrtho2D(0, W, 0, H),
+// so the buffer can be handed to glDrawPixels as-is.
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define SOFT_SSE2 1
+#endif
+
+// Half-open pixel rectangle [x0,x1) x [y0,y1)
+struct SoftRect {
+    int x0, y0, x1, y1;
+};
+
+inline bool rectEmpty(const SoftRect& r) { return r.x0 >= r.x1 || r.y0 >= r.y1; }
+inline int  rectArea(const SoftRect& r) { return rectEmpty(r) ? 0 : (r.x1 - r.x0) * (r.y1 - r.y0); }
+
+inline SoftRect rectUnion(const SoftRect& a, const SoftRect& b) {
+    if (rectEmpty(a)) return b;
+    if (rectEmpty(b)) return a;
+    SoftRect r = { std::min(a.x0, b.x0), std::min(a.y0, b.y0), std::max(a.x1, b.x1), std::max(a.y1, b.y1) };
+    return r;
+}
+
+inline SoftRect rectIntersect(const SoftRect& a, const SoftRect& b) {
+    SoftRect r = { std::max(a.x0, b.x0), std::max(a.y0, b.y0), std::min(a.x1, b.x1), std::min(a.y1, b.y1) };
+    return r;
+}
+
+// Byte order R,G,B,A in memory (GL_RGBA / GL_UNSIGNED_BYTE on little endian)
+inline uint32_t packRGB(float r, float g, float b) {
+    int ri = (int)(r * 255.0f + 0.5f), gi = (int)(g * 255.0f + 0.5f), bi = (int)(b * 255.0f + 0.5f);
+    ri = ri < 0 ? 0 : (ri > 255 ? 255 : ri);
+    gi = gi < 0 ? 0 : (gi > 255 ? 255 : gi);
+    bi = bi < 0 ? 0 : (bi > 255 ? 255 : bi);
+    return (uint32_t)ri | ((uint32_t)gi << 8) | ((uint32_t)bi << 16) | 0xFF000000u;
+}
+
+struct SoftFrame {
+    int w = 0, h = 0;
+    std::vector<uint32_t> px;
+    SoftRect clip = { 0, 0, 0, 0 };   // writes outside are dropped
+    long long touched = 0;            // pixels written (reset by the caller)
+
+    void resize(int nw, int nh) {
+        w = nw; h = nh;
+        px.assign((size_t)w * h, 0xFF000000u);
+        SoftRect all = { 0, 0, w, h };
+        clip = all;
+    }
+    uint32_t* row(int y) { return &px[(size_t)y * w]; }
+};
+
+// Horizontal run [x0,x1) on row y, clipped
+inline void softSpan(SoftFrame& f, int y, int x0, int x1, uint32_t c) {
+    if (y < f.clip.y0 || y >= f.clip.y1) return;
+    if (x0 < f.clip.x0) x0 = f.clip.x0;
+    if (x1 > f.clip.x1) x1 = f.clip.x1;
+    if (x0 >= x1) return;
+    std::fill_n(f.row(y) + x0, x1 - x0, c);
+    f.touched += x1 - x0;
+}
+
+// Pixel centers (x+0.5, y+0.5) inside [x0,x1) x [y0,y1) are filled, like GL
+inline void softFillRect(SoftFrame& f, float x0, float y0, float x1, float y1, uint32_t c) {
+    if (x0 > x1) std::swap(x0, x1);
+    if (y0 > y1) std::swap(y0, y1);
+    int ix0 = (int)ceilf(x0 - 0.5f), ix1 = (int)ceilf(x1 - 0.5f);
+    int iy0 = (int)ceilf(y0 - 0.5f), iy1 = (int)ceilf(y1 - 0.5f);
+    iy0 = std::max(iy0, f.clip.y0); iy1 = std::min(iy1, f.clip.y1);
+    for (int y = iy0; y < iy1; y++) softSpan(f, y, ix0, ix1, c);
+}
+
+// Any vertex list whose filled outline is convex (polygon, fan, quad, triangle).
+// Each scanline takes the min/max of its edge crossings.
+inline void softFillConvex(SoftFrame& f, const float* xy, int n, uint32_t c) {
+    if (n < 3) return;
+    float minY = xy[1], maxY = xy[1], minX = xy[0], maxX = xy[0];
+    for (int i = 1; i < n; i++) {
+        minX = std::min(minX, xy[2 * i]);     maxX = std::max(maxX, xy[2 * i]);
+        minY = std::min(minY, xy[2 * i + 1]); maxY = std::max(maxY, xy[2 * i + 1]);
+    }
+    if (maxX < f.clip.x0 || minX > f.clip.x1 || maxY < f.clip.y0 || minY > f.clip.y1) return;
+
+    int iy0 = std::max((int)ceilf(minY - 0.5f), f.clip.y0);
+    int iy1 = std::min((int)ceilf(maxY - 0.5f), f.clip.y1);
+    for (int y = iy0; y < iy1; y++) {
+        float yc = y + 0.5f;
+        float xl = 1e30f, xr = -1e30f;
+        for (int i = 0; i < n; i++) {
+            int j = (i + 1 == n) ? 0 : i + 1;
+            float ya = xy[2 * i + 1], yb = xy[2 * j + 1];
+            if ((yc < ya) == (yc < yb)) continue; // edge does not cross this row
+            float xa = xy[2 * i], xb = xy[2 * j];
+            // walk every edge top-down so polygons sharing it agree to the bit (no seams)
+            if (ya > yb) { std::swap(xa, xb); std::swap(ya, yb); }
+            float x = xa + (yc - ya) * (xb - xa) / (yb - ya);
+            xl = std::min(xl, x); xr = std::max(xr, x);
+        }
+        if (xl < xr) softSpan(f, y, (int)ceilf(xl - 0.5f), (int)ceilf(xr - 0.5f), c);
+    }
+}
+
+// Square dot of side `size` centred on (x,y)
+inline void softPoint(SoftFrame& f, float x, float y, float size, uint32_t c) {
+    float h = size * 0.5f;
+    softFillRect(f, x - h, y - h, x + h, y + h, c);
+}
+
+// Batch of same-size dots from interleaved x,y, mapped by x*sx+tx, y*sy+ty.
+// Integer rounding and one clip reject per dot; for large particle counts.
+inline void softPoints(SoftFrame& f, const float* xy, int n, float sx, float sy, float tx, float ty,
+                       float size, uint32_t c) {
+    int s = std::max(1, (int)(size + 0.5f));
+    float off = 0.5f - s * 0.5f;   // top-left pixel = round(center - size/2)
+    const SoftRect& cl = f.clip;
+    for (int i = 0; i < n; i++) {
+        int x0 = (int)floorf(xy[2 * i] * sx + tx + off), y0 = (int)floorf(xy[2 * i + 1] * sy + ty + off);
+        int x1 = x0 + s, y1 = y0 + s;
+        if (x1 <= cl.x0 || x0 >= cl.x1 || y1 <= cl.y0 || y0 >= cl.y1) continue;
+        x0 = std::max(x0, cl.x0); x1 = std::min(x1, cl.x1);
+        y0 = std::max(y0, cl.y0); y1 = std::min(y1, cl.y1);
+        for (int y = y0; y < y1; y++) std::fill_n(f.row(y) + x0, x1 - x0, c);
+        f.touched += (long long)(x1 - x0) * (y1 - y0);
+    }
+}
+
+// DDA line; width > 1 stamps square dots
+inline void softLine(SoftFrame& f, float x0, float y0, float x1, float y1, float width, uint32_t c) {
+    float dx = x1 - x0, dy = y1 - y0;
+    float len = std::max(fabsf(dx), fabsf(dy));
+    int steps = (int)ceilf(len);
+    if (steps < 1) steps = 1;
+    float sx = dx / steps, sy = dy / steps;
+    float x = x0, y = y0;
+    if (width <= 1.0f) {
+        for (int i = 0; i <= steps; i++, x += sx, y += sy) {
+            int px = (int)floorf(x), py = (int)floorf(y);
+            softSpan(f, py, px, px + 1, c);
+        }
+    }
+    else {
+        for (int i = 0; i <= steps; i++, x += sx, y += sy) softPoint(f, x, y, width, c);
+    }
+}
+
+// ---------------- Upscale (internal resolution -> window) ----------------
+// Pixel centers map as src = (dst + 0.5) * srcSize / dstSize - 0.5.
+// Only dstRect is written; callers pass the damaged output rects.
+
+inline void softUpscaleNearest(const SoftFrame& src, SoftFrame& dst, const SoftRect& dstRect) {
+    float sx = (float)src.w / dst.w, sy = (float)src.h / dst.h;
+    static std::vector<int> xmap;
+    xmap.resize(dst.w);
+    for (int x = dstRect.x0; x < dstRect.x1; x++) xmap[x] = std::min((int)((x + 0.5f) * sx), src.w - 1);
+    for (int y = dstRect.y0; y < dstRect.y1; y++) {
+        const uint32_t* s = &src.px[(size_t)std::min((int)((y + 0.5f) * sy), src.h - 1) * src.w];
+        uint32_t* d = dst.row(y);
+        for (int x = dstRect.x0; x < dstRect.x1; x++) d[x] = s[xmap[x]];
+    }
+}
+
+// Bilinear with 7-bit fixed point weights. The vertical blend runs 4 pixels per
+// SSE2 register into a scratch row, then the horizontal blend 2 pixels at a time.
+inline void softUpscaleBilinear(const SoftFrame& src, SoftFrame& dst, const SoftRect& dstRect) {
+    float sx = (float)src.w / dst.w, sy = (float)src.h / dst.h;
+    static std::vector<int> x0s;
+    static std::vector<uint16_t> fxs;
+    static std::vector<uint32_t> tmp;
+    x0s.resize(dst.w); fxs.resize(dst.w); tmp.resize(src.w + 4);
+
+    for (int x = dstRect.x0; x < dstRect.x1; x++) {
+        float fx = std::max((x + 0.5f) * sx - 0.5f, 0.0f);
+        int ix = std::min((int)fx, src.w - 1);
+        x0s[x] = ix;
+        fxs[x] = (ix + 1 < src.w) ? (uint16_t)((fx - ix) * 128.0f) : 0;
+    }
+
+    // source columns this rect reads
+    int cx0 = x0s[dstRect.x0], cx1 = std::min(x0s[dstRect.x1 - 1] + 2, src.w);
+
+    for (int y = dstRect.y0; y < dstRect.y1; y++) {
+        float fy = std::max((y + 0.5f) * sy - 0.5f, 0.0f);
+        int iy = std::min((int)fy, src.h - 1);
+        int iy1 = std::min(iy + 1, src.h - 1);
+        int wy = (int)((fy - iy) * 128.0f);
+        const uint32_t* r0 = &src.px[(size_t)iy * src.w];
+        const uint32_t* r1 = &src.px[(size_t)iy1 * src.w];
+
+        // vertical: tmp = r0 + (r1 - r0) * wy / 128
+        int x = cx0;
+#ifdef SOFT_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i vwy = _mm_set1_epi16((short)wy);
+        for (; x + 4 <= cx1; x += 4) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(r0 + x));
+            __m128i b = _mm_loadu_si128((const __m128i*)(r1 + x));
+            __m128i alo = _mm_unpacklo_epi8(a, zero), ahi = _mm_unpackhi_epi8(a, zero);
+            __m128i blo = _mm_unpacklo_epi8(b, zero), bhi = _mm_unpackhi_epi8(b, zero);
+            __m128i lo = _mm_add_epi16(alo, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(blo, alo), vwy), 7));
+            __m128i hi = _mm_add_epi16(ahi, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(bhi, ahi), vwy), 7));
+            _mm_storeu_si128((__m128i*)(&tmp[x]), _mm_packus_epi16(lo, hi));
+        }
+#endif
+        for (; x < cx1; x++) {
+            uint32_t a = r0[x], b = r1[x], o = 0;
+            for (int c = 0; c < 32; c += 8) {
+                int ca = (a >> c) & 255, cb = (b >> c) & 255;
+                o |= (uint32_t)(ca + (((cb - ca) * wy) >> 7)) << c;
+            }
+            tmp[x] = o;
+        }
+        tmp[cx1] = tmp[cx1 - 1]; // right edge reads one past
+
+        // horizontal: out = tmp[x0] + (tmp[x0+1] - tmp[x0]) * fx / 128
+        uint32_t* d = dst.row(y);
+        int ox = dstRect.x0;
+#ifdef SOFT_SSE2
+        for (; ox + 2 <= dstRect.x1; ox += 2) {
+            int xa = x0s[ox], xb = x0s[ox + 1];
+            __m128i p0 = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, (int)tmp[xb], (int)tmp[xa]), zero);
+            __m128i p1 = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, (int)tmp[xb + 1], (int)tmp[xa + 1]), zero);
+            __m128i w = _mm_set_epi16(fxs[ox + 1], fxs[ox + 1], fxs[ox + 1], fxs[ox + 1], fxs[ox], fxs[ox], fxs[ox], fxs[ox]);
+            __m128i r = _mm_add_epi16(p0, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(p1, p0), w), 7));
+            _mm_storel_epi64((__m128i*)(d + ox), _mm_packus_epi16(r, zero));
+        }
+#endif
+        for (; ox < dstRect.x1; ox++) {
+            uint32_t a = tmp[x0s[ox]], b = tmp[x0s[ox] + 1], o = 0;
+            int wx = fxs[ox];
+            for (int c = 0; c < 32; c += 8) {
+                int ca = (a >> c) & 255, cb = (b >> c) & 255;
+                o |= (uint32_t)(ca + (((cb - ca) * wx) >> 7)) << c;
+            }
+            d[ox] = o;
+        }
+    }
+}
+
+// ---------------- Glow (blur + additive composite) ----------------
+
+// Separable box blur of radius r (1..128) over `rect` only: dst gets src
+// blurred there, reading src up to r past the rect (zero past the frame
+// edges). src may be dst. Both passes keep running sums in 16-bit lanes: the
+// horizontal pass packs two rows into one register, the vertical pass slides
+// a row of column sums down the rect.
+inline void softBoxBlur(const SoftFrame& src, SoftFrame& dst, std::vector<uint32_t>& tmp, int r, const SoftRect& rect) {
+    int w = src.w, h = src.h;
+    if (rectEmpty(rect)) return;
+    tmp.resize((size_t)w * h);
+    const uint16_t inv = (uint16_t)(65536 / (2 * r + 1) - 1);
+    const int x0 = rect.x0, x1 = rect.x1, ya = std::max(0, rect.y0 - r), yb = std::min(h, rect.y1 + r);
+
+    // horizontal: src -> tmp, for the rows the vertical pass reads
+    for (int y = ya; y < yb; y += 2) {
+        const uint32_t* a = &src.px[(size_t)y * w];
+        const uint32_t* b = (y + 1 < yb) ? a + w : a;
+        uint32_t* da = &tmp[(size_t)y * w];
+        uint32_t* db = (y + 1 < yb) ? da + w : da;
+#ifdef SOFT_SSE2
+        const __m128i zero = _mm_setzero_si128(), vinv = _mm_set1_epi16((short)inv);
+        __m128i sum = zero;
+        for (int x = std::max(0, x0 - r); x <= x0 + r && x < w; x++)
+            sum = _mm_add_epi16(sum, _mm_unpacklo_epi8(_mm_set_epi32(0, 0, (int)b[x], (int)a[x]), zero));
+        for (int x = x0; x < x1; x++) {
+            __m128i o = _mm_packus_epi16(_mm_mulhi_epu16(sum, vinv), zero);
+            db[x] = (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(o, 4));
+            da[x] = (uint32_t)_mm_cvtsi128_si32(o);
+            if (x + r + 1 < w) sum = _mm_add_epi16(sum, _mm_unpacklo_epi8(_mm_set_epi32(0, 0, (int)b[x + r + 1], (int)a[x + r + 1]), zero));
+            if (x - r >= 0)    sum = _mm_sub_epi16(sum, _mm_unpacklo_epi8(_mm_set_epi32(0, 0, (int)b[x - r], (int)a[x - r]), zero));
+        }
+#else
+        for (int row = 0; row < 2; row++) {
+            const uint32_t* s = row ? b : a;
+            uint32_t* d = row ? db : da;
+            int sum[4] = { 0, 0, 0, 0 };
+            for (int x = std::max(0, x0 - r); x <= x0 + r && x < w; x++) for (int c = 0; c < 4; c++) sum[c] += (s[x] >> (8 * c)) & 255;
+            for (int x = x0; x < x1; x++) {
+                uint32_t o = 0;
+                for (int c = 0; c < 4; c++) o |= (uint32_t)((sum[c] * inv) >> 16) << (8 * c);
+                d[x] = o;
+                for (int c = 0; c < 4; c++) {
+                    if (x + r + 1 < w) sum[c] += (s[x + r + 1] >> (8 * c)) & 255;
+                    if (x - r >= 0)    sum[c] -= (s[x - r] >> (8 * c)) & 255;
+                }
+            }
+        }
+#endif
+    }
+
+    // vertical: tmp -> dst, column sums for 4 pixels (16 channels) per step
+    const int n = (x1 - x0) * 4;
+    static std::vector<uint16_t> sums;
+    sums.assign((size_t)n + 16, 0);
+    auto addRow = [&](int y, int sign) {
+        const uint8_t* s = (const uint8_t*)&tmp[(size_t)y * w + x0];
+        int i = 0;
+#ifdef SOFT_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= n; i += 16) {
+            __m128i p = _mm_loadu_si128((const __m128i*)(s + i));
+            __m128i s0 = _mm_loadu_si128((const __m128i*)(&sums[i]));
+            __m128i s1 = _mm_loadu_si128((const __m128i*)(&sums[i + 8]));
+            if (sign > 0) { s0 = _mm_add_epi16(s0, _mm_unpacklo_epi8(p, zero)); s1 = _mm_add_epi16(s1, _mm_unpackhi_epi8(p, zero)); }
+            else          { s0 = _mm_sub_epi16(s0, _mm_unpacklo_epi8(p, zero)); s1 = _mm_sub_epi16(s1, _mm_unpackhi_epi8(p, zero)); }
+            _mm_storeu_si128((__m128i*)(&sums[i]), s0);
+            _mm_storeu_si128((__m128i*)(&sums[i + 8]), s1);
+        }
+#endif
+        for (; i < n; i++) sums[i] = (uint16_t)(sums[i] + sign * s[i]);
+    };
+    for (int y = ya; y <= rect.y0 + r && y < h; y++) addRow(y, +1);
+    for (int y = rect.y0; y < rect.y1; y++) {
+        uint8_t* d = (uint8_t*)(dst.row(y) + x0);
+        int i = 0;
+#ifdef SOFT_SSE2
+        const __m128i vinv = _mm_set1_epi16((short)inv);
+        for (; i + 16 <= n; i += 16) {
+            __m128i s0 = _mm_mulhi_epu16(_mm_loadu_si128((const __m128i*)(&sums[i])), vinv);
+            __m128i s1 = _mm_mulhi_epu16(_mm_loadu_si128((const __m128i*)(&sums[i + 8])), vinv);
+            _mm_storeu_si128((__m128i*)(d + i), _mm_packus_epi16(s0, s1));
+        }
+#endif
+        for (; i < n; i++) d[i] = (uint8_t)((sums[i] * inv) >> 16);
+        if (y + r + 1 < yb) addRow(y + r + 1, +1);
+        if (y - r >= 0)     addRow(y - r, -1);
+    }
+}
+
+// dst += glow (saturating), glow at half resolution sampled nearest; only rect is touched
+inline void softAddGlow2x(SoftFrame& dst, const SoftFrame& glow, const SoftRect& rect) {
+    for (int y = rect.y0; y < rect.y1; y++) {
+        const uint32_t* g = &glow.px[(size_t)std::min(y >> 1, glow.h - 1) * glow.w];
+        uint32_t* d = dst.row(y);
+        int x = rect.x0;
+        auto addPx = [&](int xx) {
+            uint32_t a = d[xx], b = g[std::min(xx >> 1, glow.w - 1)], o = 0;
+            for (int c = 0; c < 32; c += 8) o |= (uint32_t)std::min(255u, ((a >> c) & 255) + ((b >> c) & 255)) << c;
+            d[xx] = o;
+        };
+        if (x & 1) addPx(x++);
+#ifdef SOFT_SSE2
+        for (; x + 4 <= rect.x1 && (x >> 1) + 2 <= glow.w; x += 4) {
+            __m128i gg = _mm_loadl_epi64((const __m128i*)(g + (x >> 1)));
+            gg = _mm_unpacklo_epi32(gg, gg); // g0 g0 g1 g1
+            __m128i dd = _mm_loadu_si128((const __m128i*)(d + x));
+            _mm_storeu_si128((__m128i*)(d + x), _mm_adds_epu8(dd, gg));
+        }
+#endif
+        for (; x < rect.x1; x++) addPx(x);
+    }
+}
@@ -0,0 +1,125 @@
+// ====== Uniform spatial grid (incremental) ======
+// Buckets object ids by the cells their bounding box overlaps. Objects keep
+// their CellRange; when it changes, move() only edits the cells that were left
+// or entered, so a tick where nothing crosses a cell line costs one compare
+// per object. Cells are small unsorted id lists with swap-remove.
+//
+// Queries may report an id once per overlapped cell; callers that need unique
+// ids filter them (any-hit tests don't care).
+
+#pragma once
+#include <stdint.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+struct CellRange {
+    int16_t c0, r0, c1, r1;   // inclusive; c0 > c1 means empty
+    bool operator==(const CellRange& o) const { return c0 == o.c0 && r0 == o.r0 && c1 == o.c1 && r1 == o.r1; }
+    bool operator!=(const CellRange& o) const { return !(*this == o); }
+    bool contains(int c, int r) const { return c >= c0 && c <= c1 && r >= r0 && r <= r1; }
+};
+
+const CellRange CELL_RANGE_EMPTY = { 0, 0, -1, -1 };
+
+struct SpatialGrid {
+    float x0 = 0, y0 = 0, cell = 1, inv = 1;
+    int cols = 0, rows = 0;
+    std::vector<std::vector<int>> cells;
+    long long cellEdits = 0;   // inserts + removes since reset (stats)
+
+    void init(float ox, float oy, float w, float h, float cellSize) {
+        x0 = ox; y0 = oy; cell = cellSize; inv = 1.0f / cellSize;
+        cols = std::max(1, (int)ceilf(w * inv));
+        rows = std::max(1, (int)ceilf(h * inv));
+        cells.assign((size_t)cols * rows, std::vector<int>());
+        cellEdits = 0;
+    }
+    void clear() {
+        for (auto& c : cells) c.clear();
+    }
+
+    // Cells overlapped by a box, clamped to the grid
+    CellRange range(float minx, float miny, float maxx, float maxy) const {
+        CellRange r;
+        r.c0 = (int16_t)std::max(0, std::min(cols - 1, (int)floorf((minx - x0) * inv)));
+        r.c1 = (int16_t)std::max(0, std::min(cols - 1, (int)floorf((maxx - x0) * inv)));
+        r.r0 = (int16_t)std::max(0, std::min(rows - 1, (int)floorf((miny - y0) * inv)));
+        r.r1 = (int16_t)std::max(0, std::min(rows - 1, (int)floorf((maxy - y0) * inv)));
+        return r;
+    }
+
+    std::vector<int>& at(int c, int r) { return cells[(size_t)r * cols + c]; }
+    const std::vector<int>& at(int c, int r) const { return cells[(size_t)r * cols + c]; }
+
+    void insert(int id, const CellRange& cr) {
+        for (int r = cr.r0; r <= cr.r1; r++)
+            for (int c = cr.c0; c <= cr.c1; c++) { at(c, r).push_back(id); cellEdits++; }
+    }
+
+    void removeFrom(std::vector<int>& v, int id) {
+        for (size_t i = 0; i < v.size(); i++)
+            if (v[i] == id) { v[i] = v.back(); v.pop_back(); cellEdits++; return; }
+    }
+
+    void remove(int id, const CellRange& cr) {
+        for (int r = cr.r0; r <= cr.r1; r++)
+            for (int c = cr.c0; c <= cr.c1; c++) removeFrom(at(c, r), id);
+    }
+
+    // Renames an id in place (after a swap-remove moved its object)
+    void relabel(int from, int to, const CellRange& cr) {
+        for (int r = cr.r0; r <= cr.r1; r++)
+            for (int c = cr.c0; c <= cr.c1; c++)
+                for (int& id : at(c, r)) if (id == from) { id = to; cellEdits++; break; }
+    }
+
+    // Only the cells in from\to lose the id and only to\from gain it
+    void move(int id, const CellRange& from, const CellRange& to) {
+        for (int r = from.r0; r <= from.r1; r++)
+            for (int c = from.c0; c <= from.c1; c++)
+                if (!to.contains(c, r)) removeFrom(at(c, r), id);
+        for (int r = to.r0; r <= to.r1; r++)
+            for (int c = to.c0; c <= to.c1; c++)
+                if (!from.contains(c, r)) { at(c, r).push_back(id); cellEdits++; }
+    }
+
+    // Cells crossed by o + t d, t in [0, tMax], in order (DDA): fn(c, r, t where
+    // the ray leaves the cell); stops early when fn returns true.
+    // d need not be unit length; t is in its units.
+    template <class F>
+    bool walkRay(float ox, float oy, float dx, float dy, float tMax, F fn) const {
+        const float INF = 1e30f;
+        // clip to the grid's box
+        float t0 = 0, t1 = tMax, gx1 = x0 + cols * cell, gy1 = y0 + rows * cell;
+        if (dx != 0) { float a = (x0 - ox) / dx, b = (gx1 - ox) / dx; t0 = std::max(t0, std::min(a, b)); t1 = std::min(t1, std::max(a, b)); }
+        else if (ox < x0 || ox >= gx1) return false;
+        if (dy != 0) { float a = (y0 - oy) / dy, b = (gy1 - oy) / dy; t0 = std::max(t0, std::min(a, b)); t1 = std::min(t1, std::max(a, b)); }
+        else if (oy < y0 || oy >= gy1) return false;
+        if (t0 > t1) return false;
+
+        int c = std::max(0, std::min(cols - 1, (int)floorf((ox + dx * t0 - x0) * inv)));
+        int r = std::max(0, std::min(rows - 1, (int)floorf((oy + dy * t0 - y0) * inv)));
+        int sc = dx > 0 ? 1 : -1, sr = dy > 0 ? 1 : -1;
+        float nextX = dx != 0 ? (x0 + (c + (dx > 0)) * cell - ox) / dx : INF, stepX = dx != 0 ? cell / fabsf(dx) : INF;
+        float nextY = dy != 0 ? (y0 + (r + (dy > 0)) * cell - oy) / dy : INF, stepY = dy != 0 ? cell / fabsf(dy) : INF;
+        for (;;) {
+            float exit = std::min(std::min(nextX, nextY), t1);
+            if (fn(c, r, exit)) return true;
+            if (exit >= t1) return false;
+            if (nextX < nextY) { c += sc; nextX += stepX; }
+            else { r += sr; nextY += stepY; }
+            if (c < 0 || c >= cols || r < 0 || r >= rows) return false;
+        }
+    }
+
+    // fn(id) for ids in cells overlapping the box; stops early when fn returns true
+    template <class F>
+    bool query(float minx, float miny, float maxx, float maxy, F fn) const {
+        CellRange cr = range(minx, miny, maxx, maxy);
+        for (int r = cr.r0; r <= cr.r1; r++)
+            for (int c = cr.c0; c <= cr.c1; c++)
+                for (int id : at(c, r)) if (fn(id)) return true;
+        return false;
+    }
+};
@@ -0,0 +1,106 @@
+// ====== Balance sweep ======
+// Plays every combination of a grid of EnvRules values (speeds, power-up and
+// round times, lives, target speed) with the greedy bot on headless copies of
+// one level, and streams win rate and score statistics per combination as it
+// finishes. Combinations are independent, so they go to the worker pool one
+// per task; each plays `rounds` rounds that differ in where the target
+// starts on its path.
+//
+// An axis is "name=lo:hi:count" (count evenly spaced values, ends included)
+// or "name=a,b,c". Unswept fields keep the base rules' values.
+
+#pragma once
+#include "BatchEnv.h"
+#include <math.h>
+#include <mutex>
+#include <string>
+
+const float SWEEP_CELL = 8;     // bot map cell (px)
+
+struct SweepAxis {
+    std::string name;
+    std::vector<float> values;
+};
+
+inline bool parseSweepAxis(const char* spec, SweepAxis& a) {
+    const char* eq = strchr(spec, '=');
+    EnvRules probe;
+    if (!eq) return false;
+    a.name.assign(spec, eq - spec);
+    a.values.clear();
+    if (!setRule(probe, a.name.c_str(), 0)) return false;
+    float lo, hi;
+    int count;
+    if (sscanf(eq + 1, "%f:%f:%d", &lo, &hi, &count) == 3) {
+        if (count < 1) return false;
+        for (int i = 0; i < count; i++) a.values.push_back(count == 1 ? lo : lo + (hi - lo) * i / (count - 1));
+        return true;
+    }
+    for (const char* p = eq + 1; *p;) {
+        char* end;
+        float v = strtof(p, &end);
+        if (end == p) return false;
+        a.values.push_back(v);
+        p = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',') return false;
+    }
+    return !a.values.empty();
+}
+
+struct SweepStats {
+    int rounds = 0, wins = 0;
+    double score = 0, scoreSq = 0, time = 0;   // sums over rounds
+};
+
+// `rounds` bot rounds of L under R, run to their ends
+inline SweepStats sweepPoint(const EnvLevel& L, const EnvBotMap& M, const EnvRules& R, int rounds) {
+    EnvBatch B;
+    B.resize(L, rounds);
+    for (int w = 0; w < rounds; w++) {
+        B.reset(L, w, R.maxLives);
+        B.targetT[w] = (w + 0.5f) / rounds;
+        B.targetDir[w] = (w & 1) ? -1.0f : 1.0f;
+    }
+    SweepStats s;
+    for (int w = 0; w < rounds; w++) {
+        bool won = playBotRound(L, M, R, B, w, 0, w);
+        s.rounds++;
+        s.wins += won;
+        s.score += B.score[w];
+        s.scoreSq += (double)B.score[w] * B.score[w];
+        s.time += std::min(B.time[w], R.roundTime);
+    }
+    return s;
+}
+
+// Writes a CSV header, then one line per combination in completion order;
+// returns the number of combinations
+inline long runSweep(const EnvLevel& L, const EnvRules& base, const std::vector<SweepAxis>& axes, int rounds, FILE* out) {
+    long total = 1;
+    for (const auto& a : axes) total *= (long)a.values.size();
+    for (const auto& a : axes) fprintf(out, "%s,", a.name.c_str());
+    fprintf(out, "rounds,win_rate,score_mean,score_std,time_mean\n");
+    fflush(out);
+    EnvBotMap M;
+    M.build(L, SWEEP_CELL);
+    std::mutex m;
+    parallelFor((int)total, 1, [&](int b, int e) {
+        for (int i = b; i < e; i++) {
+            EnvRules R = base;
+            std::vector<float> v(axes.size());
+            long rest = i;
+            for (size_t k = 0; k < axes.size(); k++) {
+                v[k] = axes[k].values[rest % axes[k].values.size()];
+                rest /= (long)axes[k].values.size();
+                setRule(R, axes[k].name.c_str(), v[k]);
+            }
+            SweepStats s = sweepPoint(L, M, R, rounds);
+            double mean = s.score / s.rounds, var = std::max(0.0, s.scoreSq / s.rounds - mean * mean);
+            std::lock_guard<std::mutex> lock(m);
+            for (size_t k = 0; k < axes.size(); k++) fprintf(out, "%g,", v[k]);
+            fprintf(out, "%d,%.4f,%.2f,%.2f,%.2f\n", s.rounds, (double)s.wins / s.rounds, mean, sqrt(var), s.time / s.rounds);
+            fflush(out);
+        }
+    });
+    return total;
+}
@@ -0,0 +1,146 @@
+// ====== Bit-packed tile layer ======
+// Solid/empty walls at 1 bit per tile, 64 tiles per word, each row padded to
+// whole words. A circle query turns every covered row into one column mask and
+// ANDs it against the row's words; drawing walks set-bit runs so a row of
+// touching tiles becomes a single quad.
+//
+// Compared with one Obj (16 bytes) per square obstacle this is 128x smaller,
+// and a query costs O(rows covered) word ops regardless of how many walls exist.
+
+#pragma once
+#include <stdint.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+inline int ctz64(uint64_t v) {   // v != 0
+#ifdef _MSC_VER
+    unsigned long i;
+    if (_BitScanForward(&i, (unsigned long)v)) return (int)i;
+    _BitScanForward(&i, (unsigned long)(v >> 32));
+    return 32 + (int)i;
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+inline int popcount64(uint64_t v) {
+    v = v - ((v >> 1) & 0x5555555555555555ull);
+    v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int)((v * 0x0101010101010101ull) >> 56);
+}
+
+// Bits lo..hi (inclusive, 0..63) set
+inline uint64_t bitRange(int lo, int hi) {
+    return (~0ull << lo) & (~0ull >> (63 - hi));
+}
+
+struct TileMap {
+    int cols = 0, rows = 0, stride = 0;   // stride: words per row
+    float x0 = 0, y0 = 0, size = 1;       // world position of tile (0,0), tile edge
+    std::vector<uint64_t> bits;
+
+    void resize(int c, int r, float tileSize, float ox, float oy) {
+        cols = c; rows = r; stride = (c + 63) >> 6;
+        size = tileSize; x0 = ox; y0 = oy;
+        bits.assign((size_t)stride * rows, 0);
+    }
+    void clear() { std::fill(bits.begin(), bits.end(), 0ull); }
+
+    const uint64_t* row(int r) const { return &bits[(size_t)r * stride]; }
+    bool get(int c, int r) const { return (row(r)[c >> 6] >> (c & 63)) & 1; }
+    void set(int c, int r, bool on) {
+        uint64_t& w = bits[(size_t)r * stride + (c >> 6)];
+        uint64_t m = 1ull << (c & 63);
+        w = on ? (w | m) : (w & ~m);
+    }
+
+    int colAt(float x) const { return (int)floorf((x - x0) / size); }
+    int rowAt(float y) const { return (int)floorf((y - y0) / size); }
+    bool inside(int c, int r) const { return c >= 0 && c < cols && r >= 0 && r < rows; }
+
+    int count() const {
+        int n = 0;
+        for (uint64_t w : bits) n += popcount64(w);
+        return n;
+    }
+    size_t bytes() const { return bits.size() * sizeof(uint64_t); }
+};
+
+// Any set tile in columns c0..c1 (inclusive) of row r
+inline bool tileRowAny(const TileMap& tm, int r, int c0, int c1) {
+    const uint64_t* w = tm.row(r);
+    int w0 = c0 >> 6, w1 = c1 >> 6;
+    if (w0 == w1) return (w[w0] & bitRange(c0 & 63, c1 & 63)) != 0;
+    if (w[w0] & bitRange(c0 & 63, 63)) return true;
+    for (int i = w0 + 1; i < w1; i++) if (w[i]) return true;
+    return (w[w1] & bitRange(0, c1 & 63)) != 0;
+}
+
+// Circle vs solid tiles. Per row the circle spans [cx-hw, cx+hw], hw taken at
+// the row's y closest to the center, which is exact for a band of squares.
+inline bool tileCircleHits(const TileMap& tm, float cx, float cy, float r) {
+    if (tm.rows == 0) return false;
+    int r0 = std::max(tm.rowAt(cy - r), 0), r1 = std::min(tm.rowAt(cy + r), tm.rows - 1);
+    for (int row = r0; row <= r1; row++) {
+        float by0 = tm.y0 + row * tm.size, by1 = by0 + tm.size;
+        float dy = cy < by0 ? by0 - cy : (cy > by1 ? cy - by1 : 0.0f);
+        float hw2 = r * r - dy * dy;
+        if (hw2 <= 0) continue;
+        float hw = sqrtf(hw2);
+        int c0 = std::max(tm.colAt(cx - hw), 0), c1 = std::min(tm.colAt(cx + hw), tm.cols - 1);
+        if (c0 <= c1 && tileRowAny(tm, row, c0, c1)) return true;
+    }
+    return false;
+}
+
+// Calls fn(c0, c1) for every run of set tiles [c0, c1) in row r
+template <class F>
+void tileForEachRun(const TileMap& tm, int r, F fn) {
+    const uint64_t* w = tm.row(r);
+    int start = -1;
+    for (int i = 0; i < tm.stride; i++) {
+        uint64_t v = w[i];
+        int pos = 0;
+        while (pos < 64) {
+            uint64_t m = (start < 0 ? v : ~v) >> pos;
+            if (!m) break;                       // no edge left in this word
+            pos += ctz64(m);
+            if (start < 0) start = i * 64 + pos;
+            else { fn(start, i * 64 + pos); start = -1; }
+        }
+    }
+    if (start >= 0) fn(start, tm.cols);
+}
+
+// Distance along o + t d to the first solid tile, or tMax if there is none
+// within it (DDA, one bit test per tile crossed). 0 when o is in a solid tile.
+inline float tileRayHit(const TileMap& tm, float ox, float oy, float dx, float dy, float tMax) {
+    if (tm.rows == 0) return tMax;
+    const float INF = 1e30f;
+    float t0 = 0, t1 = tMax, gx1 = tm.x0 + tm.cols * tm.size, gy1 = tm.y0 + tm.rows * tm.size;
+    if (dx != 0) { float a = (tm.x0 - ox) / dx, b = (gx1 - ox) / dx; t0 = std::max(t0, std::min(a, b)); t1 = std::min(t1, std::max(a, b)); }
+    else if (ox < tm.x0 || ox >= gx1) return tMax;
+    if (dy != 0) { float a = (tm.y0 - oy) / dy, b = (gy1 - oy) / dy; t0 = std::max(t0, std::min(a, b)); t1 = std::min(t1, std::max(a, b)); }
+    else if (oy < tm.y0 || oy >= gy1) return tMax;
+    if (t0 > t1) return tMax;
+
+    int c = std::max(0, std::min(tm.cols - 1, tm.colAt(ox + dx * t0)));
+    int r = std::max(0, std::min(tm.rows - 1, tm.rowAt(oy + dy * t0)));
+    int sc = dx > 0 ? 1 : -1, sr = dy > 0 ? 1 : -1;
+    float nextX = dx != 0 ? (tm.x0 + (c + (dx > 0)) * tm.size - ox) / dx : INF, stepX = dx != 0 ? tm.size / fabsf(dx) : INF;
+    float nextY = dy != 0 ? (tm.y0 + (r + (dy > 0)) * tm.size - oy) / dy : INF, stepY = dy != 0 ? tm.size / fabsf(dy) : INF;
+    float enter = t0;
+    for (;;) {
+        if (tm.get(c, r)) return enter;
+        enter = std::min(nextX, nextY);
+        if (enter >= t1) return tMax;
+        if (nextX < nextY) { c += sc; nextX += stepX; }
+        else { r += sr; nextY += stepY; }
+        if (c < 0 || c >= tm.cols || r < 0 || r >= tm.rows) return tMax;
+    }
+}
@@ -0,0 +1,110 @@
+// ====== 2D visibility (fog of war) ======
+// Visibility polygon around a viewer as a polar depth buffer: the circle is
+// cut into `bins` equal angles and each bin keeps the nearest distance at
+// which its center ray meets an edge (or the view radius). Every edge is
+// swept once over just the bins its angular span covers, so the cost is
+// edges x bins-per-edge with no sorting and no event queue; four bins per
+// SSE op. The polygon vertices are the bin rays cut at their distance.
+//
+// Edges are one-sided: shapes are CCW, and an edge whose outward side faces
+// away from the viewer is skipped (a closed shape's near side hides it).
+
+#pragma once
+#include "Math2D.h"
+#include <vector>
+#include <algorithm>
+
+// Slack on the edge parameter u, so a ray through a shared vertex cannot slip between two edges
+const float VIS_U_SLACK = 1e-5f;
+
+struct PolarVis {
+    int bins = 0;
+    float binW = 1, invBinW = 1;
+    float px = 0, py = 0, radius = 0;
+    std::vector<float> dist;          // bins (+3 pad)
+    std::vector<float> dirx, diry;    // bin center ray directions (+3 pad)
+    int edges = 0, edgeBins = 0;      // stats since begin()
+
+    void init(int n) {
+        bins = n; binW = TWO_PI_F / n; invBinW = n / TWO_PI_F;
+        dist.assign(n + 3, 0.0f);
+        dirx.resize(n + 3); diry.resize(n + 3);
+        for (int k = 0; k < n + 3; k++) fastSinCos((k % n + 0.5f) * binW, diry[k], dirx[k]);
+    }
+
+    void begin(float x, float y, float r) {
+        px = x; py = y; radius = r;
+        std::fill(dist.begin(), dist.end(), r);
+        edges = edgeBins = 0;
+    }
+
+    // Segment a -> b with the shape's inside on its left (CCW winding)
+    void addEdge(float ax, float ay, float bx, float by) {
+        ax -= px; ay -= py; bx -= px; by -= py;
+        float ex = bx - ax, ey = by - ay;
+        float cae = ax * ey - ay * ex;        // < 0: the outward side faces the viewer
+        if (cae >= 0) return;
+        // nearest point farther than the radius: cannot shorten any bin
+        float t = clampf(-(ax * ex + ay * ey) / (ex * ex + ey * ey), 0, 1);
+        float qx = ax + ex * t, qy = ay + ey * t;
+        if (qx * qx + qy * qy >= radius * radius) return;
+        edges++;
+
+        // b is clockwise of a; bins whose center lies in [angle(b), angle(a)],
+        // widened by one so fastAtan2 error cannot open a gap (u rejects extras)
+        float a1 = fastAtan2(by, bx), a0 = fastAtan2(ay, ax);
+        if (a0 < a1) a0 += TWO_PI_F;
+        int k0 = (int)floorf(a1 * invBinW - 0.5f), k1 = (int)floorf(a0 * invBinW - 0.5f) + 1;
+        int n = std::min(k1 - k0 + 1, bins);
+        k0 = (k0 % bins + bins) % bins;
+        edgeBins += n;
+        // contiguous runs (a span wrapping past 2pi is two)
+        int first = std::min(n, bins - k0);
+        sweep(k0, first, ax, ay, ex, ey, cae);
+        if (first < n) sweep(0, n - first, ax, ay, ex, ey, cae);
+    }
+
+    // Ray d meets a + u e at t = cross(a, e) / cross(d, e), u = cross(a, d) / cross(d, e)
+    void sweep(int k, int n, float ax, float ay, float ex, float ey, float cae) {
+        int i = k, end = k + n;
+#ifdef MATH2D_SSE
+        float4 vax = f4(ax), vay = f4(ay), vex = f4(ex), vey = f4(ey), vcae = f4(cae), zero = f4(0);
+        for (; i + 4 <= end; i += 4) {
+            float4 dx = load4(&dirx[i]), dy = load4(&diry[i]);
+            float4 den = dx * vey - dy * vex;          // < 0 when the ray crosses toward the edge
+            float4 cad = vax * dy - vay * dx;          // u * den; u in [0,1] <=> den <= cad <= 0
+            float4 hit = and4(lt4(den, zero), and4(le4(cad, den * f4(-VIS_U_SLACK)), le4(den * f4(1 + VIS_U_SLACK), cad)));
+            float4 t = vcae / select4(hit, den, f4(-1));
+            store4(&dist[i], select4(hit, min4(load4(&dist[i]), t), load4(&dist[i])));
+        }
+#endif
+        for (; i < end; i++) {
+            float den = dirx[i] * ey - diry[i] * ex, cad = ax * diry[i] - ay * dirx[i];
+            if (den < 0 && cad <= -den * VIS_U_SLACK && den * (1 + VIS_U_SLACK) <= cad) dist[i] = std::min(dist[i], cae / den);
+        }
+    }
+
+    int binAt(float dx, float dy) const {
+        int k = (int)floorf(fastAtan2(dy, dx) * invBinW);
+        return (k % bins + bins) % bins;
+    }
+
+    bool pointVisible(float x, float y) const {
+        float dx = x - px, dy = y - py, d = dist[binAt(dx, dy)];
+        return dx * dx + dy * dy < d * d;
+    }
+
+    // Any part of the circle possibly visible: some bin over its angular
+    // extent reaches past the circle's near side
+    bool visible(float x, float y, float r) const {
+        float dx = x - px, dy = y - py, d2 = dx * dx + dy * dy;
+        if (d2 <= r * r) return true;
+        float d = sqrtf(d2);
+        if (d - r >= radius) return false;
+        int half = std::min((int)(asinf(std::min(1.0f, r / d)) * invBinW) + 1, bins / 2);
+        int c = binAt(dx, dy);
+        for (int j = -half; j <= half; j++)
+            if (dist[(c + j + bins) % bins] > d - r) return true;
+        return false;
+    }
+};
@@ -0,0 +1,101 @@
+"""Batched headless worlds for training, over the C ABI in benv_capi.cpp.
+
+One BatchEnv holds n worlds of a level saved from the editor ('o' writes
+level.txt). The observation, reward, done and action arrays are NumPy views
+of buffers owned by the library: nothing is copied across the boundary, and
+one ctypes call steps every world with the GIL released.
+
+    env = BatchEnv("level.txt", worlds=1024)
+    obs = env.reset()                       # (1024, 84, 84) uint8
+    obs, rew, done = env.step(actions)      # actions: 1024 ints in 0..8
+
+Finished worlds restart inside step(); their done flag is set for that step
+and obs already shows the new round. The returned arrays are overwritten by
+the next call; copy them if they must outlive it.
+"""
+
+import ctypes
+import os
+import sys
+
+import numpy as np
+
+_HERE = os.path.dirname(os.path.abspath(__file__))
+
+
+def _load(path=None):
+    if path is None:
+        name = "benv.dll" if sys.platform == "win32" else "libbenv.so"
+        path = os.path.join(_HERE, name)
+    lib = ctypes.CDLL(path)
+    h = ctypes.c_void_p
+    u8p, f32p, i32p = ctypes.POINTER(ctypes.c_uint8), ctypes.POINTER(ctypes.c_float), ctypes.POINTER(ctypes.c_int)
+    sigs = {
+        "benv_create": (h, [ctypes.c_char_p, ctypes.c_int, ctypes.c_int, ctypes.c_int]),
+        "benv_create_procs": (h, [ctypes.c_char_p, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int]),
+        "benv_destroy": (None, [h]),
+        "benv_set_threads": (None, [ctypes.c_int]),
+        "benv_worlds": (ctypes.c_int, [h]),
+        "benv_obs_size": (ctypes.c_int, [h]),
+        "benv_actions": (u8p, [h]),
+        "benv_obs": (u8p, [h]),
+        "benv_rewards": (f32p, [h]),
+        "benv_dones": (u8p, [h]),
+        "benv_scores": (i32p, [h]),
+        "benv_reset": (ctypes.c_int, [h]),
+        "benv_step": (ctypes.c_int, [h]),
+    }
+    for name, (res, args) in sigs.items():
+        fn = getattr(lib, name)
+        fn.restype, fn.argtypes = res, args
+    return lib
+
+
+class BatchEnv:
+    ACTIONS = 9  # stay, E, NE, N, NW, W, SW, S, SE
+
+    def __init__(self, level_path, worlds, obs_size=84, repeat=4, threads=0, procs=0, lib_path=None):
+        """procs > 0 runs the worlds in that many worker processes (Linux)
+        instead of on threads of this one; the arrays are then shared memory.
+        threads > 0 resizes the thread pool every in-process handle shares;
+        0 leaves it as it is (one thread per core unless set before)."""
+        self._h = None
+        self._lib = _load(lib_path)
+        path = os.fsencode(level_path)
+        if procs > 0:
+            self._h = self._lib.benv_create_procs(path, worlds, obs_size, repeat, procs)
+        else:
+            if threads > 0:
+                self._lib.benv_set_threads(threads)
+            self._h = self._lib.benv_create(path, worlds, obs_size, repeat)
+        if not self._h:
+            raise ValueError("cannot create %d worlds from %r" % (worlds, level_path))
+        n, s = worlds, obs_size
+        view = np.ctypeslib.as_array
+        self.obs = view(self._lib.benv_obs(self._h), shape=(n, s, s))
+        self.rewards = view(self._lib.benv_rewards(self._h), shape=(n,))
+        self.dones = view(self._lib.benv_dones(self._h), shape=(n,)).view(np.bool_)
+        self.scores = view(self._lib.benv_scores(self._h), shape=(n,))
+        self._actions = view(self._lib.benv_actions(self._h), shape=(n,))
+        self.worlds = n
+
+    def reset(self):
+        if not self._lib.benv_reset(self._h):
+            raise RuntimeError("a worker process died")
+        return self.obs
+
+    def step(self, actions):
+        self._actions[:] = actions
+        if not self._lib.benv_step(self._h):
+            raise RuntimeError("a worker process died")
+        return self.obs, self.rewards, self.dones
+
+    def close(self):
+        if self._h:
+            # views die with the buffers
+            self.obs = self.rewards = self.dones = self.scores = self._actions = None
+            self._lib.benv_destroy(self._h)
+            self._h = None
+
+    def __del__(self):
+        self.close()
@@ -0,0 +1,45 @@
+"""Step latency and throughput: in-process threads vs worker processes.
+
+    python bench.py level.txt [worlds] [procs]
+
+Latency is the round trip of one step() on a batch of one world per worker,
+which is mostly synchronization; throughput steps the full batch with
+random actions.
+"""
+
+import sys
+import time
+
+import numpy as np
+
+from batchenv import BatchEnv
+
+
+def timed(env, steps, actions):
+    env.reset()
+    env.step(actions[0])
+    t = time.perf_counter()
+    for i in range(steps):
+        env.step(actions[i % len(actions)])
+    return (time.perf_counter() - t) / steps
+
+
+def main():
+    level = sys.argv[1]
+    worlds = int(sys.argv[2]) if len(sys.argv) > 2 else 1024
+    procs = int(sys.argv[3]) if len(sys.argv) > 3 else 4
+    rng = np.random.default_rng(0)
+
+    for name, kw in (("threads", {}), ("procs %d" % procs, {"procs": procs})):
+        env = BatchEnv(level, max(1, procs), obs_size=8, repeat=1, **kw)
+        lat = timed(env, 20000, np.zeros((1, env.worlds), np.uint8))
+        env.close()
+        env = BatchEnv(level, worlds, repeat=4, **kw)
+        acts = rng.integers(0, BatchEnv.ACTIONS, (64, worlds), dtype=np.uint8)
+        dt = timed(env, 100, acts)
+        env.close()
+        print("%-10s  round trip %7.2f us   %9.0f world-steps/s" % (name, lat * 1e6, worlds / dt))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,131 @@
+// ====== C ABI for batched headless worlds (Python bindings) ======
+// Wraps one EnvSet (BatchEnv.h) per handle. Build it as a shared library next
+// to batchenv.py:
+//   Windows (VS prompt):  cl /O2 /EHsc /LD benv_capi.cpp /Fe:benv.dll
+//   Linux / macOS:        g++ -O2 -msse2 -shared -fPIC -o libbenv.so benv_capi.cpp -lpthread
+//
+// The buffers belong to the handle and never move, so the wrapper views them
+// with NumPy once and every step is a single call with no arguments to
+// marshal. ctypes releases the GIL for the duration of each call.
+//
+// benv_create_procs spreads the worlds over worker processes instead
+// (env_procs.h, Linux only); its buffers are shared memory and the
+// accessors below work the same on either kind of handle.
+
+#include "../BatchEnv.h"
+#include <mutex>
+#ifdef __linux__
+#include "env_procs.h"
+#endif
+
+#ifdef _WIN32
+#define BENV_API extern "C" __declspec(dllexport)
+#else
+#define BENV_API extern "C" __attribute__((visibility("default")))
+#endif
+
+// The worker pool is one per process and WorkerPool::run is not re-entrant:
+// handles stepped from different Python threads take turns on it
+static std::mutex poolLock;
+
+struct Benv {
+    EnvSet* local = nullptr;
+#ifdef __linux__
+    EnvProcs* procs = nullptr;
+#endif
+    int n = 0, size = 0;
+    uint8_t* actions = nullptr;
+    uint8_t* obs = nullptr;
+    float* rewards = nullptr;
+    uint8_t* dones = nullptr;
+    int* scores = nullptr;
+};
+
+// Null if the level file cannot be read or the sizes are not positive
+BENV_API void* benv_create(const char* levelPath, int worlds, int obsSize, int repeat) {
+    if (worlds <= 0 || obsSize <= 0) return nullptr;
+    EnvSet* e = new EnvSet();
+    if (!levelPath || !loadLevel(e->level, levelPath)) { delete e; return nullptr; }
+    e->rules.repeat = std::max(1, repeat);
+    e->init(worlds, obsSize);
+    Benv* h = new Benv();
+    h->local = e;
+    h->n = worlds; h->size = obsSize;
+    h->actions = e->actions.data(); h->obs = e->obs.data(); h->rewards = e->rewards.data();
+    h->dones = e->batch.done.data(); h->scores = e->batch.score.data();
+    return h;
+}
+
+// Same, with the worlds split over `procs` forked workers; null where
+// unsupported or if the workers cannot be started
+BENV_API void* benv_create_procs(const char* levelPath, int worlds, int obsSize, int repeat, int procs) {
+#ifdef __linux__
+    if (worlds <= 0 || obsSize <= 0 || procs <= 0) return nullptr;
+    EnvLevel L;
+    if (!levelPath || !loadLevel(L, levelPath)) return nullptr;
+    L.finish();
+    EnvRules R;
+    R.repeat = std::max(1, repeat);
+    EnvProcs* p = new EnvProcs();
+    if (!p->start(L, R, worlds, obsSize, procs)) { delete p; return nullptr; }
+    Benv* h = new Benv();
+    h->procs = p;
+    h->n = worlds; h->size = obsSize;
+    h->actions = p->actions; h->obs = p->obs; h->rewards = p->rewards;
+    h->dones = p->dones; h->scores = p->scores;
+    return h;
+#else
+    (void)levelPath; (void)worlds; (void)obsSize; (void)repeat; (void)procs;
+    return nullptr;
+#endif
+}
+
+BENV_API void benv_destroy(void* h) {
+    Benv* b = (Benv*)h;
+    delete b->local;
+#ifdef __linux__
+    delete b->procs;
+#endif
+    delete b;
+}
+
+// Worker threads shared by every in-process handle, caller included; 0 = one
+// per core. The pool is only rebuilt when the count changes, and never while
+// a handle is stepping
+BENV_API void benv_set_threads(int n) {
+    if (n <= 0) n = (int)std::max(1u, std::thread::hardware_concurrency());
+    std::lock_guard<std::mutex> lk(poolLock);
+    if (n != workers().size()) workers().setThreads(n);
+}
+
+BENV_API int benv_worlds(void* h) { return ((Benv*)h)->n; }
+BENV_API int benv_obs_size(void* h) { return ((Benv*)h)->size; }
+
+// worlds bytes, 0..8 (see ENV_ACTION_DX)
+BENV_API uint8_t* benv_actions(void* h) { return ((Benv*)h)->actions; }
+// worlds x size x size bytes, row 0 at the top
+BENV_API uint8_t* benv_obs(void* h) { return ((Benv*)h)->obs; }
+BENV_API float* benv_rewards(void* h) { return ((Benv*)h)->rewards; }
+BENV_API uint8_t* benv_dones(void* h) { return ((Benv*)h)->dones; }
+BENV_API int* benv_scores(void* h) { return ((Benv*)h)->scores; }
+
+// 0 once a worker process has died; the handle can then only be destroyed
+BENV_API int benv_reset(void* h) {
+    Benv* b = (Benv*)h;
+#ifdef __linux__
+    if (b->procs) return b->procs->resetAll();
+#endif
+    std::lock_guard<std::mutex> lk(poolLock);
+    b->local->resetAll();
+    return 1;
+}
+
+BENV_API int benv_step(void* h) {
+    Benv* b = (Benv*)h;
+#ifdef __linux__
+    if (b->procs) return b->procs->stepAll();
+#endif
+    std::lock_guard<std::mutex> lk(poolLock);
+    b->local->stepAll();
+    return 1;
+}
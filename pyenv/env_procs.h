@@ -0,0 +1,183 @@
+// ====== Multi-process world workers (Linux) ======
+// Splits a batch of worlds across forked worker processes, for trainers that
+// want a crashing or leaking simulation isolated from themselves. Actions,
+// observations, rewards, dones and scores live in one shared mapping laid out
+// like EnvSet's buffers; each worker steps its own slice of worlds straight
+// into it, so nothing is serialized or copied between processes.
+//
+// Commands travel through two futex words on separate cache lines: the
+// trainer bumps `seq` and wakes everyone, and each worker decrements
+// `pending` when its slice is done; the last one wakes the trainer. Steps are
+// lockstep, so one command slot is all the ring ever holds. On multi-core
+// machines both sides spin briefly before sleeping, since a step usually
+// finishes in microseconds.
+
+#pragma once
+#include "../BatchEnv.h"
+#include <atomic>
+#include <climits>
+#include <errno.h>
+#include <thread>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <linux/futex.h>
+#include <time.h>
+#include <unistd.h>
+
+enum EnvOp : uint32_t { ENV_OP_RESET, ENV_OP_STEP, ENV_OP_QUIT };
+
+const int ENV_SPIN = 2000;                  // polls before sleeping on the futex (multi-core only)
+const long ENV_WAIT_NS = 50 * 1000 * 1000;  // trainer re-checks its workers this often
+
+// Not FUTEX_PRIVATE: the words are shared between processes
+inline void futexWait(std::atomic<uint32_t>& a, uint32_t v, long ns) {
+    timespec ts = { 0, ns };
+    syscall(SYS_futex, (uint32_t*)&a, FUTEX_WAIT, v, ns ? &ts : nullptr, nullptr, 0);
+}
+
+inline void futexWake(std::atomic<uint32_t>& a, int n) {
+    syscall(SYS_futex, (uint32_t*)&a, FUTEX_WAKE, n, nullptr, nullptr, 0);
+}
+
+// Spins, then sleeps until `a` differs from v (or the timeout passes)
+inline uint32_t awaitChange(std::atomic<uint32_t>& a, uint32_t v, long ns) {
+    // With one core the other side cannot run while we spin
+    static const int spin = std::thread::hardware_concurrency() > 1 ? ENV_SPIN : 0;
+    for (int i = 0; i < spin; i++) {
+        uint32_t x = a.load(std::memory_order_acquire);
+        if (x != v) return x;
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+    futexWait(a, v, ns);
+    return a.load(std::memory_order_acquire);
+}
+
+struct EnvShared {
+    alignas(64) std::atomic<uint32_t> seq;       // bumped by the trainer per command
+    uint32_t op;
+    alignas(64) std::atomic<uint32_t> pending;   // workers still busy with it
+};
+
+struct EnvProcs {
+    EnvShared* sh = nullptr;
+    size_t bytes = 0;
+    uint8_t* actions = nullptr;
+    uint8_t* dones = nullptr;
+    int* scores = nullptr;
+    float* rewards = nullptr;
+    uint8_t* obs = nullptr;
+    int n = 0, size = 0;
+    bool broken = false;
+    std::vector<pid_t> pids;
+    std::vector<uint8_t> gone;      // reaped behind our back: the pid may be reused, never signal it
+
+    static size_t up64(size_t x) { return (x + 63) & ~(size_t)63; }
+
+    // Forks `procs` workers, each building its own EnvSet for its slice of L
+    bool start(const EnvLevel& L, const EnvRules& R, int worlds, int obsSize, int procs) {
+        procs = std::max(1, std::min(procs, worlds));
+        n = worlds; size = obsSize;
+        size_t pix = (size_t)obsSize * obsSize;
+        size_t oAct = up64(sizeof(EnvShared)), oDone = oAct + up64(n), oScore = oDone + up64(n);
+        size_t oRew = oScore + up64(n * sizeof(int)), oObs = oRew + up64(n * sizeof(float));
+        bytes = oObs + n * pix;
+        void* m = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (m == MAP_FAILED) { sh = nullptr; return false; }
+        sh = new (m) EnvShared();
+        uint8_t* base = (uint8_t*)m;
+        actions = base + oAct; dones = base + oDone;
+        scores = (int*)(base + oScore); rewards = (float*)(base + oRew); obs = base + oObs;
+
+        pid_t parent = getpid();
+        for (int k = 0; k < procs; k++) {
+            pid_t pid = fork();
+            if (pid < 0) { stop(); return false; }
+            if (pid == 0) workerMain(L, R, k * n / procs, (k + 1) * n / procs, parent);
+            pids.push_back(pid);
+            gone.push_back(0);
+        }
+        return true;
+    }
+
+    // Returns false once any worker has died; the batch is unusable after that
+    bool run(EnvOp op) {
+        if (broken || !sh) return false;
+        sh->op = op;
+        sh->pending.store((uint32_t)pids.size(), std::memory_order_relaxed);
+        sh->seq.fetch_add(1, std::memory_order_release);
+        futexWake(sh->seq, INT_MAX);
+        uint32_t p;
+        while ((p = sh->pending.load(std::memory_order_acquire)) != 0) {
+            if (awaitChange(sh->pending, p, ENV_WAIT_NS) == p && !alive()) { broken = true; return false; }
+        }
+        return true;
+    }
+
+    bool resetAll() { return run(ENV_OP_RESET); }
+    bool stepAll() { return run(ENV_OP_STEP); }
+
+    // Looks without reaping (WNOWAIT): a dead worker stays a zombie, so its pid
+    // cannot be reused before stop() waits for it. ECHILD means the host
+    // ignores SIGCHLD and the kernel already reaped it
+    bool alive() {
+        for (size_t k = 0; k < pids.size(); k++) {
+            if (gone[k]) return false;
+            siginfo_t si;
+            si.si_pid = 0;
+            int r;
+            do r = waitid(P_PID, (id_t)pids[k], &si, WEXITED | WNOHANG | WNOWAIT); while (r < 0 && errno == EINTR);
+            if (r < 0) { gone[k] = 1; return false; }
+            if (si.si_pid != 0) return false;
+        }
+        return true;
+    }
+
+    void stop() {
+        if (!sh) return;
+        if (!broken && !pids.empty()) {
+            sh->op = ENV_OP_QUIT;
+            sh->seq.fetch_add(1, std::memory_order_release);
+            futexWake(sh->seq, INT_MAX);
+        }
+        else for (size_t k = 0; k < pids.size(); k++) if (!gone[k]) kill(pids[k], SIGKILL);
+        for (size_t k = 0; k < pids.size(); k++)
+            while (!gone[k] && waitpid(pids[k], nullptr, 0) < 0 && errno == EINTR) {}
+        pids.clear();
+        gone.clear();
+        munmap(sh, bytes);
+        sh = nullptr;
+    }
+
+    ~EnvProcs() { stop(); }
+
+private:
+    // Never returns. Worlds [b, e) of the batch are worlds [0, e - b) here
+    [[noreturn]] void workerMain(const EnvLevel& L, const EnvRules& R, int b, int e, pid_t parent) {
+        prctl(PR_SET_PDEATHSIG, SIGKILL);
+        if (getppid() != parent) _exit(1);
+        EnvSet env;
+        env.level = L;
+        env.rules = R;
+        env.init(e - b, size);
+        size_t pix = (size_t)size * size;
+        uint8_t* out = obs + b * pix;
+        uint32_t seen = 0;
+        for (;;) {
+            uint32_t s;
+            while ((s = sh->seq.load(std::memory_order_acquire)) == seen) awaitChange(sh->seq, seen, 0);
+            seen = s;
+            // Serial on purpose: the parent's thread pool does not survive fork
+            if (sh->op == ENV_OP_QUIT) _exit(0);
+            if (sh->op == ENV_OP_RESET) env.resetRange(0, e - b, rewards + b, out);
+            else env.stepRange(0, e - b, actions + b, rewards + b, out);
+            std::copy(env.batch.done.begin(), env.batch.done.end(), dones + b);
+            std::copy(env.batch.score.begin(), env.batch.score.end(), scores + b);
+            if (sh->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) futexWake(sh->pending, 1);
+        }
+    }
+};